@@ -0,0 +1,836 @@
+#include <algorithm>
+#include <bitset>
+#include <iomanip>
+#include <random>
+#include "Utils/Array.h"
+#include "Utils/Base64.h"
+#include "Utils/Char.h"
+#include "Utils/Columns.h"
+#include "Utils/Console.h"
+#include "Utils/Cpu.h"
+#include "Utils/FileSystem.h"
+#include "Utils/HexCodec.h"
+#include "Utils/MultiMatcher.h"
+#include "Utils/NumberParse.h"
+#include "Utils/String.h"
+#include "Utils/StringBuilder.h"
+#include "Utils/StringTable.h"
+#include "Utils/SymbolStream.h"
+#include "Utils/Timer.h"
+#include "gtest/gtest.h"
+
+using namespace Rt2;
+
+// These are coarse timings that are printed for comparison.
+// They only assert that the variants compute the same result.
+
+namespace
+{
+    constexpr U32 BenchRows   = 0x40000;
+    constexpr U32 BenchRounds = 16;
+
+    struct Body
+    {
+        float x, y, z;
+        float vx, vy, vz;
+        float mass;
+        U32   flags;
+        U64   id;
+        U64   owner;
+    };
+
+    void report(const char* name, const U64 us)
+    {
+        Console::writeLine(Su::join(name, ": ", us, "us"));
+    }
+
+    void reportRate(const char* name, const U64 us, const size_t bytes)
+    {
+        const double mbs = double(bytes) / double(Max<U64>(us, 1));
+        Console::writeLine(Su::join(name, ": ", us, "us, ", U64(mbs), " MB/s"));
+    }
+
+    template <typename T>
+    Array<T, AOP_SIMPLE_TYPE> randomValues(const U32 count, const U64 seed)
+    {
+        std::mt19937_64 rng(seed);
+
+        Array<T, AOP_SIMPLE_TYPE> values;
+        values.reserve(count);
+        for (U32 i = 0; i < count; ++i)
+        {
+            if constexpr (std::is_floating_point_v<T>)
+                values.push_back(T(I64(rng() % 2000000) - 1000000) / T(997));
+            else
+                values.push_back(T(rng() >> (rng() % 64)));
+        }
+        return values;
+    }
+
+}  // namespace
+
+GTEST_TEST(Benchmark, Columns_001)
+{
+    Array<Body, AOP_SIMPLE_TYPE> rows;
+
+    Columns<float, float, float, float, float, float, float, U32, U64, U64> cols;
+
+    rows.reserve(BenchRows);
+    cols.reserve(BenchRows);
+    for (U32 i = 0; i < BenchRows; ++i)
+    {
+        const float f = float(i % 1000) * 0.001f;
+
+        rows.push_back({f, f, f, f, f, f, 1.f + f, i, i, i});
+        cols.push_back(f, f, f, f, f, f, 1.f + f, i, i, i);
+    }
+
+    constexpr float dt = 1.f / 60.f;
+
+    Timer timer;
+    timer.reset();
+    for (U32 r = 0; r < BenchRounds; ++r)
+    {
+        for (Body& b : rows)
+            b.x += b.vx * dt;
+    }
+    report("Array<Struct> x += vx * dt", timer.getMicroseconds());
+
+    timer.reset();
+    for (U32 r = 0; r < BenchRounds; ++r)
+    {
+        float*       x  = cols.column<0>().data();
+        const float* vx = cols.column<3>().data();
+        const U32    n  = cols.size();
+        for (U32 i = 0; i < n; ++i)
+            x[i] += vx[i] * dt;
+    }
+    report("Columns x += vx * dt", timer.getMicroseconds());
+
+    U32 mismatched = 0;
+    for (U32 i = 0; i < BenchRows; ++i)
+        mismatched += rows[i].x != cols.at<0>(i);
+    EXPECT_EQ(mismatched, 0);
+}
+
+GTEST_TEST(Benchmark, NumberFormat_001)
+{
+    constexpr U32 count = 0x20000;
+
+    std::mt19937_64 rng(7);
+
+    Array<I64, AOP_SIMPLE_TYPE>    ints;
+    Array<double, AOP_SIMPLE_TYPE> reals;
+    ints.reserve(count);
+    reals.reserve(count);
+    for (U32 i = 0; i < count; ++i)
+    {
+        ints.push_back(I64(rng() >> (rng() % 64)));
+        reals.push_back(double(I64(rng() % 2000000) - 1000000) / 997.0);
+    }
+
+    Timer  timer;
+    String scratch;
+
+    // Formatting into a String first costs a copy per number.
+    StringBuilder a;
+    timer.reset();
+    for (const I64 v : ints)
+    {
+        Char::toString(scratch, v);
+        a.write(scratch);
+    }
+    report("Char::toString integers", timer.getMicroseconds());
+
+    StringBuilder b;
+    timer.reset();
+    for (const I64 v : ints)
+        b.write(v);
+    report("StringBuilder integers", timer.getMicroseconds());
+    EXPECT_EQ(a.toString(), b.toString());
+
+    a.clear();
+    timer.reset();
+    for (const double v : reals)
+    {
+        Char::toString(scratch, v, true);
+        a.write(scratch);
+    }
+    report("Char::toString reals", timer.getMicroseconds());
+
+    b.clear();
+    timer.reset();
+    for (const double v : reals)
+        b.write(v);
+    report("StringBuilder reals", timer.getMicroseconds());
+    EXPECT_EQ(a.toString(), b.toString());
+}
+
+GTEST_TEST(Benchmark, Conversion_001)
+{
+    constexpr U32 count = 0x20000;
+
+    const auto ints  = randomValues<I64>(count, 21);
+    const auto words = randomValues<U32>(count, 22);
+
+    Timer  timer;
+    size_t a = 0, b = 0;
+
+    // what Char::toString did before: a stream per number
+    timer.reset();
+    for (const I64 v : ints)
+    {
+        OutputStringStream oss;
+        oss << v;
+        a += oss.str().size();
+    }
+    report("stream I64", timer.getMicroseconds());
+
+    char buf[32];
+    timer.reset();
+    for (const I64 v : ints)
+        b += Char::format(buf, sizeof buf, v);
+    report("Char::format I64", timer.getMicroseconds());
+    EXPECT_EQ(a, b);
+
+    a = b = 0;
+    timer.reset();
+    for (const U32 v : words)
+    {
+        OutputStringStream oss;
+        oss << v;
+        a += oss.str().size();
+    }
+    report("stream U32", timer.getMicroseconds());
+
+    timer.reset();
+    for (const U32 v : words)
+        b += Char::format(buf, sizeof buf, v);
+    report("Char::format U32", timer.getMicroseconds());
+    EXPECT_EQ(a, b);
+
+    String scratch;
+    a = b = 0;
+    timer.reset();
+    for (const I64 v : ints)
+    {
+        Char::commaInt(scratch, size_t(v));
+        a += scratch.size();
+    }
+    report("Char::commaInt", timer.getMicroseconds());
+
+    timer.reset();
+    for (const I64 v : ints)
+        b += Char::formatComma(buf, sizeof buf, size_t(v));
+    report("Char::formatComma", timer.getMicroseconds());
+    EXPECT_EQ(a, b);
+}
+
+GTEST_TEST(Benchmark, Conversion_002)
+{
+    constexpr U32 count = 0x20000;
+
+    const auto reals = randomValues<double>(count, 23);
+
+    Timer  timer;
+    size_t mismatched = 0;
+
+    // a stream needs 17 digits to round trip every value
+    Array<String> old;
+    old.reserve(count);
+    timer.reset();
+    for (const double v : reals)
+    {
+        OutputStringStream oss;
+        oss << std::setprecision(17) << v;
+        old.push_back(oss.str());
+    }
+    report("stream double", timer.getMicroseconds());
+
+    char          buf[32];
+    const double* value = reals.begin();
+    timer.reset();
+    for (const String& str : old)
+    {
+        const size_t len = Char::format(buf, sizeof buf, *value++);
+        mismatched += len > str.size();
+    }
+    report("Char::format double", timer.getMicroseconds());
+    EXPECT_EQ(mismatched, 0);
+
+    timer.reset();
+    for (const double v : reals)
+    {
+        OutputStringStream oss;
+        oss << std::setprecision(9) << float(v);
+        mismatched += oss.str().empty();
+    }
+    report("stream float", timer.getMicroseconds());
+
+    timer.reset();
+    for (const double v : reals)
+        mismatched += Char::format(buf, sizeof buf, float(v)) == 0;
+    report("Char::format float", timer.getMicroseconds());
+    EXPECT_EQ(mismatched, 0);
+}
+
+GTEST_TEST(Benchmark, Conversion_003)
+{
+    constexpr U32 count = 0x20000;
+
+    const auto words = randomValues<U64>(count, 24);
+
+    Timer  timer;
+    size_t a = 0, b = 0;
+
+    timer.reset();
+    for (const U64 v : words)
+    {
+        OutputStringStream oss;
+        oss << std::setfill('0') << std::setw(16) << std::uppercase << std::hex << v;
+        a += oss.str().size();
+    }
+    report("stream hex", timer.getMicroseconds());
+
+    char buf[64];
+    timer.reset();
+    for (const U64 v : words)
+        b += Char::formatHex(buf, sizeof buf, v);
+    report("Char::formatHex", timer.getMicroseconds());
+    EXPECT_EQ(a, b);
+
+    a = b = 0;
+    timer.reset();
+    for (const U64 v : words)
+        a += std::bitset<64>(v).to_string().size();
+    report("bitset binary", timer.getMicroseconds());
+
+    timer.reset();
+    for (const U64 v : words)
+        b += Char::formatBinary(buf, sizeof buf, v);
+    report("Char::formatBinary", timer.getMicroseconds());
+    EXPECT_EQ(a, b);
+}
+
+GTEST_TEST(Benchmark, Base64_001)
+{
+    constexpr size_t size = 0x1000000;
+
+    String blob(size, 0);
+    std::mt19937_64 rng(47);
+    for (char& ch : blob)
+        ch = (char)rng();
+
+    Timer  timer;
+    String encoded, decoded;
+
+    const SimdLevel detected = Cpu::detected();
+    for (int level = SIMD_SCALAR; level <= detected; ++level)
+    {
+        if (level == SIMD_SSE2)
+            continue;
+        Cpu::setLevel((SimdLevel)level);
+
+        const String name = level == SIMD_SCALAR ? "scalar" : level == SIMD_SSE42 ? "ssse3" : "avx2";
+
+        encoded.clear();
+        timer.reset();
+        Base64::encode(encoded, blob);
+        reportRate(Su::join("Base64 encode ", name).c_str(), timer.getMicroseconds(), blob.size());
+
+        decoded.clear();
+        timer.reset();
+        EXPECT_TRUE(Base64::decode(decoded, encoded));
+        reportRate(Su::join("Base64 decode ", name).c_str(), timer.getMicroseconds(), encoded.size());
+        EXPECT_EQ(decoded, blob);
+    }
+    Cpu::setLevel(SIMD_AVX2);
+}
+
+GTEST_TEST(Benchmark, HexCodec_001)
+{
+    constexpr size_t size = 0x400000;
+
+    String blob(size, 0);
+    std::mt19937_64 rng(53);
+    for (char& ch : blob)
+        ch = (char)rng();
+
+    Timer  timer;
+    String a, b;
+
+    // one byte at a time, which is what toHexString did before
+    timer.reset();
+    a.resize(size << 1);
+    for (size_t i = 0; i < size; ++i)
+        Char::formatHex(&a[i << 1], 2, (uint8_t)blob[i]);
+    reportRate("Char::formatHex per byte", timer.getMicroseconds(), size);
+
+    const SimdLevel detected = Cpu::detected();
+
+    Cpu::setLevel(SIMD_SCALAR);
+    timer.reset();
+    Char::toHexString(b, blob.data(), blob.size());
+    reportRate("HexCodec::encode scalar", timer.getMicroseconds(), size);
+    EXPECT_EQ(a, b);
+
+    Cpu::setLevel(detected);
+    timer.reset();
+    Char::toHexString(b, blob.data(), blob.size());
+    reportRate("HexCodec::encode simd", timer.getMicroseconds(), size);
+    EXPECT_EQ(a, b);
+
+    String decoded;
+    timer.reset();
+    EXPECT_TRUE(HexCodec::decode(decoded, b));
+    reportRate("HexCodec::decode simd", timer.getMicroseconds(), b.size());
+    EXPECT_EQ(decoded, blob);
+
+    OutputStringStream oss;
+    timer.reset();
+    Console::hexdump(oss, blob.data(), (uint32_t)blob.size());
+    reportRate("Console::hexdump", timer.getMicroseconds(), size);
+    EXPECT_EQ(oss.str().size(), HexCodec::dumpSize(size));
+    Cpu::setLevel(SIMD_AVX2);
+}
+
+GTEST_TEST(Benchmark, SymbolStream_001)
+{
+    const auto values = randomValues<U64>(BenchRows, 59);
+
+    Timer  timer;
+    String a, b;
+    size_t x = 0, y = 0;
+
+    timer.reset();
+    for (const U64 v : values)
+        x += std::to_string(v).size();
+    report("std::to_string", timer.getMicroseconds());
+
+    timer.reset();
+    for (const U64 v : values)
+        y += SymbolStream::toString(v, SymbolStream::Base10).size();
+    report("SymbolStream::toString base 10", timer.getMicroseconds());
+    EXPECT_EQ(x, y);
+
+    std::mt19937_64 rng(61);
+
+    String text(0x400000, 0);
+    for (char& ch : text)
+        ch = (char)(' ' + rng() % 95);
+
+    SymbolStream hex(SymbolStream::Hex);
+    timer.reset();
+    hex.base(a, text);
+    reportRate("SymbolStream::base hex per byte", timer.getMicroseconds(), text.size());
+    EXPECT_EQ(a.size(), text.size() * 2);
+
+    // The same number one decimal digit per pass over the limbs.
+    String bytes(0x2000, 0);
+    for (char& ch : bytes)
+        ch = (char)rng();
+    bytes[0] |= 0x80;
+
+    timer.reset();
+    SimpleArray<U32> limbs;
+    for (size_t i = 0; i < bytes.size(); i += 4)
+    {
+        limbs.push_back(U32(U8(bytes[i])) << 24 | U32(U8(bytes[i + 1])) << 16 |
+                        U32(U8(bytes[i + 2])) << 8 | U8(bytes[i + 3]));
+    }
+
+    U32 first = 0;
+    a.clear();
+    while (first < limbs.size())
+    {
+        U64 r = 0;
+        for (U32 i = first; i < limbs.size(); ++i)
+        {
+            const U64 cur = r << 32 | limbs[i];
+
+            limbs[i] = U32(cur / 10);
+            r        = cur % 10;
+        }
+        a.push_back(char('0' + r));
+        while (first < limbs.size() && limbs[first] == 0)
+            ++first;
+    }
+    std::reverse(a.begin(), a.end());
+    report("digit per division 8KB", timer.getMicroseconds());
+
+    SymbolStream dec(SymbolStream::Base10);
+    timer.reset();
+    dec.number(b, bytes);
+    report("SymbolStream::number 8KB", timer.getMicroseconds());
+    EXPECT_EQ(a, b);
+
+    bytes.resize(0x10000);
+    for (char& ch : bytes)
+        ch = (char)rng();
+
+    timer.reset();
+    dec.number(b, bytes);
+    report("SymbolStream::number 64KB", timer.getMicroseconds());
+}
+
+GTEST_TEST(Benchmark, Concat_001)
+{
+    constexpr int count = 200000;
+
+    const String root = "/home/someone/";
+    const String dir  = "Projects/Module.Utils/";
+    const String stem = "String";
+    const String ext  = ".cpp";
+
+    Timer  timer;
+    size_t a = 0, b = 0;
+
+    timer.reset();
+    for (int i = 0; i < count; ++i)
+    {
+        OutputStringStream oss;
+        oss << root << dir << stem << i << ext;
+        a += oss.str().size();
+    }
+    report("OutputStringStream", timer.getMicroseconds());
+
+    timer.reset();
+    for (int i = 0; i < count; ++i)
+        b += Su::concat(root, dir, stem, i, ext).size();
+    report("Su::concat", timer.getMicroseconds());
+    EXPECT_EQ(a, b);
+
+    String reuse;
+    b = 0;
+    timer.reset();
+    for (int i = 0; i < count; ++i)
+    {
+        reuse.clear();
+        b += Su::appendTo(reuse, root, dir, stem, i, ext).size();
+    }
+    report("Su::appendTo", timer.getMicroseconds());
+    EXPECT_EQ(a, b);
+}
+
+GTEST_TEST(Benchmark, StringTable_001)
+{
+    // 500,000 fields that are too long for the small string buffer
+    String text;
+    for (int i = 0; i < 500000; ++i)
+        Su::appendTo(text, "a field that does not fit inline ", i, ',');
+
+    Timer timer;
+
+    StringArray array;
+    timer.reset();
+    Su::split(array, text, ',');
+    report("StringArray split", timer.getMicroseconds());
+
+    timer.reset();
+    std::sort(array.begin(), array.end());
+    report("StringArray sort", timer.getMicroseconds());
+
+    StringTable table;
+    timer.reset();
+    Su::split(table, text, ',');
+    report("StringTable split", timer.getMicroseconds());
+
+    timer.reset();
+    table.sort();
+    report("StringTable sort", timer.getMicroseconds());
+
+    ASSERT_EQ(array.size(), table.size());
+    for (U32 i = 0; i < table.size(); ++i)
+        EXPECT_EQ(array[i], table[i]);
+}
+
+GTEST_TEST(Benchmark, StringScan_001)
+{
+    // About 4MB of short csv records with padded fields.
+    String text;
+    text.reserve(0x400000);
+
+    std::mt19937_64 rng(31);
+    while (text.size() < 0x400000)
+    {
+        text.append("  record ");
+        text.append(Char::toString(U32(rng() % 100000)));
+        text.append(" ,\tvalue,  ");
+        text.append(rng() % 8 == 0 ? "x\x01y" : "xy");
+        text.append("  \r\n");
+    }
+
+    const auto run = [&text](const char* level)
+    {
+        Timer timer;
+
+        StringArray pieces;
+        timer.reset();
+        Su::split(pieces, text, "\r\n");
+        report(Su::join(level, " split").c_str(), timer.getMicroseconds());
+
+        String replaced;
+        timer.reset();
+        Su::replaceAll(replaced, text, "value", "VALUE");
+        report(Su::join(level, " replaceAll same length").c_str(), timer.getMicroseconds());
+
+        timer.reset();
+        Su::replaceAll(replaced, text, "value", "v");
+        report(Su::join(level, " replaceAll").c_str(), timer.getMicroseconds());
+
+        String trimmed;
+        timer.reset();
+        for (const String& piece : pieces)
+            Su::trimWs(trimmed, piece);
+        report(Su::join(level, " trimWs").c_str(), timer.getMicroseconds());
+
+        timer.reset();
+        const String stripped = Su::stripEol(text, ';');
+        report(Su::join(level, " stripEol").c_str(), timer.getMicroseconds());
+
+        return Su::join(pieces.size(), replaced.size(), stripped);
+    };
+
+    const SimdLevel detected = Cpu::detected();
+
+    Cpu::setLevel(SIMD_SCALAR);
+    const String a = run("scalar");
+    Cpu::setLevel(detected);
+    const String b = run("simd");
+    Cpu::setLevel(SIMD_AVX2);
+
+    EXPECT_EQ(a, b);
+}
+
+GTEST_TEST(Benchmark, MultiMatcher_001)
+{
+    // Windows style paths with the odd doubled separator, about 4MB.
+    String text;
+    text.reserve(0x400000);
+
+    std::mt19937_64 rng(43);
+    while (text.size() < 0x400000)
+    {
+        text.append("C:\\Users\\someone\\Projects\\Module.Utils\\Utils\\String.cpp");
+        text.append(rng() % 4 == 0 ? "\\\\" : "/");
+    }
+
+    Timer  timer;
+    String a, b;
+
+    timer.reset();
+    {
+        String n1;
+        Su::replaceAll(n1, text, "\\", "/");
+        Su::replaceAll(a, n1, "//", "/");
+    }
+    report("Su::replaceAll chained", timer.getMicroseconds());
+
+    timer.reset();
+    b = FileSystem::sanitize(text);
+    report("FileSystem::sanitize", timer.getMicroseconds());
+    EXPECT_EQ(a, b);
+
+    const MultiMatcher escapes = {
+        {"&", "&amp;"},
+        {"<", "&lt;"},
+        {">", "&gt;"},
+        {"\"", "&quot;"},
+        {"'", "&apos;"},
+    };
+
+    text.clear();
+    while (text.size() < 0x400000)
+        text.append("<a href=\"x\">Tom & Jerry's</a> plain text in between ");
+
+    timer.reset();
+    a = text;
+    Su::replaceAll(a, a, "&", "&amp;");
+    Su::replaceAll(a, a, "<", "&lt;");
+    Su::replaceAll(a, a, ">", "&gt;");
+    Su::replaceAll(a, a, "\"", "&quot;");
+    Su::replaceAll(a, a, "'", "&apos;");
+    report("Su::replaceAll x5", timer.getMicroseconds());
+
+    timer.reset();
+    escapes.replaceAll(b, text);
+    report("MultiMatcher::replaceAll", timer.getMicroseconds());
+    EXPECT_EQ(a, b);
+}
+
+GTEST_TEST(Benchmark, Filter_001)
+{
+    // Mostly clean text with the odd control byte, about 4MB.
+    String text;
+    text.reserve(0x400000);
+
+    std::mt19937_64 rng(41);
+    while (text.size() < 0x400000)
+    {
+        text.append("The Quick Brown Fox 0123456789 jumps over the lazy dog. ");
+        if (rng() % 4 == 0)
+            text.push_back(char(rng() % 32));
+    }
+
+    Timer  timer;
+    String a, b;
+
+    // the std::function path that filterAscii used before
+    timer.reset();
+    Su::filter(a, text, FilterFunction(isPrintableAscii), text.size());
+    report("Su::filter std::function", timer.getMicroseconds());
+
+    const SimdLevel detected = Cpu::detected();
+
+    Cpu::setLevel(SIMD_SCALAR);
+    timer.reset();
+    Su::filterAscii(b, text, text.size());
+    report("Su::filterAscii scalar", timer.getMicroseconds());
+    EXPECT_EQ(a, b);
+
+    Cpu::setLevel(detected);
+    timer.reset();
+    Su::filterAscii(b, text, text.size());
+    report("Su::filterAscii simd", timer.getMicroseconds());
+    EXPECT_EQ(a, b);
+
+    Cpu::setLevel(SIMD_SCALAR);
+    timer.reset();
+    Su::toUpper(a, text);
+    report("Su::toUpper scalar", timer.getMicroseconds());
+
+    Cpu::setLevel(detected);
+    timer.reset();
+    Su::toUpper(b, text);
+    report("Su::toUpper simd", timer.getMicroseconds());
+    EXPECT_EQ(a, b);
+    Cpu::setLevel(SIMD_AVX2);
+}
+
+GTEST_TEST(Benchmark, SplitView_001)
+{
+    String text;
+    text.reserve(0x400000);
+
+    std::mt19937_64 rng(37);
+    while (text.size() < 0x400000)
+    {
+        text.append(Char::toString(U32(rng())));
+        text.push_back(rng() % 8 == 0 ? '\n' : ',');
+    }
+
+    Timer  timer;
+    size_t a = 0, b = 0;
+
+    // the first field of every line
+    timer.reset();
+    {
+        StringArray lines;
+        Su::split(lines, text, '\n');
+        for (const String& line : lines)
+        {
+            StringArray fields;
+            Su::split(fields, line, ',');
+            a += fields.front().size();
+        }
+    }
+    report("Su::split first field", timer.getMicroseconds());
+
+    timer.reset();
+    for (const StringView line : Su::splitView(text, '\n'))
+        b += Su::splitView(line, ',').begin()->size();
+    report("Su::splitView first field", timer.getMicroseconds());
+    EXPECT_EQ(a, b);
+}
+
+GTEST_TEST(Benchmark, NumberParse_001)
+{
+    constexpr U32 count = 0x20000;
+
+    std::mt19937_64 rng(9);
+
+    StringBuilder ints, reals;
+    for (U32 i = 0; i < count; ++i)
+    {
+        ints.write(I64(rng() >> (rng() % 64)));
+        ints.write(' ');
+        reals.write(double(I64(rng() % 2000000) - 1000000) / 997.0);
+        reals.write(' ');
+    }
+
+    const String intText  = ints.toString();
+    const String realText = reals.toString();
+
+    // The sums wrap, so they are kept unsigned.
+    Timer timer;
+    U64   a = 0, b = 0;
+
+    // strtoll needs the terminator, so it stands in for the old path
+    timer.reset();
+    for (const char* p = intText.c_str(); *p; ++p)
+    {
+        char* end;
+        a += U64(std::strtoll(p, &end, 10));
+        p = end;
+    }
+    report("strtoll integers", timer.getMicroseconds());
+
+    timer.reset();
+    const char* last = intText.data() + intText.size();
+    for (const char* p = intText.data(); p < last; ++p)
+    {
+        I64 v = 0;
+        p     = NumberParse::integer(p, last, v).end;
+        b += U64(v);
+    }
+    report("NumberParse integers", timer.getMicroseconds());
+    EXPECT_EQ(a, b);
+
+    double x = 0, y = 0;
+    timer.reset();
+    for (const char* p = realText.c_str(); *p; ++p)
+    {
+        char* end;
+        x += std::strtod(p, &end);
+        p = end;
+    }
+    report("strtod reals", timer.getMicroseconds());
+
+    timer.reset();
+    last = realText.data() + realText.size();
+    for (const char* p = realText.data(); p < last; ++p)
+    {
+        double v = 0;
+        p        = NumberParse::real(p, last, v).end;
+        y += v;
+    }
+    report("NumberParse reals", timer.getMicroseconds());
+    EXPECT_EQ(x, y);
+}
+
+GTEST_TEST(Benchmark, StringBuilder_001)
+{
+    constexpr size_t target = 0x800000;
+
+    const String line = "{\"key\": \"value\", \"number\": 1234567},\n";
+
+    const auto build = [&line](const U8 strategy, const char* name)
+    {
+        Timer timer;
+        timer.reset();
+
+        StringBuilder sb(strategy, 256);
+        while (sb.size() < target)
+            sb.write(line);
+
+        const String result = sb.release();
+        report(name, timer.getMicroseconds());
+        return result.size();
+    };
+
+    const size_t a = build(ALLOC_N_BYTE_BLOCK, "ALLOC_N_BYTE_BLOCK 8MB");
+    const size_t b = build(ALLOC_MUL2, "ALLOC_MUL2 8MB");
+    const size_t c = build(ALLOC_CHUNKED, "ALLOC_CHUNKED 8MB");
+    EXPECT_EQ(a, b);
+    EXPECT_EQ(b, c);
+}
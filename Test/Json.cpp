@@ -33,6 +33,69 @@ GTEST_TEST(Json, Token_001)
     EXPECT_EQ(tok.value().size(), 12);
     EXPECT_LE(tok.value().capacity(), 64);
 }
+
+GTEST_TEST(Json, Token_002)
+{
+    Internal::Lex::Token tok;
+    tok.push_back("\x1F\x41");
+    EXPECT_EQ(tok.view(), "A");
+
+    tok.push_back('B');
+    EXPECT_EQ(tok.view(), "AB");
+    EXPECT_EQ(tok.view(), tok.value());
+
+    tok.clear();
+    EXPECT_TRUE(tok.view().empty());
+}
+
+namespace
+{
+    class ViewCollector final : public Internal::Visitor
+    {
+    public:
+        Rt2::StringArray keys;
+        Rt2::StringArray values;
+
+    protected:
+        void keyValueParsed(const Rt2::StringView&     key,
+                            const Internal::Lex::Type&,
+                            const Rt2::StringView&     value) override
+        {
+            keys.emplace_back(key);
+            values.emplace_back(value);
+        }
+
+        void integerParsed(const Rt2::StringView& value) override
+        {
+            values.emplace_back(value);
+        }
+
+        void stringParsed(const Rt2::StringView& value) override
+        {
+            values.emplace_back(value);
+        }
+    };
+}  // namespace
+
+GTEST_TEST(Json, Visitor_001)
+{
+    ViewCollector          collector;
+    Internal::Parser       parser(&collector);
+    Rt2::InputStringStream iss(R"({"a": 12, "bc": "xyz", "d": [1, "two"]})");
+    parser.parse(iss);
+
+    ASSERT_EQ(collector.keys.size(), 3);
+    EXPECT_EQ(collector.keys[0], "a");
+    EXPECT_EQ(collector.keys[1], "bc");
+    EXPECT_EQ(collector.keys[2], "d");
+
+    ASSERT_EQ(collector.values.size(), 5);
+    EXPECT_EQ(collector.values[0], "12");
+    EXPECT_EQ(collector.values[1], "xyz");
+    EXPECT_EQ(collector.values[2], "1");
+    EXPECT_EQ(collector.values[3], "two");
+}
+
 GTEST_TEST(Json, Scan_001)
 {
     Rt2::InputFileStream ifs(TestFile("test2.json"));
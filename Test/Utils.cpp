@@ -28,7 +28,7 @@
  * [ ] Console
  * [ ] FileSystem
  * [x] FixedArray
- * [ ] FixedString
+ * [x] FixedString
  * [ ] Hash
  * [x] HashMap
  * [ ] IndexCache
@@ -37,7 +37,7 @@
  * [ ] Set
  * [x] Stack
  * [ ] String
- * [ ] StringBuilder
+ * [x] StringBuilder
  * [ ] Time
  * [ ] Timer
  * [ ] Fill
@@ -46,15 +46,21 @@
  * [x] ListBinaryTree
  */
 
+#include <cfloat>
+#include <iomanip>
+#include <random>
+#include <unordered_map>
 #include "ThisDir.h"
 #include "Utils/Allocator.h"
 #include "Utils/Array.h"
 #include "Utils/Char.h"
 #include "Utils/Directory/Path.h"
 #include "Utils/FixedArray.h"
+#include "Utils/FixedString.h"
 #include "Utils/HashMap.h"
 #include "Utils/Path.h"
 #include "Utils/Stack.h"
+#include "Utils/StringBuilder.h"
 #include "gtest/gtest.h"
 
 using namespace Rt2;
@@ -360,6 +366,194 @@ GTEST_TEST(Utils, String_Trim)
     EXPECT_EQ("A\tB C", inp);
 }
 
+GTEST_TEST(Utils, String_Trim_002)
+{
+    String inp = "ab     ";
+    StringUtils::trimWs(inp, inp);
+    EXPECT_EQ("ab", inp);
+
+    inp = " \r\n\t ";
+    StringUtils::trimWs(inp, inp);
+    EXPECT_EQ("", inp);
+
+    String out;
+    StringUtils::trimWs(out, "\n  a b\t");
+    EXPECT_EQ("a b", out);
+
+    EXPECT_EQ(StringUtils::stripEol(" a \r\n\tb\x01 \n\nc", ';'), "a;\tb;;c;");
+    EXPECT_EQ(StringUtils::stripEol("a\n\rb\r"), "ab");
+    EXPECT_EQ(StringUtils::stripEol("a\n ", '|'), "a||");
+    EXPECT_EQ(StringUtils::stripEol("a\n\x02", '|'), "a|");
+}
+
+GTEST_TEST(Utils, String_Split_001)
+{
+    StringArray a;
+    StringUtils::split(a, ",a,,bc,", ',');
+    ASSERT_EQ(4, a.size());
+    EXPECT_EQ("", a[0]);
+    EXPECT_EQ("a", a[1]);
+    EXPECT_EQ("", a[2]);
+    EXPECT_EQ("bc", a[3]);
+
+    a.clear();
+    StringUtils::split(a, "a::b:c::", "::");
+    ASSERT_EQ(2, a.size());
+    EXPECT_EQ("a", a[0]);
+    EXPECT_EQ("b:c", a[1]);
+
+    a.clear();
+    StringUtils::splitRejectEmpty(a, " x , ,y,\t", ',');
+    ASSERT_EQ(2, a.size());
+    EXPECT_EQ("x", a[0]);
+    EXPECT_EQ("y", a[1]);
+
+    String s = "aXbXXc";
+    StringUtils::replaceAll(s, "X", "Y");
+    EXPECT_EQ("aYbYYc", s);
+    StringUtils::replaceAll(s, s, "YY", "-");
+    EXPECT_EQ("aYb-c", s);
+
+    String d;
+    StringUtils::replaceAll(d, "aaaa", "aa", "b");
+    EXPECT_EQ("bb", d);
+    StringUtils::replaceAll(d, "abc", "", "x");
+    EXPECT_EQ("abc", d);
+    StringUtils::replaceAll(d, "abcabc", "bc", "BCD");
+    EXPECT_EQ("aBCDaBCD", d);
+}
+
+GTEST_TEST(Utils, String_SplitView_001)
+{
+    const String line = "a,,b,c,";
+
+    StringArray pieces;
+    for (const StringView piece : Su::splitView(line, ','))
+        pieces.emplace_back(piece);
+
+    StringArray expected;
+    Su::split(expected, line, ',');
+    EXPECT_EQ(expected, pieces);
+
+    pieces.clear();
+    Su::splitView(line, ',', true).copyTo(pieces);
+    ASSERT_EQ(3, pieces.size());
+    EXPECT_EQ("a", pieces[0]);
+    EXPECT_EQ("b", pieces[1]);
+    EXPECT_EQ("c", pieces[2]);
+
+    pieces.clear();
+    Su::splitView(line, ',', false, 2).copyTo(pieces);
+    ASSERT_EQ(3, pieces.size());
+    EXPECT_EQ("a", pieces[0]);
+    EXPECT_EQ("", pieces[1]);
+    EXPECT_EQ("b,c,", pieces[2]);
+
+    pieces.clear();
+    Su::splitView(line, ',', true, 1).copyTo(pieces);
+    ASSERT_EQ(2, pieces.size());
+    EXPECT_EQ("a", pieces[0]);
+    EXPECT_EQ("b,c,", pieces[1]);
+
+    pieces.clear();
+    Su::splitView("key := value := x", " := ", false, 1).copyTo(pieces);
+    ASSERT_EQ(2, pieces.size());
+    EXPECT_EQ("key", pieces[0]);
+    EXPECT_EQ("value := x", pieces[1]);
+
+    pieces.clear();
+    Su::splitView(" a\t b  c ", isWs, true).copyTo(pieces);
+    ASSERT_EQ(3, pieces.size());
+    EXPECT_EQ("a", pieces[0]);
+    EXPECT_EQ("b", pieces[1]);
+    EXPECT_EQ("c", pieces[2]);
+
+    EXPECT_TRUE(Su::splitView("", ',').empty());
+    EXPECT_TRUE(Su::splitView(",,", ',', true).empty());
+
+    // only the first field is looked at
+    const auto fields = Su::splitView("first;second;third", ';');
+    EXPECT_EQ(*fields.begin(), "first");
+    EXPECT_EQ(std::distance(fields.begin(), fields.end()), 3);
+}
+
+GTEST_TEST(Utils, String_SplitView_002)
+{
+    std::mt19937_64 rng(19);
+
+    const char alphabet[] = "ab,:";
+    for (int round = 0; round < 2000; ++round)
+    {
+        String text;
+        for (size_t i = 0, n = rng() % 24; i < n; ++i)
+            text.push_back(alphabet[rng() % (sizeof alphabet - 1)]);
+
+        const String separator = rng() % 2 ? "," : ",:";
+
+        StringArray expected, pieces;
+        Su::split(expected, text, separator);
+        Su::splitView(text, StringView(separator)).copyTo(pieces);
+        EXPECT_EQ(expected, pieces);
+
+        expected.clear();
+        pieces.clear();
+        Su::splitRejectEmpty(expected, text, ',');
+        Su::splitView(text, ',', true).copyTo(pieces);
+        EXPECT_EQ(expected, pieces);
+    }
+}
+
+GTEST_TEST(Utils, String_Concat_001)
+{
+    const String     a = "abc";
+    const StringView b = "def";
+
+    EXPECT_EQ(Su::concat(a, '/', b, "/", 42, -7, 1.5, true), "abc/def/42-71.51");
+    EXPECT_EQ(Su::concat(), "");
+    EXPECT_EQ(Su::concat((const char*)nullptr, a), "abc");
+
+    // the numbers match what a stream writes
+    OutputStringStream oss;
+    oss << UINT64_MAX << INT64_MIN << 0.1 << 1e300 << 123456789.0f << (short)-5 << 'x';
+    EXPECT_EQ(Su::concat(UINT64_MAX, INT64_MIN, 0.1, 1e300, 123456789.0f, (short)-5, 'x'), oss.str());
+
+    String dest = "base";
+    Su::appendTo(dest, ':', 1, ':', a);
+    EXPECT_EQ(dest, "base:1:abc");
+
+    // arguments may alias dest, as with std::string::append
+    String self = "0123456789abcdefghijklmnop";
+    Su::appendTo(self, self, "x");
+    EXPECT_EQ(self, "0123456789abcdefghijklmnop0123456789abcdefghijklmnopx");
+
+    self = "0123456789abcdefghijklmnop";
+    Su::appendTo(self, '-', StringView(self).substr(20));
+    EXPECT_EQ(self, "0123456789abcdefghijklmnop-klmnop");
+
+    // types without a conversion still stream
+    int value = 0;
+    EXPECT_FALSE(IsConcatenable<int*>);
+    EXPECT_FALSE(Su::join("p", &value).empty());
+
+    EXPECT_EQ(Su::csv(',', a, 2, b), ",abc,2,def");
+    EXPECT_EQ(Su::csv(StringArray{"a", "", "c"}), "a,,c");
+    EXPECT_EQ(Su::csv(StringArray{}), "");
+
+    oss.str("");
+    Su::merge(oss, a, 3, b);
+    EXPECT_EQ(oss.str(), "abc3def");
+
+    // merge keeps the state of the caller's stream
+    oss.str("");
+    oss << std::setprecision(3);
+    Su::merge(oss, 3.14159);
+    oss << std::hex;
+    Su::merge(oss, ' ', 255, ' ');
+    oss << std::dec << std::setfill('.') << std::setw(6);
+    Su::merge(oss, 42);
+    EXPECT_EQ(oss.str(), "3.14 ff ....42");
+}
+
 GTEST_TEST(Utils, String_CheckBegEnd)
 {
     EXPECT_EQ(Su::startsWith("#A", ""), false);
@@ -412,6 +606,62 @@ GTEST_TEST(Utils, Filter_real)
     EXPECT_EQ(cmp, exp);
 }
 
+GTEST_TEST(Utils, Filter_predicate)
+{
+    String out;
+    EXPECT_TRUE(Su::filter(out, "a1b2c3", [](const char ch) { return ch > '9'; }));
+    EXPECT_EQ(out, "abc");
+
+    // in place, and limited to max characters
+    String inp = "x-1.5e+3y";
+    EXPECT_TRUE(Su::filterReal(inp, inp));
+    EXPECT_EQ(inp, "-1.5e+3");
+    EXPECT_TRUE(Su::filterInt(inp, inp, 2));
+    EXPECT_EQ(inp, "-1");
+
+    inp = "\x01 Tab\there\r\n\x7F\xC3\xA9";
+    Su::filterAscii(out, inp);
+    EXPECT_EQ(out, " Tab\there\r\n\x7F");
+
+    Su::filterRange(out, inp, -128, -1);
+    EXPECT_EQ(out, "\xC3\xA9");
+    Su::filterRange(out, inp, 'a', 'z');
+    EXPECT_EQ(out, "abhere");
+    Su::filterRange(out, inp, 'z', 'a');
+    EXPECT_EQ(out, "");
+
+    // Npos means no limit
+    Su::filterAscii(out, "Hello, World 123", Npos);
+    EXPECT_EQ(out, "Hello, World 123");
+    Su::filterAZaz(out, "Hello, World 123", Npos);
+    EXPECT_EQ(out, "HelloWorld");
+    Su::filterInt(out, "x-12y", Npos);
+    EXPECT_EQ(out, "-12");
+
+    Su::toUpper(out, "Mixed Case 123 \xE9z");
+    EXPECT_EQ(out, "MIXED CASE 123 \xE9Z");
+    Su::toLower(out, out);
+    EXPECT_EQ(out, "mixed case 123 \xE9z");
+}
+
+GTEST_TEST(Utils, Char_class)
+{
+    static_assert(isClass('7', CC_DECIMAL | CC_REAL));
+    static_assert(!isClass(-1, ~0));
+    static_assert(!isClass(256, ~0));
+
+    for (int ch = -128; ch < 512; ++ch)
+    {
+        const bool ascii = ch >= 0 && ch < 128;
+        EXPECT_EQ(isDecimal(ch), ch >= '0' && ch <= '9');
+        EXPECT_EQ(isLetter(ch), ascii && isalpha(ch) != 0);
+        EXPECT_EQ(isAlphaNumeric(ch), ascii && isalnum(ch) != 0);
+        EXPECT_EQ(isWhiteSpace(ch), ch == ' ' || ch == '\t' || ch == '\r' || ch == '\n');
+        EXPECT_EQ(isPrintableAscii(ch), (ch >= 32 && ch < 128) || isWhiteSpace(ch));
+        EXPECT_EQ(isReal(ch), isDecimal(ch) || (ascii && ch > 0 && strchr("+-.eEfF", ch) != nullptr));
+    }
+}
+
 GTEST_TEST(Utils, Stack_001)
 {
     IntStack a;
@@ -744,6 +994,102 @@ GTEST_TEST(Utils, Char_stringI64)
     }
 }
 
+GTEST_TEST(Utils, Char_parse)
+{
+    const String in = "70000 -70000 4294967296";
+
+    const char* first = in.data();
+    const char* last  = first + in.size();
+
+    I16         i16 = 0;
+    ParseResult r   = Char::parse(first, last, i16);
+    EXPECT_EQ(r.error, PE_RANGE);
+    EXPECT_EQ(i16, std::numeric_limits<I16>::max());
+
+    I32 i32 = 0;
+    r = Char::parse(r.end + 1, last, i32);
+    EXPECT_TRUE(r.ok());
+    EXPECT_EQ(i32, -70000);
+
+    U32 u32 = 0;
+    r = Char::parse(r.end + 1, last, u32);
+    EXPECT_EQ(r.error, PE_RANGE);
+    EXPECT_EQ(u32, 0xFFFFFFFF);
+    EXPECT_EQ(r.end, last);
+
+    double d = 0;
+    EXPECT_TRUE(Char::parse(first, first + 2, d).ok());
+    EXPECT_EQ(d, 70.0);
+
+    // the string conversions keep the strtol and stream rules
+    EXPECT_EQ(Char::toInt32("  +42"), 42);
+    EXPECT_EQ(Char::toInt32("0x1F", -1, 16), 31);
+    EXPECT_EQ(Char::toInt32("0x1F", -1, 0), 31);
+    EXPECT_EQ(Char::toInt32("017", -1, 0), 15);
+    EXPECT_EQ(Char::toUint32("-1"), 0xFFFFFFFF);
+    EXPECT_EQ(Char::toUint64("-1"), 0xFFFFFFFFFFFFFFFF);
+    EXPECT_EQ(Char::toInt32(""), -1);
+    EXPECT_EQ(Char::toInt32(nullptr, 5), 5);
+
+    EXPECT_EQ(Char::toDouble(" 1.25e2"), 125.0);
+    EXPECT_EQ(Char::toDouble("abc"), 0.0);
+    EXPECT_EQ(Char::toDouble("1e999"), std::numeric_limits<double>::max());
+    EXPECT_EQ(Char::toDouble("", 2.0), 2.0);
+    EXPECT_EQ(Char::toFloat("+0.5"), 0.5f);
+    EXPECT_EQ(Char::toFloat("0x10"), 16.f);
+    EXPECT_EQ(Char::toFloat("1e39"), std::numeric_limits<float>::infinity());
+}
+
+GTEST_TEST(Utils, Char_format)
+{
+    char buf[80];
+
+    const auto str = [&buf](const size_t len)
+    {
+        return String(buf, len);
+    };
+
+    EXPECT_EQ(str(Char::format(buf, sizeof buf, I16(-32768))), "-32768");
+    EXPECT_EQ(str(Char::format(buf, sizeof buf, U16(65535))), "65535");
+    EXPECT_EQ(str(Char::format(buf, sizeof buf, I64(-1))), "-1");
+    EXPECT_EQ(str(Char::format(buf, sizeof buf, 0.1)), "0.1");
+    EXPECT_EQ(str(Char::format(buf, sizeof buf, 0.1f)), "0.1");
+    EXPECT_EQ(str(Char::formatHex(buf, sizeof buf, U8(0xA))), "0A");
+    EXPECT_EQ(str(Char::formatHex(buf, sizeof buf, U32(0xBEEF))), "0000BEEF");
+    EXPECT_EQ(str(Char::formatBinary(buf, sizeof buf, U8(5))), "00000101");
+    EXPECT_EQ(str(Char::formatComma(buf, sizeof buf, 0)), "0");
+    EXPECT_EQ(str(Char::formatComma(buf, sizeof buf, 999)), "999");
+    EXPECT_EQ(str(Char::formatComma(buf, sizeof buf, 1234567)), "1,234,567");
+    EXPECT_EQ(str(Char::formatComma(buf, sizeof buf, 123456)), "123,456");
+
+    // nothing is written when the buffer is too small
+    buf[0] = 'x';
+    EXPECT_EQ(Char::format(buf, 4, U32(12345)), 0);
+    EXPECT_EQ(Char::formatHex(buf, 3, U16(1)), 0);
+    EXPECT_EQ(Char::formatComma(buf, 4, 1000), 0);
+    EXPECT_EQ(buf[0], 'x');
+    EXPECT_EQ(Char::format(buf, 5, U32(12345)), 5);
+    EXPECT_EQ(Char::format(nullptr, 0, 1.5), 0);
+
+    EXPECT_EQ(Char::toString(I32(-42)), "-42");
+    EXPECT_EQ(Char::toString(1.5, true), "1.5");
+    EXPECT_EQ(Char::toString(1.5, false), "1.500000000000000");
+    EXPECT_EQ(Char::toString(1.5f, false), "1.500000");
+
+    // longer than the inline buffer, as a classic stream writes it
+    OutputStringStream fixed;
+    fixed << std::fixed << std::setprecision(DBL_DIG) << -1.25e70;
+    EXPECT_EQ(Char::toString(-1.25e70, false), fixed.str());
+    EXPECT_EQ(Char::toHexString(U64(0xFF)), "00000000000000FF");
+    EXPECT_EQ(Char::toBinaryString(U16(0x8001)), "1000000000000001");
+    EXPECT_EQ(Char::commaInt(1000000), "1,000,000");
+
+    String   hex;
+    const U8 bytes[] = {0x00, 0x7F, 0xFF};
+    Char::toHexString(hex, bytes, sizeof bytes);
+    EXPECT_EQ(hex, "007FFF");
+}
+
 GTEST_TEST(Utils, FixedArray_001)
 {
     FixedArray<int, 10> a = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
@@ -1099,6 +1445,26 @@ GTEST_TEST(Utils, Array_005)
     }
 }
 
+GTEST_TEST(Utils, Array_006)
+{
+    using IntArray = SimpleArray<int>;
+
+    IntArray ia = {0, 1, 2, 3, 4, 5, 6, 7};
+
+    // Only the new elements are filled, the
+    // storage past the new size is not touched.
+    ia.resizeFast(2);
+    ia.resize(4, 9);
+    EXPECT_EQ(ia.size(), 4);
+    EXPECT_EQ(1, ia[1]);
+    EXPECT_EQ(9, ia[2]);
+    EXPECT_EQ(9, ia[3]);
+
+    ia.resizeFast(8);
+    EXPECT_EQ(4, ia[4]);
+    EXPECT_EQ(5, ia[5]);
+}
+
 GTEST_TEST(Utils, HashTable_002)
 {
     using Table = HashTable<String, int>;
@@ -1123,3 +1489,181 @@ GTEST_TEST(Utils, HashTable_002)
     EXPECT_EQ(table["aaaaaaaaaaaa3"], 3);
     EXPECT_EQ(table["aaaaaaa3aaaaa"], 4);
 }
+
+GTEST_TEST(Utils, HashTable_003)
+{
+    using Table = HashTable<String, int>;
+
+    Table table;
+    for (int i = 0; i < 100; ++i)
+        table.insert(std::to_string(i), i);
+
+    // Removing a key that is not present is a no-op.
+    table.remove("missing");
+    EXPECT_EQ(table.size(), 100);
+
+    for (int i = 0; i < 100; i += 2)
+        table.remove(std::to_string(i));
+    EXPECT_EQ(table.size(), 50);
+
+    for (int i = 0; i < 100; ++i)
+    {
+        if (i % 2)
+            EXPECT_EQ(table.get(std::to_string(i)), i);
+        else
+            EXPECT_EQ(table.find(std::to_string(i)), Npos);
+    }
+}
+
+GTEST_TEST(Utils, FixedString_001)
+{
+    using Str = FixedString<16>;
+
+    constexpr Str a("interned");
+    static_assert(a.size() == 8, "");
+    static_assert(a.hash() == HashFnv("interned", 8), "");
+    static_assert(a == std::string_view("interned"), "");
+    static_assert(a != Str("internee"), "");
+
+    EXPECT_EQ(a.hash(), Hash("interned"));
+    EXPECT_EQ(a.hash(), Hash(String("interned")));
+
+    Str b;
+    EXPECT_TRUE(b.empty());
+    EXPECT_EQ(b.hash(), Npos);
+    b.append("inter");
+    b += "ned";
+    EXPECT_EQ(b, a);
+    EXPECT_EQ(b.hash(), a.hash());
+
+    b.set(0, 'I');
+    EXPECT_NE(b, a);
+    EXPECT_EQ(b.hash(), Hash("Interned"));
+
+    // truncated at the capacity
+    const Str c("0123456789abcdefXYZ");
+    EXPECT_EQ(c.size(), 16);
+    EXPECT_EQ(c.view(), "0123456789abcdef");
+
+    // equal prefixes with different lengths are not equal
+    EXPECT_NE(Str("abc"), Str("abcd"));
+    EXPECT_EQ(Str("abcd", 3), Str("abc"));
+    EXPECT_TRUE(std::string_view("abc") == Str("abc"));
+
+    const FixedString<4> d("abc");
+    EXPECT_TRUE(d == Str("abc"));
+
+    // both construction and append stop at a null
+    const std::string_view nul("ab\0cd", 5);
+    Str                    e(nul);
+    EXPECT_EQ(e, Str("ab"));
+    e.append(nul);
+    EXPECT_EQ(e, Str("abab"));
+
+    b.clear();
+    EXPECT_EQ(b.hash(), Npos);
+    EXPECT_EQ(b, Str());
+}
+
+GTEST_TEST(Utils, FixedString_002)
+{
+    using Str   = FixedString<24>;
+    using Table = HashTable<Str, int>;
+
+    Table table;
+    for (int i = 0; i < 200; ++i)
+        table.insert(Str(std::to_string(i).c_str()), i);
+    EXPECT_EQ(table.size(), 200);
+
+    for (int i = 0; i < 200; ++i)
+        EXPECT_EQ(table.get(Str(std::to_string(i).c_str())), i);
+    EXPECT_EQ(table.find(Str("200")), Npos);
+
+    const Str::Hasher hasher;
+    EXPECT_EQ(hasher(Str("key")), hasher(std::string_view("key")));
+
+    std::unordered_map<Str, int, Str::Hasher> map;
+    map[Str("one")] = 1;
+    map[Str("two")] = 2;
+    EXPECT_EQ(map.at(Str("two")), 2);
+}
+
+GTEST_TEST(Utils, StringBuilder_001)
+{
+    StringBuilder sb;
+    sb.write("a=");
+    sb.write(I32(-42));
+    sb.write(',');
+    sb.write(U64(18446744073709551615ull));
+    sb.write(',');
+    sb.write(I16(-7));
+    sb.write(',');
+    sb.write(0.1);
+    sb.write(',');
+    sb.write(2.5f);
+    sb.write(',');
+    sb.write(1e300);
+    EXPECT_EQ(sb.toString(), "a=-42,18446744073709551615,-7,0.1,2.5,1e+300");
+
+    // crosses several block boundaries
+    StringBuilder big(8);
+    String        expected;
+    for (int i = 0; i < 1000; ++i)
+    {
+        big.write(I64(i) * 1000003);
+        big.write(' ');
+        expected += std::to_string(I64(i) * 1000003);
+        expected.push_back(' ');
+    }
+    EXPECT_EQ(big.toString(), expected);
+}
+
+GTEST_TEST(Utils, StringBuilder_002)
+{
+    StringBuilder chunked(ALLOC_CHUNKED, 16);
+    StringBuilder flat(ALLOC_MUL2, 16);
+
+    const String wide(3000, 'x');
+    for (int i = 0; i < 2000; ++i)
+    {
+        for (StringBuilder* sb : {&chunked, &flat})
+        {
+            sb->write(I32(i));
+            sb->write(' ');
+            sb->write(i * 0.25);
+            sb->write('\n');
+            if (i % 500 == 0)
+                sb->write(wide);
+        }
+    }
+
+    const String expected = flat.toString();
+    EXPECT_EQ(chunked.size(), expected.size());
+    EXPECT_EQ(chunked.toString(), expected);
+
+    OutputStringStream oss;
+    chunked.writeTo(oss);
+    EXPECT_EQ(oss.str(), expected);
+
+    StringBuilder copy(ALLOC_CHUNKED, 8);
+    copy.write(chunked);
+    EXPECT_EQ(copy.toString(), expected);
+
+    if (FILE* fp = std::tmpfile())
+    {
+        EXPECT_TRUE(chunked.writeTo(fileno(fp)));
+        std::rewind(fp);
+
+        String read(expected.size() + 1, 0);
+        read.resize(std::fread(read.data(), 1, read.size(), fp));
+        std::fclose(fp);
+        EXPECT_EQ(read, expected);
+    }
+
+    const String released = chunked.release();
+    EXPECT_EQ(released, expected);
+    EXPECT_EQ(chunked.size(), 0);
+
+    chunked.write("reused");
+    EXPECT_EQ(chunked.toString(), "reused");
+}
@@ -1,7 +1,9 @@
+#include <thread>
 #include "Utils/Allocator.h"
 #include "Utils/Array.h"
 #include "Utils/Char.h"
 #include "Utils/Directory/Path.h"
+#include "Utils/Exception.h"
 #include "Utils/HashMap.h"
 #include "Utils/ListBinaryTree.h"
 #include "Utils/ObjectPool.h"
@@ -90,6 +92,119 @@ GTEST_TEST(Utils, SymbolStream_002)
     }
 }
 
+GTEST_TEST(Utils, SymbolStream_003)
+{
+    // 10^n and 10^n - 1 as big-endian bytes
+    const auto raise = [](String& ten, const int n)
+    {
+        for (int i = 0; i < n; ++i)
+        {
+            int carry = 0;
+            for (size_t j = ten.size(); j-- > 0;)
+            {
+                const int v = (U8)ten[j] * 10 + carry;
+
+                ten[j] = (char)(v & 0xFF);
+                carry  = v >> 8;
+            }
+            if (carry)
+                ten.insert(ten.begin(), (char)carry);
+        }
+    };
+    const auto lessOne = [](String v)
+    {
+        for (size_t i = v.size(); i-- > 0;)
+        {
+            if (v[i]-- != 0)
+                break;
+        }
+        return v;
+    };
+
+    String ten(1, 1);
+    raise(ten, 2000);
+    String nines = lessOne(ten);
+
+    String s;
+    SymbolStream::toNumber(s, ten, SymbolStream::Base10);
+    EXPECT_EQ(s, "1" + String(2000, '0'));
+
+    SymbolStream::toNumber(s, nines, SymbolStream::Base10);
+    EXPECT_EQ(s, String(2000, '9'));
+
+    SymbolStream::toNumber(s, nines, SymbolStream::Base10, 1);
+    EXPECT_EQ(s, String(2000, '0'));
+
+    // large enough to divide by reciprocals
+    raise(ten, 8000);
+    nines = lessOne(ten);
+
+    SymbolStream dec(SymbolStream::Base10);
+    dec.number(s, ten);
+    EXPECT_EQ(s, "1" + String(10000, '0'));
+
+    InputStringStream  in(nines);
+    OutputStringStream out;
+    dec.number(out, in);
+    EXPECT_EQ(out.str(), String(10000, '9'));
+
+    SymbolStream ss(SymbolStream::Hex);
+    ss.number(s, String("\0\0\x01\x23\xAB\xCD", 6));
+    EXPECT_EQ(s, "123ABCD");
+
+    ss.number(s, String(3, 0));
+    EXPECT_EQ(s, "0");
+
+    ss.setBase(8);
+    ss.number(s, String("\xFF\xFF\xFF\xFF\xFF\xFF\xFF\xFF", 8));
+    EXPECT_EQ(s, "1777777777777777777777");
+
+    ss.setBase(12);
+    ss.number(s, String("\x12\x34\x56\x78\x9A", 5));
+    EXPECT_EQ(s, SymbolStream::toString((U64)0x123456789A, {'0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B'}));
+
+    SymbolStream tiny({'0', '1'});
+    tiny.setBase(3);
+    EXPECT_THROW(tiny.number(s, String("\x01", 1)), Exception);
+}
+
+GTEST_TEST(Utils, SymbolStream_004)
+{
+    SymbolStream ss(SymbolStream::Hex);
+    ss.setPad(true);
+
+    String s;
+    ss.base(s, 0xA);
+    EXPECT_EQ(s, "0A");
+
+    ss.setWs(true);
+    ss.base(s, 0xA);
+    EXPECT_EQ(s, " 0A");
+
+    ss.setPad(false);
+    ss.base(s, 0xA);
+    EXPECT_EQ(s, "  A");
+
+    // a single symbol is not a base
+    EXPECT_EQ(SymbolStream::toString((U64)5, {'z'}), "");
+    EXPECT_EQ(SymbolStream::toString((U64)0, {'z'}), "");
+
+    // bytes outside of 1-127 are skipped
+    ss.setWs(false);
+    ss.base(s, String("\x01\0\x80\x7F", 4));
+    EXPECT_EQ(s, "17F");
+
+    // spans several reads
+    String expected;
+    for (int i = 0; i < 0x3000; ++i)
+        expected.append("7A");
+
+    InputStringStream  in(String(0x3000, 'z'));
+    OutputStringStream out;
+    ss.base(out, in);
+    EXPECT_EQ(out.str(), expected);
+}
+
 constexpr int List[] = {50, 30, 70, 20, 40, 60, 80, 32, 34, 36, 65, 75, 85};
 constexpr int C1[]   = {36, 20, 65, 75, 85};
 constexpr int C2[]   = {32, 60, 40};
@@ -415,23 +530,146 @@ GTEST_TEST(Utils, ObjectPool_001)
 
     using RectPool = ObjectPool<int, m1>;
 
-    RectPool a, b;
+    RectPool a;
     for (int i = 0; i < m2; ++i)
     {
         int* r = a.allocate();
 
-        // tests the new placement call in free.
-        // Reset any previous state of it with
-        // the default constructor
+        // Tests that allocate constructs the object,
+        // rather than returning the previous state
         *r = m2;
         a.free(r);
         r = a.allocate();
         EXPECT_NE(*r, m2);
 
         *r = m2;
-        b.free(r);
+        a.free(r);
     }
 
     EXPECT_EQ(a.capacity(), m1);
-    EXPECT_EQ(b.capacity(), m2 + m1);
+    EXPECT_EQ(a.used(), 0);
+}
+
+GTEST_TEST(Utils, ObjectPool_002)
+{
+    static int live = 0;
+
+    struct Tracked
+    {
+        int a, b;
+
+        Tracked(const int x, const int y) :
+            a(x),
+            b(y)
+        {
+            ++live;
+        }
+
+        ~Tracked() { --live; }
+    };
+
+    ObjectPool<Tracked, 0x10> pool;
+
+    Array<Tracked*> objects;
+    for (int i = 0; i < 100; ++i)
+        objects.push_back(pool.allocate(i, i * 2));
+
+    EXPECT_EQ(live, 100);
+    EXPECT_EQ(pool.used(), 100);
+    EXPECT_EQ(pool.capacity(), 112);
+    EXPECT_EQ(objects[7]->b, 14);
+
+    // Consecutive objects come from the same slab.
+    EXPECT_EQ(objects[1], objects[0] + 1);
+
+    for (Tracked* obj : objects)
+        pool.free(obj);
+    EXPECT_EQ(live, 0);
+
+    // Freed slots are reused before the pool grows.
+    for (int i = 0; i < 100; ++i)
+        pool.free(pool.allocate(i, i));
+    EXPECT_EQ(pool.capacity(), 112);
+
+    pool.clear();
+    EXPECT_EQ(pool.capacity(), 0);
+}
+
+GTEST_TEST(Utils, SharedObjectPool_001)
+{
+    constexpr int perThread = 10000;
+
+    SharedObjectPool<U64> pool;
+
+    Array<U64*> shared[4];
+
+    std::thread producers[4];
+    for (int t = 0; t < 4; ++t)
+    {
+        producers[t] = std::thread([&pool, &shared, t]
+                                   {
+                                       for (int i = 0; i < perThread; ++i)
+                                       {
+                                           U64* v = pool.allocate((U64)t * perThread + i);
+                                           if (i % 2)
+                                               pool.free(v);
+                                           else
+                                               shared[t].push_back(v);
+                                       } });
+    }
+    for (std::thread& th : producers)
+        th.join();
+
+    // Free every object kept by the producers from other threads.
+    std::thread consumers[4];
+    for (int t = 0; t < 4; ++t)
+    {
+        consumers[t] = std::thread([&pool, &shared, t]
+                                   {
+                                       const Array<U64*>& objects = shared[(t + 1) % 4];
+                                       const U64 base = (U64)((t + 1) % 4) * perThread;
+                                       for (U32 i = 0; i < objects.size(); ++i)
+                                       {
+                                           EXPECT_EQ(*objects[i], base + i * 2);
+                                           pool.free(objects[i]);
+                                       } });
+    }
+    for (std::thread& th : consumers)
+        th.join();
+
+    EXPECT_LE(pool.capacity(), 4 * perThread);
+}
+
+GTEST_TEST(Utils, SharedObjectPool_002)
+{
+    using Pool = SharedObjectPool<U64, 0x40, 0x20>;
+
+    const auto fill = [](Pool& pool)
+    {
+        Array<U64*> objects;
+        for (int i = 0; i < 0x40; ++i)
+            objects.push_back(pool.allocate((U64)i));
+        for (U64* v : objects)
+            pool.free(v);
+    };
+
+    // Slots cached by a thread go back to the pool when it exits.
+    Pool pool;
+    std::thread([&pool]
+                { pool.free(pool.allocate((U64)1)); })
+        .join();
+    fill(pool);
+    EXPECT_EQ(pool.capacity(), 0x40);
+
+    // And when its magazine entry is taken by another pool.
+    pool.free(pool.allocate((U64)2));
+
+    Pool others[0x20];
+    for (Pool& other : others)
+        other.free(other.allocate((U64)3));
+
+    std::thread([&pool, &fill]
+                { fill(pool); })
+        .join();
+    EXPECT_EQ(pool.capacity(), 0x40);
 }
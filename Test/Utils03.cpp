@@ -0,0 +1,1565 @@
+#include <map>
+#include <random>
+#include <thread>
+#include "Utils/Array.h"
+#include "Utils/Base64.h"
+#include "Utils/BTreeMap.h"
+#include "Utils/BitArray.h"
+#include "Utils/BoundedCache.h"
+#include "Utils/Char.h"
+#include "Utils/Columns.h"
+#include "Utils/Console.h"
+#include "Utils/Cpu.h"
+#include "Utils/Filter.h"
+#include "Utils/FileSystem.h"
+#include "Utils/FlatMap.h"
+#include "Utils/HexCodec.h"
+#include "Utils/MultiMatcher.h"
+#include "Utils/NumberFormat.h"
+#include "Utils/NumberParse.h"
+#include "Utils/SlotMap.h"
+#include "Utils/String.h"
+#include "Utils/StringInterner.h"
+#include "Utils/StringScan.h"
+#include "Utils/StringTable.h"
+#include "Utils/TimerWheel.h"
+#include "gtest/gtest.h"
+
+using namespace Rt2;
+
+GTEST_TEST(Utils, TimerWheel_001)
+{
+    TimerWheel wheel(1000);
+    wheel.reset(0);
+
+    const TimerId a = wheel.schedule(1000, 1);
+    const TimerId b = wheel.schedule(2500, 2);
+    const TimerId c = wheel.schedule(10000, 3);
+    EXPECT_EQ(wheel.size(), 3);
+    EXPECT_TRUE(wheel.pending(a));
+
+    Array<U64> fired;
+
+    const auto collect = [&fired](const TimerEvents& events)
+    {
+        for (const auto& ev : events)
+            fired.push_back(ev.data);
+    };
+
+    EXPECT_EQ(wheel.advance(999, collect), 0);
+    EXPECT_EQ(wheel.advance(1000, collect), 1);
+    EXPECT_EQ(fired.size(), 1);
+    EXPECT_EQ(fired[0], 1);
+    EXPECT_FALSE(wheel.pending(a));
+
+    EXPECT_TRUE(wheel.cancel(b));
+    EXPECT_FALSE(wheel.cancel(b));
+    EXPECT_FALSE(wheel.cancel(a));
+
+    EXPECT_EQ(wheel.advance(9999, collect), 0);
+    EXPECT_EQ(wheel.advance(10000, collect), 1);
+    EXPECT_EQ(fired.size(), 2);
+    EXPECT_EQ(fired[1], 3);
+    EXPECT_FALSE(wheel.pending(c));
+    EXPECT_TRUE(wheel.empty());
+}
+
+GTEST_TEST(Utils, TimerWheel_002)
+{
+    // Spans every level of the wheel, including delays that
+    // have to be parked past the top level.
+    TimerWheel wheel(1);
+    wheel.reset(0);
+
+    const U64 delays[] = {
+        1,
+        255,
+        256,
+        257,
+        1000,
+        16383,
+        16384,
+        100000,
+        1 << 20,
+        (1 << 26) - 1,
+        1 << 26,
+        (U64(1) << 27) + 17,
+    };
+
+    for (const U64 delay : delays)
+        wheel.schedule(delay, delay);
+
+    U64  now = 0;
+    bool ok  = true;
+    for (const U64 delay : delays)
+    {
+        U64 fired = 0;
+
+        wheel.advance(delay - 1,
+                      [&fired](const TimerEvents& events)
+                      { fired += events.size(); });
+        ok = ok && fired == 0;
+
+        wheel.advance(delay,
+                      [&fired, delay](const TimerEvents& events)
+                      {
+                          fired += events.size();
+                          EXPECT_EQ(events[0].data, delay);
+                      });
+        ok  = ok && fired == 1;
+        now = delay;
+    }
+    EXPECT_TRUE(ok);
+    EXPECT_TRUE(wheel.empty());
+    EXPECT_EQ(wheel.tick(), now);
+}
+
+GTEST_TEST(Utils, TimerWheel_003)
+{
+    TimerWheel wheel(10);
+    wheel.reset(0);
+    wheel.setBudget(100);
+
+    constexpr U32 count = 1000;
+
+    Array<TimerId> ids;
+    for (U32 i = 0; i < count; ++i)
+        ids.push_back(wheel.schedule(50, i));
+
+    // cancel every other one, then reuse the nodes
+    for (U32 i = 0; i < count; i += 2)
+        EXPECT_TRUE(wheel.cancel(ids[i]));
+
+    for (U32 i = 0; i < count; i += 2)
+    {
+        const TimerId id = wheel.schedule(40, i);
+        EXPECT_FALSE(wheel.pending(ids[i]));
+        EXPECT_TRUE(wheel.pending(id));
+    }
+
+    size_t total = 0, calls = 0;
+    while (!wheel.empty())
+    {
+        const size_t n = wheel.advance(1000, nullptr);
+        EXPECT_LE(n, 100);
+        total += n;
+        ++calls;
+    }
+    EXPECT_EQ(total, count);
+    EXPECT_EQ(calls, 10);
+}
+
+GTEST_TEST(Utils, BTreeMap_001)
+{
+    // Sorted input must not degrade the tree.
+    BTreeMap<int, int> map;
+
+    constexpr int count = 100000;
+    for (int i = 0; i < count; ++i)
+        EXPECT_TRUE(map.insert(i, i * 2));
+
+    EXPECT_FALSE(map.insert(5, 0));
+    EXPECT_EQ(map.size(), count);
+    EXPECT_LE(map.depth(), 5);
+    EXPECT_EQ(map.get(5), 10);
+    EXPECT_EQ(map.get(count, -1), -1);
+
+    int expected = 0;
+    for (auto it = map.begin(); it != map.end(); ++it)
+    {
+        EXPECT_EQ(it.key(), expected);
+        EXPECT_EQ(*it, expected * 2);
+        ++expected;
+    }
+    EXPECT_EQ(expected, count);
+
+    for (int i = count - 1; i >= 0; --i)
+        EXPECT_TRUE(map.erase(i));
+    EXPECT_TRUE(map.empty());
+    EXPECT_FALSE(map.erase(0));
+}
+
+GTEST_TEST(Utils, BTreeMap_002)
+{
+    BTreeMap<U32, U32, 64> map;
+    std::map<U32, U32>     model;
+
+    std::mt19937 rng(7);
+    for (int i = 0; i < 200000; ++i)
+    {
+        const U32 key = rng() % 5000;
+        switch (rng() % 3)
+        {
+        case 0:
+            EXPECT_EQ(map.insert(key, i), model.insert({key, i}).second);
+            break;
+        case 1:
+            EXPECT_EQ(map.erase(key), model.erase(key) == 1);
+            break;
+        default:
+            EXPECT_EQ(map.contains(key), model.count(key) == 1);
+            break;
+        }
+    }
+
+    EXPECT_EQ(map.size(), model.size());
+
+    Array<U32> keys;
+    map.keys(keys);
+    ASSERT_EQ(keys.size(), model.size());
+
+    U32 i = 0;
+    for (const auto& [key, value] : model)
+    {
+        EXPECT_EQ(keys[i++], key);
+        EXPECT_EQ(map.get(key), value);
+    }
+}
+
+GTEST_TEST(Utils, BTreeMap_003)
+{
+    BTreeMap<int, int> map;
+    for (int i = 0; i < 1000; i += 10)
+        map.insert(i, i);
+
+    auto it = map.lowerBound(15);
+    ASSERT_TRUE(it.valid());
+    EXPECT_EQ(it.key(), 20);
+
+    it = map.lowerBound(20);
+    EXPECT_EQ(it.key(), 20);
+
+    it = map.upperBound(20);
+    EXPECT_EQ(it.key(), 30);
+
+    EXPECT_FALSE(map.lowerBound(991).valid());
+    EXPECT_EQ(map.minimum().key(), 0);
+    EXPECT_EQ(map.maximum().key(), 990);
+
+    int sum = 0;
+    map.range(100, 150, [&sum](const int&, int& v)
+              {
+                  sum += v;
+                  return 0; });
+    EXPECT_EQ(sum, 100 + 110 + 120 + 130 + 140);
+}
+
+GTEST_TEST(Utils, BTreeMap_004)
+{
+    Array<int> keys, values;
+    for (int i = 0; i < 50000; ++i)
+    {
+        keys.push_back(i * 3);
+        values.push_back(i);
+    }
+
+    BTreeMap<int, int> map;
+    map.build(keys, values);
+    EXPECT_EQ(map.size(), 50000);
+
+    for (int i = 0; i < 50000; ++i)
+        EXPECT_EQ(map.get(i * 3, -1), i);
+
+    // The built tree must still accept updates.
+    for (int i = 0; i < 50000; i += 2)
+        EXPECT_TRUE(map.erase(i * 3));
+    for (int i = 0; i < 100; ++i)
+        EXPECT_TRUE(map.insert(i * 3 + 1, -i));
+    EXPECT_EQ(map.size(), 25100);
+
+    Array<int> out;
+    map.keys(out);
+    for (U32 i = 1; i < out.size(); ++i)
+        EXPECT_LT(out[i - 1], out[i]);
+
+    keys.push_back(0);
+    values.push_back(0);
+    EXPECT_THROW(map.build(keys, values), Exception);
+}
+
+GTEST_TEST(Utils, FlatMap_001)
+{
+    FlatMap<int, int> map;
+    for (int i = 9; i >= 0; --i)
+        map.insert(i, i * 10);
+    map.insert(3, -1);
+
+    EXPECT_EQ(map.size(), 10);
+    EXPECT_EQ(map.get(3), 30);
+    EXPECT_EQ(map.get(42, -1), -1);
+    EXPECT_TRUE(map.contains(9));
+    EXPECT_FALSE(map.contains(10));
+
+    int expected = 0;
+    for (const int& v : map)
+    {
+        EXPECT_EQ(v, expected);
+        expected += 10;
+    }
+
+    map.assign(3, 33);
+    EXPECT_EQ(map.get(3), 33);
+
+    EXPECT_TRUE(map.erase(0));
+    EXPECT_FALSE(map.erase(0));
+    EXPECT_EQ(map.keyAt(0), 1);
+    EXPECT_EQ(map.lowerBound(5), 4);
+    EXPECT_EQ(map.upperBound(5), 5);
+
+    FlatMap<int, int>::Keys keys;
+    map.keys(keys, true);
+    EXPECT_EQ(keys.size(), 9);
+    EXPECT_EQ(keys.front(), 9);
+    EXPECT_EQ(keys.back(), 1);
+}
+
+GTEST_TEST(Utils, FlatMap_002)
+{
+    // Large enough to use the binary search.
+    FlatMap<U32, String, AOP_DEFAULT_TYPE> map;
+    std::map<U32, String>                  model;
+
+    std::mt19937 rng(11);
+    for (int i = 0; i < 20000; ++i)
+    {
+        const U32    key   = rng() % 700;
+        const String value = std::to_string(i);
+        if (rng() % 4 == 0)
+        {
+            EXPECT_EQ(map.erase(key), model.erase(key) == 1);
+        }
+        else
+        {
+            map.insert(key, value);
+            model.insert({key, value});
+        }
+        if (i % 97 == 0)
+        {
+            EXPECT_EQ(map.size(), model.size());
+        }
+    }
+
+    EXPECT_EQ(map.size(), model.size());
+    for (const auto& [key, value] : model)
+        EXPECT_EQ(map.get(key), value);
+}
+
+GTEST_TEST(Utils, FlatMap_003)
+{
+    FlatMap<int, int> a, b;
+    for (int i = 0; i < 100; i += 2)
+        a.insert(i, 1);
+    for (int i = 0; i < 100; i += 3)
+        b.insert(i, 2);
+
+    a.merge(b);
+    EXPECT_EQ(a.size(), 67);
+    EXPECT_EQ(a.get(6), 1);
+    EXPECT_EQ(a.get(3), 2);
+
+    FlatMap<int, int>::Keys keys;
+    a.keys(keys);
+    for (U32 i = 1; i < keys.size(); ++i)
+        EXPECT_LT(keys[i - 1], keys[i]);
+}
+
+GTEST_TEST(Utils, SlotMap_001)
+{
+    SlotMap<String> map;
+
+    const SlotHandle a = map.insert("a");
+    const SlotHandle b = map.insert("b");
+    const SlotHandle c = map.emplace(3, 'c');
+    EXPECT_EQ(map.size(), 3);
+    EXPECT_EQ(map.at(c), "ccc");
+
+    EXPECT_TRUE(map.erase(a));
+    EXPECT_FALSE(map.erase(a));
+    EXPECT_FALSE(map.contains(a));
+    EXPECT_EQ(map.get(a), nullptr);
+    EXPECT_THROW(map.at(a), Exception);
+
+    // The erased slot is reused with a new generation.
+    const SlotHandle d = map.insert("d");
+    EXPECT_EQ(d.index, a.index);
+    EXPECT_NE(d, a);
+    EXPECT_FALSE(map.contains(a));
+
+    EXPECT_EQ(map.at(b), "b");
+    EXPECT_EQ(map.at(c), "ccc");
+    EXPECT_EQ(map.at(d), "d");
+
+    String all;
+    for (const String& s : map)
+        all += s;
+    EXPECT_EQ(all.size(), 5);
+
+    EXPECT_FALSE(map.contains(SlotHandle{}));
+
+    map.clear();
+    EXPECT_TRUE(map.empty());
+    EXPECT_FALSE(map.contains(b));
+}
+
+GTEST_TEST(Utils, SlotMap_002)
+{
+    SlotMap<U64, AOP_SIMPLE_TYPE>            map;
+    std::vector<std::pair<U64, SlotHandle>> live;
+
+    std::mt19937 rng(3);
+    for (U64 i = 0; i < 50000; ++i)
+    {
+        if (live.empty() || rng() % 3)
+            live.emplace_back(i, map.insert(i));
+        else
+        {
+            const size_t idx = rng() % live.size();
+            EXPECT_TRUE(map.erase(live[idx].second));
+            EXPECT_FALSE(map.contains(live[idx].second));
+            live[idx] = live.back();
+            live.pop_back();
+        }
+    }
+
+    EXPECT_EQ(map.size(), live.size());
+    for (const auto& [value, handle] : live)
+        EXPECT_EQ(map.at(handle), value);
+
+    for (U32 i = 0; i < map.size(); ++i)
+        EXPECT_EQ(map.at(map.handleAt(i)), map.begin()[i]);
+}
+
+GTEST_TEST(Utils, StringInterner_001)
+{
+    StringInterner strings;
+
+    const StringId a = strings.insert("alpha");
+    const StringId b = strings.insert("beta");
+    EXPECT_EQ(a, 0);
+    EXPECT_EQ(b, 1);
+    EXPECT_EQ(strings.insert(String("alpha")), a);
+    EXPECT_EQ(strings.size(), 2);
+    EXPECT_EQ(strings.bytes(), 9);
+
+    EXPECT_EQ(strings.at(a), "alpha");
+    EXPECT_EQ(strings.at(b), "beta");
+    EXPECT_EQ(strings.find("gamma"), InvalidString);
+    EXPECT_THROW(strings.get("gamma"), Exception);
+    EXPECT_THROW(strings.at(2), Exception);
+
+    // Prefixes, empty strings and embedded nulls are distinct entries.
+    const StringId c = strings.insert("alp");
+    const StringId d = strings.insert("");
+    const StringId e = strings.insert(std::string_view("al\0x", 4));
+    EXPECT_NE(c, a);
+    EXPECT_EQ(strings.at(d), "");
+    EXPECT_EQ(strings.at(e).size(), 4);
+    EXPECT_EQ(strings.get(std::string_view("al\0x", 4)), e);
+
+    strings.clear();
+    EXPECT_TRUE(strings.empty());
+    EXPECT_FALSE(strings.contains("alpha"));
+}
+
+GTEST_TEST(Utils, StringInterner_002)
+{
+    StringInterner strings(false, 0x100);
+
+    constexpr U32 count = 100000;
+    for (U32 i = 0; i < count; ++i)
+        EXPECT_EQ(strings.insert("symbol_" + std::to_string(i)), i);
+
+    const String large(0x400, 'x');
+    EXPECT_EQ(strings.insert(large), count);
+
+    for (U32 i = 0; i < count; i += 7)
+    {
+        const String str = "symbol_" + std::to_string(i);
+        EXPECT_EQ(strings.find(str), i);
+        EXPECT_EQ(strings.at(i), str);
+    }
+    EXPECT_EQ(strings.at(count), large);
+}
+
+GTEST_TEST(Utils, StringInterner_003)
+{
+    // Readers resolve ids while a writer keeps inserting.
+    StringInterner strings(true);
+
+    constexpr U32     count = 50000;
+    std::atomic<bool> done{false};
+
+    std::thread writer([&strings, &done]
+                       {
+                           for (U32 i = 0; i < count; ++i)
+                               strings.insert(std::to_string(i));
+                           done = true; });
+
+    std::thread readers[2];
+    for (std::thread& reader : readers)
+    {
+        reader = std::thread([&strings, &done]
+                             {
+                                 while (!done)
+                                 {
+                                     const U32 size = strings.size();
+                                     for (U32 i = size > 64 ? size - 64 : 0; i < size; ++i)
+                                     {
+                                         const String str = std::to_string(i);
+                                         EXPECT_EQ(strings.at(i), str);
+                                         EXPECT_EQ(strings.find(str), i);
+                                     }
+                                 } });
+    }
+
+    writer.join();
+    for (std::thread& reader : readers)
+        reader.join();
+
+    EXPECT_EQ(strings.size(), count);
+}
+
+GTEST_TEST(Utils, BoundedCache_001)
+{
+    BoundedCache<U32, U32> cache(3);
+
+    cache.put(1, 10);
+    cache.put(2, 20);
+    cache.put(3, 30);
+    EXPECT_NE(cache.get(1), nullptr);
+
+    // 2 is now the least recently used.
+    cache.put(4, 40);
+    EXPECT_EQ(cache.size(), 3);
+    EXPECT_FALSE(cache.contains(2));
+    EXPECT_TRUE(cache.contains(1));
+
+    U32 value = 0;
+    EXPECT_TRUE(cache.get(4, value));
+    EXPECT_EQ(value, 40);
+    EXPECT_FALSE(cache.get(2, value));
+
+    const CacheStats& stats = cache.stats();
+    EXPECT_EQ(stats.hits, 2);
+    EXPECT_EQ(stats.misses, 1);
+    EXPECT_EQ(stats.evictions, 1);
+    EXPECT_DOUBLE_EQ(stats.hitRate(), 2.0 / 3.0);
+
+    EXPECT_TRUE(cache.erase(1));
+    EXPECT_FALSE(cache.erase(1));
+    EXPECT_EQ(cache.size(), 2);
+}
+
+GTEST_TEST(Utils, BoundedCache_002)
+{
+    BoundedCache<U32, U32> cache(3, CACHE_CLOCK);
+
+    cache.put(1, 1);
+    cache.put(2, 2);
+    cache.put(3, 3);
+
+    // 1 was referenced, so the hand passes it and takes 2.
+    EXPECT_NE(cache.get(1), nullptr);
+    cache.put(4, 4);
+    EXPECT_TRUE(cache.contains(1));
+    EXPECT_FALSE(cache.contains(2));
+    EXPECT_TRUE(cache.contains(3));
+    EXPECT_TRUE(cache.contains(4));
+}
+
+GTEST_TEST(Utils, BoundedCache_003)
+{
+    // A one pass scan should not flush the frequently used keys.
+    BoundedCache<U32, U32> lru(100);
+    BoundedCache<U32, U32> arc(100, CACHE_ARC);
+
+    for (int round = 0; round < 4; ++round)
+    {
+        for (int pass = 0; pass < 2; ++pass)
+        {
+            for (U32 i = 0; i < 50; ++i)
+            {
+                if (!lru.get(i))
+                    lru.put(i, i);
+                if (!arc.get(i))
+                    arc.put(i, i);
+            }
+        }
+        for (U32 i = 0; i < 200; ++i)
+        {
+            const U32 key = 1000 + round * 200 + i;
+            lru.put(key, key);
+            arc.put(key, key);
+        }
+    }
+
+    EXPECT_EQ(arc.size(), 100);
+    EXPECT_GT(arc.stats().hits, lru.stats().hits);
+
+    U32 kept = 0;
+    for (U32 i = 0; i < 50; ++i)
+        kept += arc.contains(i) ? 1 : 0;
+    EXPECT_EQ(kept, 50);
+}
+
+GTEST_TEST(Utils, BoundedCache_004)
+{
+    U64 now = 0;
+
+    BoundedCache<String, int> cache(8);
+    cache.setClock([&now]
+                   { return now; });
+
+    cache.put("a", 1, 100);
+    cache.put("b", 2);
+    cache.setTtl(50);
+    cache.put("c", 3);
+
+    now = 60;
+    EXPECT_NE(cache.get("a"), nullptr);
+    EXPECT_NE(cache.get("b"), nullptr);
+    EXPECT_EQ(cache.get("c"), nullptr);
+
+    now = 100;
+    EXPECT_EQ(cache.get("a"), nullptr);
+    EXPECT_EQ(cache.stats().expirations, 2);
+    EXPECT_EQ(cache.size(), 1);
+}
+
+GTEST_TEST(Utils, BoundedCache_005)
+{
+    // Random workload against a model of the ARC invariants.
+    BoundedCache<U32, U32> cache(64, CACHE_ARC);
+
+    std::mt19937 rng(5);
+    for (U32 i = 0; i < 100000; ++i)
+    {
+        const U32 key = rng() % 3 ? rng() % 96 : rng() % 4096;
+        if (const U32* value = cache.get(key))
+        {
+            EXPECT_EQ(*value, key * 3);
+        }
+        else
+        {
+            cache.put(key, key * 3);
+        }
+
+        if (i % 1000 == 0)
+            cache.erase(rng() % 96);
+        EXPECT_LE(cache.size(), 64);
+    }
+    EXPECT_GT(cache.stats().hitRate(), 0.3);
+}
+
+namespace
+{
+    template <typename Filter>
+    double measureFalsePositives(Filter& filter, const U64 count)
+    {
+        for (U64 i = 0; i < count; ++i)
+            filter.insert(i);
+
+        for (U64 i = 0; i < count; ++i)
+            EXPECT_TRUE(filter.contains(i));
+
+        U64 false_positives = 0;
+        for (U64 i = count; i < count * 11; ++i)
+            false_positives += filter.contains(i) ? 1 : 0;
+        return double(false_positives) / double(count * 10);
+    }
+}  // namespace
+
+GTEST_TEST(Utils, BloomFilter_001)
+{
+    BloomFilter standard(10000, 0.01);
+    EXPECT_LT(measureFalsePositives(standard, 10000), 0.02);
+    EXPECT_NEAR(standard.falsePositiveRate(), 0.01, 0.002);
+
+    BlockedBloomFilter blocked(10000, 0.01);
+    EXPECT_LT(measureFalsePositives(blocked, 10000), 0.02);
+    EXPECT_EQ(blocked.bits() % BlockedBloomFilter::BlockBits, 0);
+
+    String buffer;
+    blocked.save(buffer);
+
+    BlockedBloomFilter copy(1);
+    copy.load(buffer);
+    EXPECT_EQ(copy.bits(), blocked.bits());
+    for (U64 i = 0; i < 10000; ++i)
+        EXPECT_TRUE(copy.contains(i));
+
+    // The layouts differ, so a standard filter rejects it.
+    EXPECT_THROW(standard.load(buffer), Exception);
+    EXPECT_THROW(copy.load(buffer.substr(0, 20)), Exception);
+
+    blocked.clear();
+    EXPECT_FALSE(blocked.contains(U64(1)));
+}
+
+GTEST_TEST(Utils, CuckooFilter_001)
+{
+    CuckooFilter filter(10000, 0.01);
+    EXPECT_LT(measureFalsePositives(filter, 10000), 0.02);
+    EXPECT_EQ(filter.size(), 10000);
+
+    for (U64 i = 0; i < 10000; i += 2)
+        EXPECT_TRUE(filter.remove(i));
+    for (U64 i = 1; i < 10000; i += 2)
+        EXPECT_TRUE(filter.contains(i));
+    EXPECT_EQ(filter.size(), 5000);
+
+    String buffer;
+    filter.save(buffer);
+
+    CuckooFilter copy(1);
+    copy.load(buffer);
+    EXPECT_EQ(copy.size(), 5000);
+    for (U64 i = 1; i < 10000; i += 2)
+        EXPECT_TRUE(copy.contains(i));
+
+    // Fill past capacity until it refuses.
+    CuckooFilter small(64, 0.01);
+    U64 accepted = 0;
+    while (small.insert(accepted) && accepted < 1000)
+        ++accepted;
+    EXPECT_GE(accepted, 64);
+    EXPECT_LT(accepted, 1000);
+}
+
+GTEST_TEST(Utils, FilteredHashTable_001)
+{
+    FilteredHashTable<String, int> table(16);
+    for (int i = 0; i < 1000; ++i)
+        EXPECT_TRUE(table.insert(std::to_string(i), i));
+
+    EXPECT_EQ(table.size(), 1000);
+    for (int i = 0; i < 1000; ++i)
+        EXPECT_EQ(table.get(std::to_string(i)), i);
+    EXPECT_FALSE(table.contains("x"));
+
+    for (int i = 0; i < 1000; i += 2)
+        table.remove(std::to_string(i));
+    for (int i = 0; i < 1000; ++i)
+        EXPECT_EQ(table.contains(std::to_string(i)), i % 2 == 1);
+
+    FilteredCache<String> cache(100);
+    cache.save("a");
+    EXPECT_TRUE(cache.exists("a"));
+    EXPECT_FALSE(cache.exists("b"));
+}
+
+GTEST_TEST(Utils, BitArray_001)
+{
+    BitArray bits(130);
+    EXPECT_EQ(bits.size(), 130);
+    EXPECT_EQ(bits.wordCount(), 3);
+    EXPECT_TRUE(bits.none());
+    EXPECT_EQ(bits.findFirst(), Npos);
+
+    bits.set(3);
+    bits.set(64);
+    bits.set(129);
+    EXPECT_EQ(bits.count(), 3);
+    EXPECT_EQ(bits.findFirst(), 3);
+    EXPECT_EQ(bits.findNext(3), 64);
+    EXPECT_EQ(bits.findNext(64), 129);
+    EXPECT_EQ(bits.findNext(129), Npos);
+
+    Array<U64> set;
+    bits.forEachSet([&set](const U64 bit)
+                    { set.push_back(bit); });
+    ASSERT_EQ(set.size(), 3);
+    EXPECT_EQ(set[1], 64);
+
+    bits.flip(3);
+    EXPECT_FALSE(bits[3]);
+
+    // Growing with ones must not touch the existing bits.
+    bits.resize(200, true);
+    EXPECT_EQ(bits.count(), 2 + 70);
+    bits.resize(100);
+    EXPECT_EQ(bits.count(), 1);
+    bits.setAll();
+    EXPECT_EQ(bits.count(), 100);
+    bits.resize(300);
+    EXPECT_EQ(bits.count(), 100);
+}
+
+GTEST_TEST(Utils, BitArray_002)
+{
+    std::mt19937 rng(9);
+
+    constexpr U64     size = 5000;
+    BitArray          a(size), b(size / 2);
+    std::vector<bool> ma(size), mb(size);
+    for (U64 i = 0; i < size; ++i)
+    {
+        if (rng() % 3 == 0)
+            a.set(i), ma[i] = true;
+        if (i < size / 2 && rng() % 2 == 0)
+            b.set(i), mb[i] = true;
+    }
+
+    const auto expectEqual = [](const BitArray& bits, const std::vector<bool>& model)
+    {
+        U64 expected = 0;
+        for (U64 i = 0; i < model.size(); ++i)
+        {
+            EXPECT_EQ(bits.get(i), model[i]);
+            expected += model[i] ? 1 : 0;
+        }
+        EXPECT_EQ(bits.count(), expected);
+    };
+
+    BitArray r = a;
+    r |= b;
+    std::vector<bool> mr(size);
+    for (U64 i = 0; i < size; ++i)
+        mr[i] = ma[i] || mb[i];
+    expectEqual(r, mr);
+
+    r = a;
+    r &= b;
+    for (U64 i = 0; i < size; ++i)
+        mr[i] = ma[i] && mb[i];
+    expectEqual(r, mr);
+
+    r = a;
+    r ^= b;
+    for (U64 i = 0; i < size; ++i)
+        mr[i] = ma[i] != mb[i];
+    expectEqual(r, mr);
+
+    r = a;
+    r.andNot(b);
+    for (U64 i = 0; i < size; ++i)
+        mr[i] = ma[i] && !mb[i];
+    expectEqual(r, mr);
+
+    // Every dispatch level must agree.
+    const U64 count = a.count();
+    for (int level = SIMD_SCALAR; level <= SIMD_AVX2; ++level)
+    {
+        Cpu::setLevel((SimdLevel)level);
+        EXPECT_EQ(a.count(), count);
+    }
+    Cpu::setLevel(SIMD_AVX2);
+}
+
+GTEST_TEST(Utils, DenseIdSet_001)
+{
+    DenseIdSet ids(64);
+    EXPECT_TRUE(ids.insert(5));
+    EXPECT_FALSE(ids.insert(5));
+    EXPECT_TRUE(ids.insert(1000));
+    EXPECT_EQ(ids.size(), 2);
+    EXPECT_TRUE(ids.contains(1000));
+    EXPECT_FALSE(ids.contains(999));
+    EXPECT_FALSE(ids.contains(100000));
+    EXPECT_EQ(ids.find(5), 5);
+    EXPECT_EQ(ids.find(6), Npos);
+
+    DenseIdSet other;
+    other.insert(5);
+    other.insert(7);
+
+    DenseIdSet merged = ids;
+    merged |= other;
+    EXPECT_EQ(merged.size(), 3);
+
+    merged -= other;
+    EXPECT_EQ(merged.size(), 1);
+    EXPECT_TRUE(merged.contains(1000));
+
+    ids &= other;
+    EXPECT_EQ(ids.size(), 1);
+
+    U32 sum = 0;
+    other.forEach([&sum](const U32 id)
+                  { sum += id; });
+    EXPECT_EQ(sum, 12);
+
+    EXPECT_TRUE(other.erase(7));
+    EXPECT_FALSE(other.erase(7));
+    other.clear();
+    EXPECT_TRUE(other.empty());
+}
+
+GTEST_TEST(Utils, Columns_001)
+{
+    using Particles = Columns<float, float, U32>;
+
+    Particles ps;
+    EXPECT_TRUE(ps.empty());
+
+    for (U32 i = 0; i < 100; ++i)
+        EXPECT_EQ(ps.push_back(float(i), float(i) * 0.5f, i), i);
+    EXPECT_EQ(ps.size(), 100);
+
+    EXPECT_EQ(size_t(ps.column<0>().data()) % Particles::Alignment, 0);
+    EXPECT_EQ(size_t(ps.column<1>().data()) % Particles::Alignment, 0);
+    EXPECT_EQ(size_t(ps.column<2>().data()) % Particles::Alignment, 0);
+
+    float sum = 0;
+    for (const float x : ps.column<0>())
+        sum += x;
+    EXPECT_FLOAT_EQ(sum, 4950.f);
+
+    for (float& y : ps.column<1>())
+        y *= 2;
+    EXPECT_FLOAT_EQ(ps.at<1>(10), 10.f);
+
+    Particles::Row row = ps[7];
+    row.get<2>()       = 700;
+    EXPECT_EQ(ps.at<2>(7), 700);
+    EXPECT_EQ(ps.values(7), std::make_tuple(7.f, 7.f, 700u));
+
+    // unordered: the last row moves into the hole
+    ps.remove(3);
+    EXPECT_EQ(ps.size(), 99);
+    EXPECT_EQ(ps.at<2>(3), 99);
+    EXPECT_FLOAT_EQ(ps.at<0>(3), 99.f);
+
+    ps.removeOrdered(0);
+    EXPECT_EQ(ps.size(), 98);
+    EXPECT_EQ(ps.at<2>(0), 1);
+    EXPECT_EQ(ps.at<2>(2), 99);
+    EXPECT_EQ(ps.at<2>(6), 700);
+
+    EXPECT_THROW(ps.remove(98), Exception);
+
+    ps.clear();
+    EXPECT_TRUE(ps.empty());
+    ps.reserve(1000);
+    EXPECT_GT(ps.capacity(), 1000u);
+    EXPECT_EQ(ps.size(), 0);
+}
+
+GTEST_TEST(Utils, Columns_002)
+{
+    using Table = Columns<String, U64>;
+    using Ref   = std::tuple<String, U64>;
+
+    std::mt19937     rng(9);
+    Table            table;
+    std::vector<Ref> ref;
+
+    for (int i = 0; i < 4000; ++i)
+    {
+        const U32 op = rng() % 4;
+        if (op != 0 || ref.empty())
+        {
+            const U64    v = rng();
+            const String s = std::to_string(v);
+            table.push_back(s, v);
+            ref.emplace_back(s, v);
+        }
+        else
+        {
+            const U32 r = U32(rng() % ref.size());
+            table.remove(r);
+            ref[r] = ref.back();
+            ref.pop_back();
+        }
+    }
+
+    ASSERT_EQ(table.size(), ref.size());
+    for (U32 i = 0; i < table.size(); ++i)
+    {
+        const Table::ConstRow row = ((const Table&)table)[i];
+        EXPECT_EQ(row.get<0>(), std::get<0>(ref[i]));
+        EXPECT_EQ(row.get<1>(), std::get<1>(ref[i]));
+        EXPECT_EQ(row.values(), ref[i]);
+    }
+
+    Table copy = table;
+    EXPECT_EQ(copy.size(), table.size());
+    EXPECT_EQ(copy.at<0>(0), table.at<0>(0));
+}
+
+GTEST_TEST(Utils, NumberFormat_001)
+{
+    char buf[NumberFormat::RealLength];
+
+    const auto integer = [&buf](const auto v)
+    {
+        return String(buf, NumberFormat::integer(buf, v));
+    };
+
+    EXPECT_EQ(integer(U64(0)), "0");
+    EXPECT_EQ(integer(U64(9)), "9");
+    EXPECT_EQ(integer(U64(10)), "10");
+    EXPECT_EQ(integer(U64(100)), "100");
+    EXPECT_EQ(integer(U64(12345)), "12345");
+    EXPECT_EQ(integer(std::numeric_limits<U64>::max()), "18446744073709551615");
+    EXPECT_EQ(integer(std::numeric_limits<I64>::min()), "-9223372036854775808");
+    EXPECT_EQ(integer(std::numeric_limits<I32>::min()), "-2147483648");
+    EXPECT_EQ(integer(I32(-7)), "-7");
+
+    std::mt19937_64 rng(3);
+    for (int i = 0; i < 10000; ++i)
+    {
+        const U64 v = rng() >> (rng() % 64);
+        EXPECT_EQ(integer(v), std::to_string(v));
+        EXPECT_EQ(integer(I64(v)), std::to_string(I64(v)));
+    }
+}
+
+GTEST_TEST(Utils, NumberFormat_002)
+{
+    char buf[NumberFormat::RealLength];
+
+    const auto real = [&buf](const auto v)
+    {
+        return String(buf, NumberFormat::real(buf, v));
+    };
+
+    EXPECT_EQ(real(0.0), "0");
+    EXPECT_EQ(real(-0.0), "-0");
+    EXPECT_EQ(real(0.1), "0.1");
+    EXPECT_EQ(real(0.1 + 0.2), "0.30000000000000004");
+    EXPECT_EQ(real(-1.5), "-1.5");
+    EXPECT_EQ(real(1234567.0), "1234567");
+    EXPECT_EQ(real(1e16), "10000000000000000");
+    EXPECT_EQ(real(1e17), "1e+17");
+    EXPECT_EQ(real(1e-4), "0.0001");
+    EXPECT_EQ(real(1.25e-5), "1.25e-05");
+    EXPECT_EQ(real(5e-324), "5e-324");
+    EXPECT_EQ(real(1.7976931348623157e308), "1.7976931348623157e+308");
+    EXPECT_EQ(real(std::numeric_limits<double>::infinity()), "inf");
+    EXPECT_EQ(real(-std::numeric_limits<double>::infinity()), "-inf");
+    EXPECT_EQ(real(std::numeric_limits<double>::quiet_NaN()), "nan");
+
+    EXPECT_EQ(real(0.1f), "0.1");
+    EXPECT_EQ(real(3.14159f), "3.14159");
+    EXPECT_EQ(real(16777216.f), "16777216");
+    EXPECT_EQ(real(1e-7f), "1e-07");
+
+    // printf output in a locale with a comma, or a longer, point
+    const auto classic = [](String text)
+    {
+        return String(text.data(), NumberFormat::classicPoint(text.data(), (U32)text.size()));
+    };
+    EXPECT_EQ(classic("1,5"), "1.5");
+    EXPECT_EQ(classic("-2,25e-05"), "-2.25e-05");
+    EXPECT_EQ(classic("3\xD9\xAB" "14"), "3.14");
+    EXPECT_EQ(classic("1.5"), "1.5");
+    EXPECT_EQ(classic("1e+06"), "1e+06");
+    EXPECT_EQ(classic("-inf"), "-inf");
+    EXPECT_EQ(classic("42"), "42");
+
+    // every finite value reads back exactly
+    std::mt19937_64 rng(5);
+    for (int i = 0; i < 100000; ++i)
+    {
+        const U64 bits = rng();
+
+        double d;
+        memcpy(&d, &bits, sizeof(double));
+        if (std::isfinite(d))
+        {
+            EXPECT_EQ(std::strtod(real(d).c_str(), nullptr), d);
+        }
+
+        float     f;
+        const U32 lo = U32(bits);
+        memcpy(&f, &lo, sizeof(float));
+        if (std::isfinite(f))
+        {
+            EXPECT_EQ(std::strtof(real(f).c_str(), nullptr), f);
+        }
+    }
+}
+
+GTEST_TEST(Utils, NumberParse_001)
+{
+    const auto parse = [](const char* str, auto& v, const int base = 10)
+    {
+        return NumberParse::integer(str, str + strlen(str), v, base);
+    };
+
+    U64         u = 7;
+    I64         i = 7;
+    const char* s = "12345678901234567890x";
+
+    ParseResult r = parse(s, u);
+    EXPECT_TRUE(r.ok());
+    EXPECT_EQ(u, 12345678901234567890u);
+    EXPECT_EQ(r.end, s + 20);
+
+    r = NumberParse::integer(s, s + 3, u);
+    EXPECT_TRUE(r.ok());
+    EXPECT_EQ(u, 123u);
+
+    r = parse(s, i);
+    EXPECT_EQ(r.error, PE_RANGE);
+    EXPECT_EQ(i, std::numeric_limits<I64>::max());
+    EXPECT_EQ(r.end, s + 20);
+
+    r = parse("-9223372036854775808", i);
+    EXPECT_TRUE(r.ok());
+    EXPECT_EQ(i, std::numeric_limits<I64>::min());
+
+    r = parse("-9223372036854775809", i);
+    EXPECT_EQ(r.error, PE_RANGE);
+    EXPECT_EQ(i, std::numeric_limits<I64>::min());
+
+    r = parse("18446744073709551616", u);
+    EXPECT_EQ(r.error, PE_RANGE);
+    EXPECT_EQ(u, std::numeric_limits<U64>::max());
+
+    u = 7;
+    s = "-1";
+    r = parse(s, u);
+    EXPECT_EQ(r.error, PE_INVALID);
+    EXPECT_EQ(r.end, s);
+    EXPECT_EQ(u, 7u);
+
+    EXPECT_EQ(parse("+1", i).error, PE_INVALID);
+    EXPECT_EQ(parse(" 1", i).error, PE_INVALID);
+    EXPECT_EQ(parse("-", i).error, PE_INVALID);
+    EXPECT_EQ(parse("", i).error, PE_INVALID);
+    EXPECT_EQ(NumberParse::integer(nullptr, nullptr, i).error, PE_INVALID);
+
+    EXPECT_TRUE(parse("ffFF", u, 16).ok());
+    EXPECT_EQ(u, 0xFFFFu);
+    EXPECT_TRUE(parse("-777", i, 8).ok());
+    EXPECT_EQ(i, -0777);
+    EXPECT_TRUE(parse("zz", u, 36).ok());
+    EXPECT_EQ(u, 35u * 36 + 35);
+    EXPECT_EQ(parse("1", u, 37).error, PE_INVALID);
+
+    // every length around the eight digit blocks
+    std::mt19937_64 rng(11);
+    for (int i0 = 0; i0 < 10000; ++i0)
+    {
+        const U64    v   = rng() >> (rng() % 64);
+        const String str = std::to_string(v) + "e";
+
+        r = parse(str.c_str(), u);
+        EXPECT_TRUE(r.ok());
+        EXPECT_EQ(u, v);
+        EXPECT_EQ(*r.end, 'e');
+    }
+}
+
+GTEST_TEST(Utils, NumberParse_002)
+{
+    const auto parse = [](const String& str, auto& v)
+    {
+        return NumberParse::real(str.data(), str.data() + str.size(), v);
+    };
+
+    double d = 0;
+    float  f = 0;
+
+    EXPECT_TRUE(parse("0.1", d).ok());
+    EXPECT_EQ(d, 0.1);
+    EXPECT_TRUE(parse("-1.5e3,", d).ok());
+    EXPECT_EQ(d, -1500.0);
+    EXPECT_TRUE(parse(".5", d).ok());
+    EXPECT_EQ(d, 0.5);
+    EXPECT_TRUE(parse("5.", d).ok());
+    EXPECT_EQ(d, 5.0);
+
+    const String trailing = "12e";
+    ParseResult  r        = parse(trailing, d);
+    EXPECT_TRUE(r.ok());
+    EXPECT_EQ(d, 12.0);
+    EXPECT_EQ(r.end, trailing.data() + 2);
+
+    EXPECT_TRUE(parse("-0", d).ok());
+    EXPECT_TRUE(std::signbit(d));
+    EXPECT_TRUE(parse("inf", d).ok());
+    EXPECT_TRUE(std::isinf(d));
+    EXPECT_TRUE(parse("-Infinity", d).ok());
+    EXPECT_LT(d, 0);
+    EXPECT_TRUE(parse("nan", d).ok());
+    EXPECT_TRUE(std::isnan(d));
+
+    EXPECT_EQ(parse("1e400", d).error, PE_RANGE);
+    EXPECT_TRUE(std::isinf(d));
+    EXPECT_EQ(parse("1e39", f).error, PE_RANGE);
+    EXPECT_TRUE(parse("1e-400", d).ok());
+    EXPECT_EQ(d, 0.0);
+
+    d = 3;
+    EXPECT_EQ(parse(".", d).error, PE_INVALID);
+    EXPECT_EQ(parse("+1", d).error, PE_INVALID);
+    EXPECT_EQ(parse("e5", d).error, PE_INVALID);
+    EXPECT_EQ(d, 3.0);
+
+    // long inputs that need every digit to round correctly
+    EXPECT_TRUE(parse("9007199254740993", d).ok());
+    EXPECT_EQ(d, 9007199254740992.0);
+    EXPECT_TRUE(parse("9007199254740993.0000000000000000001", d).ok());
+    EXPECT_EQ(d, 9007199254740994.0);
+    EXPECT_TRUE(parse("2.2250738585072011e-308", d).ok());
+    EXPECT_EQ(d, std::strtod("2.2250738585072011e-308", nullptr));
+
+    std::mt19937_64 rng(13);
+
+    char buf[64];
+    for (int i = 0; i < 100000; ++i)
+    {
+        const U64 bits = rng();
+
+        double v;
+        memcpy(&v, &bits, sizeof(double));
+        if (std::isfinite(v))
+        {
+            snprintf(buf, sizeof buf, "%.*g", int(rng() % 17) + 1, v);
+            EXPECT_TRUE(parse(buf, d).ok() || std::isinf(d));
+            EXPECT_EQ(d, std::strtod(buf, nullptr));
+        }
+
+        float     g;
+        const U32 lo = U32(bits);
+        memcpy(&g, &lo, sizeof(float));
+        if (std::isfinite(g))
+        {
+            snprintf(buf, sizeof buf, "%.*g", int(rng() % 9) + 1, g);
+            EXPECT_TRUE(parse(buf, f).ok() || std::isinf(f));
+            EXPECT_EQ(f, std::strtof(buf, nullptr));
+        }
+    }
+}
+
+GTEST_TEST(Utils, StringScan_001)
+{
+    // Every level must agree with the standard library on random text
+    // that is dense in separators, white space and control bytes.
+    std::mt19937_64 rng(17);
+
+    const char alphabet[] = "ab, \t\r\n\x01\x80";
+
+    for (int round = 0; round < 400; ++round)
+    {
+        String text;
+        for (size_t i = 0, n = rng() % 300; i < n; ++i)
+            text.push_back(alphabet[rng() % (sizeof alphabet - 1)]);
+
+        const String pattern = text.substr(rng() % (text.size() + 1), rng() % 5);
+
+        const char* first = text.data();
+        const char* last  = first + text.size();
+
+        const size_t ch      = text.find(',');
+        const size_t pos     = text.find(pattern);
+        const size_t notWs   = text.find_first_not_of(" \t\r\n");
+        const size_t lastWs  = text.find_last_not_of(" \t\r\n");
+        size_t       control = 0;
+        while (control < text.size() && U8(text[control]) >= 32 && U8(text[control]) < 128)
+            ++control;
+
+        for (int level = SIMD_SCALAR; level <= SIMD_AVX2; ++level)
+        {
+            Cpu::setLevel((SimdLevel)level);
+
+            EXPECT_EQ(StringScan::find(first, last, ','), ch == String::npos ? last : first + ch);
+            EXPECT_EQ(StringScan::find(first, last, pattern.data(), pattern.size()),
+                      pos == String::npos ? last : first + pos);
+            EXPECT_EQ(StringScan::skipWs(first, last),
+                      notWs == String::npos ? last : first + notWs);
+            EXPECT_EQ(StringScan::skipWsReverse(first, last),
+                      lastWs == String::npos ? first : first + lastWs + 1);
+            EXPECT_EQ(StringScan::findControl(first, last), first + control);
+        }
+    }
+    Cpu::setLevel(SIMD_AVX2);
+}
+
+GTEST_TEST(Utils, StringScan_002)
+{
+    std::mt19937_64 rng(23);
+
+    constexpr ByteRange ranges[] = {{'0', '9'}, {'a', 'f'}, {0x80, 0xFF}};
+    for (int round = 0; round < 400; ++round)
+    {
+        String text;
+        for (size_t i = 0, n = rng() % 300; i < n; ++i)
+            text.push_back(rng() % 4 ? char('0' + rng() % 64) : char(rng()));
+
+        const size_t max = rng() % 2 ? text.size() : rng() % 100;
+
+        String expected, lower = text;
+        for (const char ch : text)
+        {
+            if (expected.size() < max && (isDecimal(ch) || (ch >= 'a' && ch <= 'f') || ch < 0))
+                expected.push_back(ch);
+        }
+        for (char& ch : lower)
+            ch = isUpper(ch) ? char(ch + 32) : ch;
+
+        for (int level = SIMD_SCALAR; level <= SIMD_AVX2; ++level)
+        {
+            Cpu::setLevel((SimdLevel)level);
+
+            String copied(text.size(), 0);
+            copied.resize(StringScan::copyIf(copied.data(), text.data(), text.data() + text.size(), ranges, 3, max));
+            EXPECT_EQ(copied, expected);
+
+            String converted = text;
+            StringScan::toLower(converted.data(), converted.data(), converted.data() + converted.size());
+            EXPECT_EQ(converted, lower);
+        }
+    }
+    Cpu::setLevel(SIMD_AVX2);
+}
+
+GTEST_TEST(Utils, MultiMatcher_001)
+{
+    const MultiMatcher matcher = {
+        {"he", "1"},
+        {"she", "2"},
+        {"his", "3"},
+        {"hers", "4"},
+    };
+    EXPECT_TRUE(matcher.compiled());
+    EXPECT_EQ(matcher.size(), 4);
+
+    // leftmost first, then longest, without overlapping
+    MultiMatches matches;
+    EXPECT_EQ(matcher.findAll(matches, "ushers and his shed"), 3);
+    ASSERT_EQ(matches.size(), 3);
+    EXPECT_EQ(matches[0].offset, 1);
+    EXPECT_EQ(matches[0].length, 3);
+    EXPECT_EQ(matches[0].pattern, 1);
+    EXPECT_EQ(matches[1].offset, 11);
+    EXPECT_EQ(matches[1].pattern, 2);
+    EXPECT_EQ(matches[2].offset, 15);
+    EXPECT_EQ(matches[2].pattern, 1);
+
+    String out;
+    EXPECT_EQ(matcher.replaceAll(out, "ushers and his shed"), 3);
+    EXPECT_EQ(out, "u2rs and 3 2d");
+    EXPECT_EQ(matcher.replaceAll(out, "hershey"), 2);
+    EXPECT_EQ(out, "41y");
+    EXPECT_EQ(matcher.replaceAll(out, "nothing"), 0);
+    EXPECT_EQ(out, "nothing");
+
+    EXPECT_TRUE(matcher.containsAny("the"));
+    EXPECT_FALSE(matcher.containsAny("abc"));
+    EXPECT_FALSE(matcher.containsAny(""));
+
+    MultiMatcher lazy;
+    lazy.add("x");
+    EXPECT_THROW(lazy.containsAny("x"), Exception);
+    EXPECT_THROW(lazy.add(""), Exception);
+    lazy.compile();
+
+    out = "x-x-x";
+    EXPECT_EQ(lazy.replaceAll(out), 3);
+    EXPECT_EQ(out, "--");
+}
+
+GTEST_TEST(Utils, MultiMatcher_002)
+{
+    EXPECT_EQ(FileSystem::sanitize("a\\\\b\\c//d///e"), "a/b/c/d//e");
+    EXPECT_EQ(FileSystem::unixPath(String("  C:\\\\a\\b\t")), "C://a/b");
+    EXPECT_EQ(FileSystem::unixPath(String("\\\\server\\share")), "//server/share");
+
+    StringArray lines;
+    Su::splitLine(lines, "a\r\nb\nc\r\rd");
+    ASSERT_EQ(lines.size(), 4);
+    EXPECT_EQ(lines[3], "d");
+
+    // matches the chained single pattern replacement
+    std::mt19937 rng(5);
+    for (int i = 0; i < 1000; ++i)
+    {
+        String path;
+        for (int j = 0, n = (int)(rng() % 24); j < n; ++j)
+            path.push_back("ab/\\"[rng() % 4]);
+
+        String swapped, expected;
+        Su::replaceAll(swapped, path, "\\", "/");
+        Su::replaceAll(expected, swapped, "//", "/");
+        EXPECT_EQ(FileSystem::sanitize(path), expected);
+    }
+}
+
+GTEST_TEST(Utils, StringTable_001)
+{
+    StringTable table = {"pear", "", "apple", "fig"};
+    EXPECT_EQ(table.size(), 4);
+    EXPECT_EQ(table.bytes(), 12);
+    EXPECT_EQ(table[2], "apple");
+    EXPECT_EQ(table.back(), "fig");
+    EXPECT_THROW(table.at(4), Exception);
+
+    EXPECT_EQ(table.append("banana"), 4);
+    table.sort();
+
+    const StringArray sorted = {"", "apple", "banana", "fig", "pear"};
+    EXPECT_EQ(table.toArray(), sorted);
+
+    table.sort([](const StringView& a, const StringView& b)
+               { return a.size() > b.size(); });
+    EXPECT_EQ(table.front(), "banana");
+
+    StringArray moved = {"first"};
+    table.moveTo(moved);
+    EXPECT_TRUE(table.empty());
+    EXPECT_EQ(table.bytes(), 0);
+    ASSERT_EQ(moved.size(), 6);
+    EXPECT_EQ(moved[0], "first");
+    EXPECT_EQ(moved[1], "banana");
+}
+
+GTEST_TEST(Utils, StringTable_002)
+{
+    std::mt19937 rng(11);
+    for (int i = 0; i < 200; ++i)
+    {
+        String input;
+        for (int j = 0, n = (int)(rng() % 200); j < n; ++j)
+            input.push_back(" ab,,c\t"[rng() % 7]);
+
+        StringArray expected;
+        StringTable table;
+        Su::split(expected, input, ',');
+        Su::split(table, input, ',');
+        EXPECT_EQ(table.toArray(), expected);
+
+        expected.clear();
+        table.clear();
+        Su::splitRejectEmpty(expected, input, ',');
+        Su::splitRejectEmpty(table, input, ',');
+        EXPECT_EQ(table.toArray(), expected);
+
+        size_t index = 0;
+        for (const StringView str : table)
+            EXPECT_EQ(str, expected[index++]);
+        EXPECT_EQ(index, expected.size());
+    }
+}
+
+GTEST_TEST(Utils, Base64_001)
+{
+    EXPECT_EQ(Base64::encode(""), "");
+    EXPECT_EQ(Base64::encode("f"), "Zg==");
+    EXPECT_EQ(Base64::encode("fo"), "Zm8=");
+    EXPECT_EQ(Base64::encode("foobar"), "Zm9vYmFy");
+    EXPECT_EQ(Base64::encode("\xFB\xFF"), "+-8=");
+
+    // zero bytes and the last two symbols survive a round trip
+    const String binary("\0a\0\xFB\xFF\0", 6);
+    EXPECT_EQ(Base64::decode(Base64::encode(binary)), binary);
+
+    String dest = "x";
+    EXPECT_FALSE(Base64::decode(dest, "Zm9"));
+    EXPECT_FALSE(Base64::decode(dest, "Zm/v"));
+    EXPECT_FALSE(Base64::decode(dest, "Zg==Zg=="));
+    EXPECT_EQ(dest, "x");
+    EXPECT_TRUE(Base64::decode(dest, "Zm8="));
+    EXPECT_EQ(dest, "xfo");
+
+    std::mt19937 rng(13);
+    for (int i = 0; i < 200; ++i)
+    {
+        String blob;
+        for (int j = 0, n = (int)(rng() % 300); j < n; ++j)
+            blob.push_back((char)rng());
+
+        String expected;
+        Cpu::setLevel(SIMD_SCALAR);
+        Base64::encode(expected, blob);
+        EXPECT_EQ(expected.size(), Base64::encodedSize(blob.size()));
+        EXPECT_EQ(Base64::decodedSize(expected.data(), expected.size()), blob.size());
+
+        for (int level = SIMD_SCALAR; level <= SIMD_AVX2; ++level)
+        {
+            Cpu::setLevel((SimdLevel)level);
+            EXPECT_EQ(Base64::encode(blob), expected);
+            EXPECT_EQ(Base64::decode(expected), blob);
+        }
+
+        // the same through the streams, in uneven pieces
+        OutputStringStream encoded;
+        Base64Encoder      encoder(encoded);
+        for (size_t at = 0, step; at < blob.size(); at += step)
+        {
+            step = Min<size_t>(rng() % 7, blob.size() - at);
+            encoder.write(blob.data() + at, step);
+        }
+        encoder.finish();
+        EXPECT_EQ(encoded.str(), expected);
+
+        OutputStringStream decoded;
+        InputStringStream  input(expected);
+        EXPECT_TRUE(Base64Decoder::decode(decoded, input));
+        EXPECT_EQ(decoded.str(), blob);
+    }
+    Cpu::setLevel(SIMD_AVX2);
+}
+
+GTEST_TEST(Utils, HexCodec_001)
+{
+    String hex;
+    HexCodec::encode(hex, "\x00\x7F\xAB\xFF", 4);
+    EXPECT_EQ(hex, "007FABFF");
+
+    String bytes;
+    EXPECT_TRUE(HexCodec::decode(bytes, "007fAbFF"));
+    EXPECT_EQ(bytes, String("\x00\x7F\xAB\xFF", 4));
+    EXPECT_FALSE(HexCodec::decode(bytes, "0"));
+    EXPECT_FALSE(HexCodec::decode(bytes, "0g"));
+    EXPECT_EQ(bytes.size(), 4);
+
+    std::mt19937 rng(17);
+    for (int i = 0; i < 200; ++i)
+    {
+        String blob;
+        for (int j = 0, n = (int)(rng() % 300); j < n; ++j)
+            blob.push_back((char)rng());
+
+        String expected;
+        for (const char ch : blob)
+            expected.append(Char::toHexString((uint8_t)ch));
+
+        for (int level = SIMD_SCALAR; level <= SIMD_AVX2; ++level)
+        {
+            Cpu::setLevel((SimdLevel)level);
+
+            String encoded;
+            Char::toHexString(encoded, blob.data(), blob.size());
+            EXPECT_EQ(encoded, expected);
+
+            String decoded;
+            EXPECT_TRUE(HexCodec::decode(decoded, encoded));
+            EXPECT_EQ(decoded, blob);
+
+            if (!encoded.empty())
+            {
+                encoded[rng() % encoded.size()] = 'x';
+                EXPECT_FALSE(HexCodec::decode(decoded, encoded));
+            }
+        }
+    }
+    Cpu::setLevel(SIMD_AVX2);
+}
+
+GTEST_TEST(Utils, HexCodec_002)
+{
+    const String text = "Hex dump\tof 0123456789 \xFF!";
+
+    OutputStringStream oss;
+    Console::hexdump(oss, text.data(), (uint32_t)text.size());
+    EXPECT_EQ(oss.str(),
+              "48 65 78 20 64 75 6D 70  09 6F 66 20 30 31 32 33 |Hex dump.of 0123|\n"
+              "34 35 36 37 38 39 20 FF  21 00 00 00 00 00 00 00 |456789 .!.......|\n");
+    EXPECT_EQ(oss.str().size(), HexCodec::dumpSize(text.size()));
+
+    // large inputs are written in blocks
+    String blob(100000, 0);
+    for (size_t i = 0; i < blob.size(); ++i)
+        blob[i] = (char)(i * 7);
+
+    String expected(HexCodec::dumpSize(blob.size()), 0);
+    expected.resize(HexCodec::dump(expected.data(), blob.data(), blob.size()));
+
+    oss.str("");
+    HexCodec::dump(oss, blob.data(), blob.size());
+    EXPECT_EQ(oss.str(), expected);
+}
@@ -22,6 +22,7 @@
 #pragma once
 #include <cstdint>
 #include <cstdlib>
+#include <new>
 #include "Utils/Definitions.h"
 #include "Utils/Exception.h"
 
@@ -200,6 +201,93 @@ namespace Rt2
         }
     };
 
+    /**
+     * \brief Array allocator that places the first element on an
+     * Alignment byte boundary.
+     *
+     * The element count is stored in a header that sits in the Alignment
+     * bytes in front of the array, so that the array can be destroyed
+     * without relying on the capacity that the caller passes back.
+     */
+    template <typename Type,
+              typename Size        = size_t,
+              const Size Alignment = 64,
+              const Size Limit     = MakeLimit<Size>()>
+    class AlignedAllocator : public AllocBase<Type, Size, Limit>
+    {
+    public:
+        using ValueType          = Type;
+        using ReferenceType      = Type&;
+        using PointerType        = Type*;
+        using ConstValueType     = const Type;
+        using ConstPointerType   = const Type*;
+        using ConstReferenceType = const Type&;
+        using SelfType           = AlignedAllocator<Type, Size, Alignment, Limit>;
+
+        static_assert(Alignment >= alignof(Type) && Alignment >= sizeof(Size),
+                      "alignment is too small for the element or header type");
+        static_assert((Alignment & (Alignment - 1)) == 0,
+                      "alignment must be a power of two");
+
+        AlignedAllocator() = default;
+
+        AlignedAllocator(const SelfType&) = default;
+
+        ~AlignedAllocator() = default;
+
+        PointerType allocateArray(Size capacity)
+        {
+            enforce<Size, Limit>(capacity);
+
+            const size_t bytes = size_t(capacity) * sizeof(Type) + Alignment;
+
+            uint8_t* base = (uint8_t*)::operator new(bytes, std::align_val_t(Alignment));
+            *(Size*)base  = capacity;
+
+            PointerType ptr = (PointerType)(base + Alignment);
+            this->construct(ptr, ptr + capacity);
+            return ptr;
+        }
+
+        PointerType allocateArray(Size capacity, const Type& initial)
+        {
+            PointerType ptr = allocateArray(capacity);
+            this->fill(ptr, initial, capacity);
+            return ptr;
+        }
+
+        PointerType reallocateArray(PointerType pointer,
+                                    Size        newCap,
+                                    Size        oldCap,
+                                    const bool  simple = false)
+        {
+            auto base = allocateArray(newCap);
+            if (pointer)
+            {
+                oldCap = Min<Size>(oldCap, newCap);
+                if (simple)
+                    this->copy(base, pointer, oldCap);
+                else
+                    this->fill(base, pointer, oldCap);
+                deallocateArray(pointer, oldCap);
+            }
+            return base;
+        }
+
+        static void deallocateArray(const ConstPointerType pointer, Size)
+        {
+            if (pointer)
+            {
+                uint8_t* base = (uint8_t*)pointer - Alignment;
+
+                PointerType beg = (PointerType)pointer;
+                AllocBase<Type, Size, Limit>::destroy(beg, beg + *(Size*)base);
+
+                ::operator delete(base, std::align_val_t(Alignment));
+            }
+        }
+    };
+
     template <typename Type, typename Size = size_t, const Size Limit = MakeLimit<Size>()>
     using Allocator = NewAllocator<Type, Size, Limit>;
 
@@ -182,7 +182,7 @@ namespace Rt2
             {
                 if (nr > _size)
                     reserve(nr);
-                _alloc.fill(_data + _size, fill, nr);
+                _alloc.fill(_data + _size, fill, nr - _size);
             }
             _size = nr;
         }
@@ -273,6 +273,16 @@ namespace Rt2
             return _size > 0;
         }
 
+        /**
+         * \brief Exchanges the storage of the two arrays without copying elements.
+         */
+        void swap(SelfType& rhs)
+        {
+            Swap(_data, rhs._data);
+            Swap(_size, rhs._size);
+            Swap(_capacity, rhs._capacity);
+        }
+
         template <typename P, size_t Align = sizeof(P)>
         const P* cast()
         {
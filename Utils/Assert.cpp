@@ -26,21 +26,39 @@
 #include "Utils/Allocator.h"
 #include "Utils/Array.h"
 #include "Utils/ArrayBase.h"
+#include "Utils/BTreeMap.h"
+#include "Utils/BitArray.h"
+#include "Utils/Bits.h"
+#include "Utils/BoundedCache.h"
 #include "Utils/Char.h"
+#include "Utils/Columns.h"
 #include "Utils/Console.h"
+#include "Utils/Cpu.h"
 #include "Utils/Definitions.h"
 #include "Utils/Exception.h"
 #include "Utils/FileSystem.h"
+#include "Utils/Filter.h"
 #include "Utils/FixedArray.h"
 #include "Utils/FixedString.h"
+#include "Utils/FlatMap.h"
 #include "Utils/Hash.h"
 #include "Utils/HashMap.h"
+#include "Utils/HexCodec.h"
 #include "Utils/IndexCache.h"
+#include "Utils/MultiMatcher.h"
+#include "Utils/NumberFormat.h"
+#include "Utils/NumberParse.h"
 #include "Utils/Path.h"
 #include "Utils/Set.h"
+#include "Utils/SlotMap.h"
+#include "Utils/SplitView.h"
 #include "Utils/Stack.h"
 #include "Utils/String.h"
+#include "Utils/StringInterner.h"
+#include "Utils/StringScan.h"
+#include "Utils/StringTable.h"
 #include "Utils/TextStreamWriter.h"
+#include "Utils/TimerWheel.h"
 #include "Utils/Traits.h"
 // </including all headers intentionally>
 
@@ -0,0 +1,914 @@
+/*
+-------------------------------------------------------------------------------
+    Copyright (c) Charles Carley.
+
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+-------------------------------------------------------------------------------
+*/
+#pragma once
+
+#include <functional>
+#include "Utils/Array.h"
+#include "Utils/Definitions.h"
+#include "Utils/Exception.h"
+#include "Utils/ObjectPool.h"
+
+namespace Rt2
+{
+    /**
+     * \brief Ordered map implemented as a B+-tree.
+     *
+     * Every operation is iterative, so the depth of the tree is never bounded
+     * by the call stack and sorted input keeps the tree balanced.
+     * Entries are stored in leaves that are linked in key order for range
+     * iteration. Nodes come from object pools instead of individual
+     * allocations.
+     *
+     * \tparam NodeBytes The size in bytes of the key block searched in each
+     * node. The fanout of the tree is NodeBytes / sizeof(Key).
+     */
+    template <typename Key,
+              typename Value,
+              U16 NodeBytes = 256>
+    class BTreeMap
+    {
+    public:
+        static_assert(NodeBytes >= 64 && NodeBytes <= 256);
+
+        static constexpr U16 Order = NodeBytes / sizeof(Key) < 4
+                                         ? 4
+                                         : (U16)Min<size_t>(NodeBytes / sizeof(Key), 255);
+
+        static constexpr U16 MinKeys  = Order / 2;
+        static constexpr U16 MaxDepth = 48;
+
+        struct Pair
+        {
+            Key   key;
+            Value value;
+
+            bool operator<(const Pair& rhs) const { return key < rhs.key; }
+            bool operator>(const Pair& rhs) const { return rhs.key < key; }
+            bool operator==(const Pair& rhs) const { return !(key < rhs.key) && !(rhs.key < key); }
+        };
+
+        using Keys    = Array<Key>;
+        using Values  = Array<Value>;
+        using KvPairs = Array<Pair>;
+
+        using ValueCallback = std::function<int(const Value&)>;
+        using RangeCallback = std::function<int(const Key&, Value&)>;
+
+    private:
+        struct Node
+        {
+            U16  size{0};
+            bool leaf{true};
+        };
+
+        struct Leaf : Node
+        {
+            Key   keys[Order]{};
+            Value values[Order]{};
+            Leaf* next{nullptr};
+            Leaf* prev{nullptr};
+        };
+
+        struct Branch : Node
+        {
+            Key   keys[Order]{};
+            Node* children[Order + 1]{};
+
+            Branch() { this->leaf = false; }
+        };
+
+        using LeafPool   = ObjectPool<Leaf, 0x08>;
+        using BranchPool = ObjectPool<Branch, 0x08>;
+        using NodeStack  = SimpleArray<Node*>;
+
+        LeafPool   _leaves;
+        BranchPool _branches;
+        Node*      _root{nullptr};
+        Leaf*      _first{nullptr};
+        Leaf*      _last{nullptr};
+        size_t     _size{0};
+
+    public:
+        class Iterator
+        {
+        private:
+            friend class BTreeMap;
+
+            Leaf* _leaf{nullptr};
+            U16   _idx{0};
+
+            Iterator(Leaf* leaf, const U16 idx) :
+                _leaf(leaf),
+                _idx(idx)
+            {
+                normalize();
+            }
+
+            void normalize()
+            {
+                // Moves past the end of a leaf onto the next one.
+                while (_leaf && _idx >= _leaf->size)
+                {
+                    _leaf = _leaf->next;
+                    _idx  = 0;
+                }
+            }
+
+        public:
+            Iterator() = default;
+
+            bool valid() const { return _leaf != nullptr; }
+
+            const Key& key() const
+            {
+                RT_ASSERT(_leaf)
+                return _leaf->keys[_idx];
+            }
+
+            Value& value() const
+            {
+                RT_ASSERT(_leaf)
+                return _leaf->values[_idx];
+            }
+
+            Value& operator*() const { return value(); }
+
+            Iterator& operator++()
+            {
+                if (_leaf)
+                {
+                    ++_idx;
+                    normalize();
+                }
+                return *this;
+            }
+
+            Iterator& operator--()
+            {
+                if (_leaf)
+                {
+                    if (_idx > 0)
+                        --_idx;
+                    else
+                    {
+                        _leaf = _leaf->prev;
+                        _idx  = _leaf ? _leaf->size - 1 : 0;
+                    }
+                }
+                return *this;
+            }
+
+            bool operator==(const Iterator& rhs) const
+            {
+                return _leaf == rhs._leaf && (_leaf == nullptr || _idx == rhs._idx);
+            }
+
+            bool operator!=(const Iterator& rhs) const
+            {
+                return !(*this == rhs);
+            }
+        };
+
+    public:
+        BTreeMap() = default;
+
+        BTreeMap(const BTreeMap& rhs) = delete;
+
+        ~BTreeMap()
+        {
+            clear();
+        }
+
+        void clear()
+        {
+            if (_root)
+            {
+                NodeStack stack;
+                stack.push_back(_root);
+                while (!stack.empty())
+                {
+                    Node* node = stack.back();
+                    stack.resizeFast(stack.size() - 1);
+
+                    if (!node->leaf)
+                    {
+                        const Branch* branch = (Branch*)node;
+                        for (U16 i = 0; i <= branch->size; ++i)
+                            stack.push_back(branch->children[i]);
+                        releaseBranch((Branch*)node);
+                    }
+                    else
+                        releaseLeaf((Leaf*)node);
+                }
+            }
+
+            _root  = nullptr;
+            _first = _last = nullptr;
+            _size          = 0;
+        }
+
+        /**
+         * \brief Inserts the key value pair if the key is not in the map.
+         * \return False if the key was already present.
+         */
+        bool insert(const Key& key, const Value& val)
+        {
+            return insertImpl(key, val, false);
+        }
+
+        /**
+         * \brief Inserts the key value pair or replaces the value of an existing key.
+         */
+        void assign(const Key& key, const Value& val)
+        {
+            insertImpl(key, val, true);
+        }
+
+        bool contains(const Key& key) const
+        {
+            return find(key) != nullptr;
+        }
+
+        const Value& get(const Key& key, const Value& error = {}) const
+        {
+            const Value* value = find(key);
+            return value ? *value : error;
+        }
+
+        Value* find(const Key& key) const
+        {
+            if (!_root)
+                return nullptr;
+
+            Leaf*     leaf = findLeaf(key);
+            const U16 pos  = lowerIndex(leaf->keys, leaf->size, key);
+            if (pos < leaf->size && !(key < leaf->keys[pos]))
+                return &leaf->values[pos];
+            return nullptr;
+        }
+
+        /**
+         * \return An iterator to the first entry with a key not less than key.
+         */
+        Iterator lowerBound(const Key& key) const
+        {
+            if (!_root)
+                return {};
+            Leaf* leaf = findLeaf(key);
+            return Iterator(leaf, lowerIndex(leaf->keys, leaf->size, key));
+        }
+
+        /**
+         * \return An iterator to the first entry with a key greater than key.
+         */
+        Iterator upperBound(const Key& key) const
+        {
+            if (!_root)
+                return {};
+            Leaf* leaf = findLeaf(key);
+            return Iterator(leaf, upperIndex(leaf->keys, leaf->size, key));
+        }
+
+        /**
+         * \brief Visits the entries in [lo, hi) in ascending order.
+         * Visiting stops when the callback returns a non zero value.
+         */
+        void range(const Key& lo, const Key& hi, const RangeCallback& callback) const
+        {
+            if (!callback)
+                return;
+
+            for (Iterator it = lowerBound(lo); it.valid() && it.key() < hi; ++it)
+            {
+                if (callback(it.key(), it.value()))
+                    break;
+            }
+        }
+
+        bool erase(const Key& key)
+        {
+            if (!_root)
+                return false;
+
+            Branch* path[MaxDepth];
+            U16     slots[MaxDepth];
+            U16     depth = 0;
+
+            Node* node = _root;
+            while (!node->leaf)
+            {
+                Branch*   branch = (Branch*)node;
+                const U16 i      = upperIndex(branch->keys, branch->size, key);
+                path[depth]      = branch;
+                slots[depth++]   = i;
+                node             = branch->children[i];
+            }
+
+            Leaf*     leaf = (Leaf*)node;
+            const U16 pos  = lowerIndex(leaf->keys, leaf->size, key);
+            if (pos >= leaf->size || key < leaf->keys[pos])
+                return false;
+
+            for (U16 i = pos + 1; i < leaf->size; ++i)
+            {
+                leaf->keys[i - 1]   = leaf->keys[i];
+                leaf->values[i - 1] = leaf->values[i];
+            }
+            --leaf->size;
+            leaf->keys[leaf->size]   = Key{};
+            leaf->values[leaf->size] = Value{};
+            --_size;
+
+            while (depth > 0 && node->size < MinKeys)
+            {
+                Branch*   parent = path[depth - 1];
+                const U16 i      = slots[depth - 1];
+
+                if (node->leaf)
+                {
+                    if (!rebalanceLeaf((Leaf*)node, parent, i))
+                        break;
+                }
+                else if (!rebalanceBranch((Branch*)node, parent, i))
+                    break;
+
+                node = parent;
+                --depth;
+            }
+
+            if (!_root->leaf && _root->size == 0)
+            {
+                Branch* old = (Branch*)_root;
+                _root       = old->children[0];
+                releaseBranch(old);
+            }
+            else if (_root->leaf && _root->size == 0)
+            {
+                releaseLeaf((Leaf*)_root);
+                _root  = nullptr;
+                _first = _last = nullptr;
+            }
+            return true;
+        }
+
+        /**
+         * \brief Replaces the contents of the map with the supplied entries in O(n).
+         * The keys must be in strictly ascending order and have the same length as values.
+         */
+        void build(const Keys& keys, const Values& values)
+        {
+            if (keys.size() != values.size())
+                throw Exception("key and value counts differ");
+
+            clear();
+
+            const size_t n = keys.size();
+            if (n == 0)
+                return;
+
+            for (size_t i = 1; i < n; ++i)
+            {
+                if (!(keys[(U32)(i - 1)] < keys[(U32)i]))
+                    throw Exception("build input is not in strictly ascending order");
+            }
+
+            // Spread the entries evenly so every leaf holds at least MinKeys.
+            NodeStack level;
+            Keys      lows;
+
+            const size_t leafCount = (n + Order - 1) / Order;
+
+            size_t at = 0;
+            Leaf*  prev{nullptr};
+            for (size_t l = 0; l < leafCount; ++l)
+            {
+                const size_t count = n / leafCount + (l < n % leafCount ? 1 : 0);
+
+                Leaf* leaf = _leaves.allocate();
+                for (size_t i = 0; i < count; ++i, ++at)
+                {
+                    leaf->keys[i]   = keys[(U32)at];
+                    leaf->values[i] = values[(U32)at];
+                }
+                leaf->size = (U16)count;
+                leaf->prev = prev;
+                if (prev)
+                    prev->next = leaf;
+                else
+                    _first = leaf;
+                prev = leaf;
+
+                level.push_back(leaf);
+                lows.push_back(leaf->keys[0]);
+            }
+            _last = prev;
+            _size = n;
+
+            while (level.size() > 1)
+            {
+                NodeStack upper;
+                Keys      upperLows;
+
+                const size_t children    = level.size();
+                const size_t branchCount = (children + Order) / (Order + 1);
+
+                size_t c = 0;
+                for (size_t b = 0; b < branchCount; ++b)
+                {
+                    const size_t count = children / branchCount + (b < children % branchCount ? 1 : 0);
+
+                    Branch* branch = _branches.allocate();
+                    upperLows.push_back(lows[(U32)c]);
+                    for (size_t i = 0; i < count; ++i, ++c)
+                    {
+                        branch->children[i] = level[(U32)c];
+                        if (i > 0)
+                            branch->keys[i - 1] = lows[(U32)c];
+                    }
+                    branch->size = (U16)(count - 1);
+                    upper.push_back(branch);
+                }
+
+                level = upper;
+                lows  = upperLows;
+            }
+
+            _root = level[0];
+        }
+
+        void build(const KvPairs& pairs)
+        {
+            Keys   keys((U32)pairs.size());
+            Values values((U32)pairs.size());
+            for (const Pair& pair : pairs)
+            {
+                keys.push_back(pair.key);
+                values.push_back(pair.value);
+            }
+            build(keys, values);
+        }
+
+        void keys(Keys& dest, const bool descending = false) const
+        {
+            dest.clear();
+            dest.reserve((U32)_size);
+            if (descending)
+            {
+                for (const Leaf* leaf = _last; leaf; leaf = leaf->prev)
+                    for (U16 i = leaf->size; i > 0; --i)
+                        dest.push_back(leaf->keys[i - 1]);
+            }
+            else
+            {
+                for (const Leaf* leaf = _first; leaf; leaf = leaf->next)
+                    for (U16 i = 0; i < leaf->size; ++i)
+                        dest.push_back(leaf->keys[i]);
+            }
+        }
+
+        void values(Values& dest, const bool descending = false) const
+        {
+            dest.clear();
+            dest.reserve((U32)_size);
+            values([&dest](const Value& v)
+                   {
+                       dest.push_back(v);
+                       return 0; },
+                   descending);
+        }
+
+        void values(const ValueCallback& dest, const bool descending = false) const
+        {
+            if (!dest)
+                return;
+
+            if (descending)
+            {
+                for (const Leaf* leaf = _last; leaf; leaf = leaf->prev)
+                    for (U16 i = leaf->size; i > 0; --i)
+                        if (dest(leaf->values[i - 1]))
+                            return;
+            }
+            else
+            {
+                for (const Leaf* leaf = _first; leaf; leaf = leaf->next)
+                    for (U16 i = 0; i < leaf->size; ++i)
+                        if (dest(leaf->values[i]))
+                            return;
+            }
+        }
+
+        void keyValuePairs(KvPairs& dest, const bool descending = false) const
+        {
+            dest.clear();
+            dest.reserve((U32)_size);
+            if (descending)
+            {
+                for (const Leaf* leaf = _last; leaf; leaf = leaf->prev)
+                    for (U16 i = leaf->size; i > 0; --i)
+                        dest.push_back({leaf->keys[i - 1], leaf->values[i - 1]});
+            }
+            else
+            {
+                for (const Leaf* leaf = _first; leaf; leaf = leaf->next)
+                    for (U16 i = 0; i < leaf->size; ++i)
+                        dest.push_back({leaf->keys[i], leaf->values[i]});
+            }
+        }
+
+        Iterator begin() const { return Iterator(_first, 0); }
+
+        Iterator end() const { return {}; }
+
+        Iterator minimum() const { return begin(); }
+
+        Iterator maximum() const
+        {
+            if (!_last)
+                return {};
+            return Iterator(_last, _last->size - 1);
+        }
+
+        size_t size() const { return _size; }
+
+        bool empty() const { return _size < 1; }
+
+        /**
+         * \return The number of levels in the tree, zero when it is empty.
+         */
+        U16 depth() const
+        {
+            U16 d = 0;
+            for (const Node* node = _root; node; ++d)
+                node = node->leaf ? nullptr : ((const Branch*)node)->children[0];
+            return d;
+        }
+
+    private:
+        static U16 lowerIndex(const Key* keys, const U16 size, const Key& key)
+        {
+            U16 lo = 0, hi = size;
+            while (lo < hi)
+            {
+                const U16 mid = (U16)((lo + hi) >> 1);
+                if (keys[mid] < key)
+                    lo = mid + 1;
+                else
+                    hi = mid;
+            }
+            return lo;
+        }
+
+        static U16 upperIndex(const Key* keys, const U16 size, const Key& key)
+        {
+            U16 lo = 0, hi = size;
+            while (lo < hi)
+            {
+                const U16 mid = (U16)((lo + hi) >> 1);
+                if (key < keys[mid])
+                    hi = mid;
+                else
+                    lo = mid + 1;
+            }
+            return lo;
+        }
+
+        Leaf* findLeaf(const Key& key) const
+        {
+            Node* node = _root;
+            while (!node->leaf)
+            {
+                const Branch* branch = (Branch*)node;
+                node                 = branch->children[upperIndex(branch->keys, branch->size, key)];
+            }
+            return (Leaf*)node;
+        }
+
+        void releaseLeaf(Leaf* leaf)
+        {
+            _leaves.free(leaf);
+        }
+
+        void releaseBranch(Branch* branch)
+        {
+            _branches.free(branch);
+        }
+
+        bool insertImpl(const Key& key, const Value& val, const bool replace)
+        {
+            if (!_root)
+            {
+                Leaf* leaf      = _leaves.allocate();
+                leaf->keys[0]   = key;
+                leaf->values[0] = val;
+                leaf->size      = 1;
+
+                _root = _first = _last = leaf;
+                _size                  = 1;
+                return true;
+            }
+
+            Branch* path[MaxDepth];
+            U16     slots[MaxDepth];
+            U16     depth = 0;
+
+            Node* node = _root;
+            while (!node->leaf)
+            {
+                Branch*   branch = (Branch*)node;
+                const U16 i      = upperIndex(branch->keys, branch->size, key);
+                path[depth]      = branch;
+                slots[depth++]   = i;
+                node             = branch->children[i];
+            }
+
+            Leaf*     leaf = (Leaf*)node;
+            const U16 pos  = lowerIndex(leaf->keys, leaf->size, key);
+            if (pos < leaf->size && !(key < leaf->keys[pos]))
+            {
+                if (replace)
+                    leaf->values[pos] = val;
+                return false;
+            }
+
+            ++_size;
+            if (leaf->size < Order)
+            {
+                insertAt(leaf, pos, key, val);
+                return true;
+            }
+
+            Key   separator;
+            Node* child = splitLeaf(leaf, pos, key, val, separator);
+
+            while (depth > 0)
+            {
+                Branch*   branch = path[--depth];
+                const U16 i      = slots[depth];
+
+                if (branch->size < Order)
+                {
+                    for (U16 j = branch->size; j > i; --j)
+                    {
+                        branch->keys[j]         = branch->keys[j - 1];
+                        branch->children[j + 1] = branch->children[j];
+                    }
+                    branch->keys[i]         = separator;
+                    branch->children[i + 1] = child;
+                    ++branch->size;
+                    return true;
+                }
+                child = splitBranch(branch, i, separator, child, separator);
+            }
+
+            Branch* root      = _branches.allocate();
+            root->keys[0]     = separator;
+            root->children[0] = _root;
+            root->children[1] = child;
+            root->size        = 1;
+            _root             = root;
+            return true;
+        }
+
+        static void insertAt(Leaf* leaf, const U16 pos, const Key& key, const Value& val)
+        {
+            for (U16 i = leaf->size; i > pos; --i)
+            {
+                leaf->keys[i]   = leaf->keys[i - 1];
+                leaf->values[i] = leaf->values[i - 1];
+            }
+            leaf->keys[pos]   = key;
+            leaf->values[pos] = val;
+            ++leaf->size;
+        }
+
+        Node* splitLeaf(Leaf* leaf, const U16 pos, const Key& key, const Value& val, Key& separator)
+        {
+            Leaf* right = _leaves.allocate();
+
+            constexpr U16 mid = Order / 2;
+            for (U16 i = mid; i < Order; ++i)
+            {
+                right->keys[i - mid]   = leaf->keys[i];
+                right->values[i - mid] = leaf->values[i];
+                leaf->keys[i]          = Key{};
+                leaf->values[i]        = Value{};
+            }
+            right->size = Order - mid;
+            leaf->size  = mid;
+
+            if (pos <= mid)
+                insertAt(leaf, pos, key, val);
+            else
+                insertAt(right, pos - mid, key, val);
+
+            right->next = leaf->next;
+            right->prev = leaf;
+            if (leaf->next)
+                leaf->next->prev = right;
+            else
+                _last = right;
+            leaf->next = right;
+
+            separator = right->keys[0];
+            return right;
+        }
+
+        Node* splitBranch(Branch*    branch,
+                          const U16  at,
+                          const Key& key,
+                          Node*      child,
+                          Key&       separator)
+        {
+            // Order + 1 keys and Order + 2 children after the insert.
+            Key   keys[Order + 1];
+            Node* children[Order + 2];
+
+            for (U16 i = 0, j = 0; i <= Order; ++i)
+                keys[i] = i == at ? key : branch->keys[j++];
+            for (U16 i = 0, j = 0; i <= Order + 1; ++i)
+                children[i] = i == at + 1 ? child : branch->children[j++];
+
+            constexpr U16 left = (Order + 1) / 2;
+
+            Branch* right = _branches.allocate();
+            for (U16 i = 0; i < left; ++i)
+            {
+                branch->keys[i]     = keys[i];
+                branch->children[i] = children[i];
+            }
+            branch->children[left] = children[left];
+            for (U16 i = left; i < Order; ++i)
+                branch->keys[i] = Key{};
+            branch->size = left;
+
+            const U16 count = Order - left;
+            for (U16 i = 0; i < count; ++i)
+            {
+                right->keys[i]     = keys[left + 1 + i];
+                right->children[i] = children[left + 1 + i];
+            }
+            right->children[count] = children[Order + 1];
+            right->size            = count;
+
+            separator = keys[left];
+            return right;
+        }
+
+        static void removeFromBranch(Branch* branch, const U16 keyIdx, const U16 childIdx)
+        {
+            for (U16 i = keyIdx + 1; i < branch->size; ++i)
+                branch->keys[i - 1] = branch->keys[i];
+            for (U16 i = childIdx + 1; i <= branch->size; ++i)
+                branch->children[i - 1] = branch->children[i];
+
+            --branch->size;
+            branch->keys[branch->size]         = Key{};
+            branch->children[branch->size + 1] = nullptr;
+        }
+
+        // Returns true if the parent lost an entry and may need rebalancing.
+        bool rebalanceLeaf(Leaf* leaf, Branch* parent, const U16 i)
+        {
+            Leaf* left  = i > 0 ? (Leaf*)parent->children[i - 1] : nullptr;
+            Leaf* right = i < parent->size ? (Leaf*)parent->children[i + 1] : nullptr;
+
+            if (left && left->size > MinKeys)
+            {
+                --left->size;
+                insertAt(leaf, 0, left->keys[left->size], left->values[left->size]);
+                left->keys[left->size]   = Key{};
+                left->values[left->size] = Value{};
+                parent->keys[i - 1]      = leaf->keys[0];
+                return false;
+            }
+
+            if (right && right->size > MinKeys)
+            {
+                leaf->keys[leaf->size]   = right->keys[0];
+                leaf->values[leaf->size] = right->values[0];
+                ++leaf->size;
+
+                for (U16 j = 1; j < right->size; ++j)
+                {
+                    right->keys[j - 1]   = right->keys[j];
+                    right->values[j - 1] = right->values[j];
+                }
+                --right->size;
+                right->keys[right->size]   = Key{};
+                right->values[right->size] = Value{};
+                parent->keys[i]            = right->keys[0];
+                return false;
+            }
+
+            if (left)
+            {
+                mergeLeaf(left, leaf);
+                removeFromBranch(parent, i - 1, i);
+            }
+            else if (right)
+            {
+                mergeLeaf(leaf, right);
+                removeFromBranch(parent, i, i + 1);
+            }
+            return true;
+        }
+
+        void mergeLeaf(Leaf* dest, Leaf* src)
+        {
+            for (U16 j = 0; j < src->size; ++j)
+            {
+                dest->keys[dest->size + j]   = src->keys[j];
+                dest->values[dest->size + j] = src->values[j];
+            }
+            dest->size += src->size;
+
+            dest->next = src->next;
+            if (src->next)
+                src->next->prev = dest;
+            else
+                _last = dest;
+            releaseLeaf(src);
+        }
+
+        bool rebalanceBranch(Branch* branch, Branch* parent, const U16 i)
+        {
+            Branch* left  = i > 0 ? (Branch*)parent->children[i - 1] : nullptr;
+            Branch* right = i < parent->size ? (Branch*)parent->children[i + 1] : nullptr;
+
+            if (left && left->size > MinKeys)
+            {
+                for (U16 j = branch->size; j > 0; --j)
+                    branch->keys[j] = branch->keys[j - 1];
+                for (U16 j = branch->size + 1; j > 0; --j)
+                    branch->children[j] = branch->children[j - 1];
+
+                branch->keys[0]     = parent->keys[i - 1];
+                branch->children[0] = left->children[left->size];
+                ++branch->size;
+
+                parent->keys[i - 1] = left->keys[left->size - 1];
+
+                left->children[left->size] = nullptr;
+                --left->size;
+                left->keys[left->size] = Key{};
+                return false;
+            }
+
+            if (right && right->size > MinKeys)
+            {
+                branch->keys[branch->size]         = parent->keys[i];
+                branch->children[branch->size + 1] = right->children[0];
+                ++branch->size;
+
+                parent->keys[i] = right->keys[0];
+                removeFromBranch(right, 0, 0);
+                return false;
+            }
+
+            if (left)
+            {
+                mergeBranch(left, parent->keys[i - 1], branch);
+                removeFromBranch(parent, i - 1, i);
+            }
+            else if (right)
+            {
+                mergeBranch(branch, parent->keys[i], right);
+                removeFromBranch(parent, i, i + 1);
+            }
+            return true;
+        }
+
+        void mergeBranch(Branch* dest, const Key& separator, Branch* src)
+        {
+            dest->keys[dest->size] = separator;
+            for (U16 j = 0; j < src->size; ++j)
+                dest->keys[dest->size + 1 + j] = src->keys[j];
+            for (U16 j = 0; j <= src->size; ++j)
+                dest->children[dest->size + 1 + j] = src->children[j];
+
+            dest->size += 1 + src->size;
+            releaseBranch(src);
+        }
+    };
+
+}  // namespace Rt2
@@ -20,7 +20,11 @@
 -------------------------------------------------------------------------------
 */
 #include "Utils/Base64.h"
-#include "Utils/Char.h"
+#include "Utils/Cpu.h"
+
+#if RT_ARCH_X64
+    #include <immintrin.h>
+#endif
 
 namespace Rt2
 {
@@ -37,46 +41,347 @@ namespace Rt2
         // clang-format on
     };
 
-    String Base64::encode(const String& inp)
+    namespace
     {
-        String copy;
-        encode(copy, inp);
-        return copy;
+        constexpr char Padding = SymbolSet[64];
+
+        struct DecodeTable
+        {
+            // -1 marks the bytes that are not in the alphabet.
+            int8_t values[256]{};
+
+            constexpr DecodeTable()
+            {
+                for (int8_t& value : values)
+                    value = -1;
+                for (int i = 0; i < 64; ++i)
+                    values[uint8_t(SymbolSet[i])] = int8_t(i);
+            }
+        };
+
+        constexpr DecodeTable DecodeValues;
+
+        void encodeScalar(char*& out, const uint8_t*& in, const uint8_t* end)
+        {
+            for (; end - in >= 3; in += 3, out += 4)
+            {
+                const uint32_t cb = uint32_t(in[0]) << 16 | uint32_t(in[1]) << 8 | in[2];
+
+                out[0] = SymbolSet[cb >> 18];
+                out[1] = SymbolSet[cb >> 12 & MaxMask];
+                out[2] = SymbolSet[cb >> 6 & MaxMask];
+                out[3] = SymbolSet[cb & MaxMask];
+            }
+        }
+
+        bool decodeScalar(uint8_t*& out, const char*& in, const char* end)
+        {
+            for (; end - in >= 4; in += 4, out += 3)
+            {
+                const int a = DecodeValues.values[uint8_t(in[0])];
+                const int b = DecodeValues.values[uint8_t(in[1])];
+                const int c = DecodeValues.values[uint8_t(in[2])];
+                const int d = DecodeValues.values[uint8_t(in[3])];
+                if ((a | b | c | d) < 0)
+                    return false;
+
+                const uint32_t cb = uint32_t(a) << 18 | uint32_t(b) << 12 | uint32_t(c) << 6 | uint32_t(d);
+
+                out[0] = uint8_t(cb >> 16);
+                out[1] = uint8_t(cb >> 8);
+                out[2] = uint8_t(cb);
+            }
+            return true;
+        }
+
+#if RT_ARCH_X64
+
+        // The vector versions follow Muła and Lemire. Encoding spreads each
+        // three bytes over four 6-bit indices with a shuffle and two
+        // multiplies, then maps the indices to characters by adding an offset
+        // looked up from the range that each index falls in. Decoding checks
+        // each character against a table indexed by its two nibbles, maps it
+        // back with a per-range offset and packs the 6-bit values with
+        // multiply-adds. The only difference from the standard alphabet is
+        // that 63 is '-' rather than '/'.
+
+        // Offsets for the reduced indices: 0 for a-z, 1-10 for 0-9,
+        // 11 for '+', 12 for '-' and 13 for A-Z.
+        #define RT_BASE64_ENCODE_OFFSETS \
+            71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -19, -18, 65, 0, 0
+
+        // A character is invalid if the entries for its low and high
+        // nibble share a bit. Bit 0 rejects the rows without any symbol,
+        // bits 1-4 reject the holes in the rows 2, 3, 4/6 and 5/7.
+        #define RT_BASE64_DECODE_LO \
+            0x0B, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x07, 0x15, 0x17, 0x15, 0x17, 0x17
+        #define RT_BASE64_DECODE_HI \
+            0x01, 0x01, 0x02, 0x04, 0x08, 0x10, 0x08, 0x10, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01
+        #define RT_BASE64_DECODE_ROLL \
+            0, 18, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0
+
+        RT_TARGET_SSE42 void encodeSsse3(char*& out, const uint8_t*& in, const uint8_t* end)
+        {
+            const __m128i shuffle = _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+            const __m128i offsets = _mm_setr_epi8(RT_BASE64_ENCODE_OFFSETS);
+
+            // 12 bytes are used from each 16 byte load.
+            while (end - in >= 16)
+            {
+                const __m128i v = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)in), shuffle);
+
+                const __m128i t0 = _mm_and_si128(v, _mm_set1_epi32(0x0FC0FC00));
+                const __m128i t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+                const __m128i t2 = _mm_and_si128(v, _mm_set1_epi32(0x003F03F0));
+                const __m128i t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+                const __m128i ix = _mm_or_si128(t1, t3);
+
+                __m128i reduced = _mm_subs_epu8(ix, _mm_set1_epi8(51));
+                reduced         = _mm_or_si128(reduced,
+                                               _mm_and_si128(_mm_cmpgt_epi8(_mm_set1_epi8(26), ix),
+                                                             _mm_set1_epi8(13)));
+
+                _mm_storeu_si128((__m128i*)out, _mm_add_epi8(_mm_shuffle_epi8(offsets, reduced), ix));
+                in += 12;
+                out += 16;
+            }
+        }
+
+        RT_TARGET_AVX2 void encodeAvx2(char*& out, const uint8_t*& in, const uint8_t* end)
+        {
+            const __m256i shuffle = _mm256_broadcastsi128_si256(
+                _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10));
+            const __m256i offsets = _mm256_broadcastsi128_si256(
+                _mm_setr_epi8(RT_BASE64_ENCODE_OFFSETS));
+
+            // Each lane takes 12 bytes from its own 16 byte load.
+            while (end - in >= 28)
+            {
+                __m256i v = _mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)in));
+                v         = _mm256_inserti128_si256(v, _mm_loadu_si128((const __m128i*)(in + 12)), 1);
+                v         = _mm256_shuffle_epi8(v, shuffle);
+
+                const __m256i t0 = _mm256_and_si256(v, _mm256_set1_epi32(0x0FC0FC00));
+                const __m256i t1 = _mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+                const __m256i t2 = _mm256_and_si256(v, _mm256_set1_epi32(0x003F03F0));
+                const __m256i t3 = _mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+                const __m256i ix = _mm256_or_si256(t1, t3);
+
+                __m256i reduced = _mm256_subs_epu8(ix, _mm256_set1_epi8(51));
+                reduced         = _mm256_or_si256(reduced,
+                                                  _mm256_and_si256(_mm256_cmpgt_epi8(_mm256_set1_epi8(26), ix),
+                                                                   _mm256_set1_epi8(13)));
+
+                _mm256_storeu_si256((__m256i*)out, _mm256_add_epi8(_mm256_shuffle_epi8(offsets, reduced), ix));
+                in += 24;
+                out += 32;
+            }
+        }
+
+        // Both decoders store a whole vector for 12 or 24 bytes of output,
+        // so they stop while enough input remains to cover the extra bytes.
+        RT_TARGET_SSE42 bool decodeSsse3(uint8_t*& out, const char*& in, const char* end)
+        {
+            const __m128i lutLo  = _mm_setr_epi8(RT_BASE64_DECODE_LO);
+            const __m128i lutHi  = _mm_setr_epi8(RT_BASE64_DECODE_HI);
+            const __m128i roll   = _mm_setr_epi8(RT_BASE64_DECODE_ROLL);
+            const __m128i nibble = _mm_set1_epi8(0x0F);
+            const __m128i pack   = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+
+            while (end - in >= 24)
+            {
+                const __m128i v  = _mm_loadu_si128((const __m128i*)in);
+                const __m128i hi = _mm_and_si128(_mm_srli_epi32(v, 4), nibble);
+                const __m128i lo = _mm_and_si128(v, nibble);
+
+                if (!_mm_testz_si128(_mm_shuffle_epi8(lutLo, lo), _mm_shuffle_epi8(lutHi, hi)))
+                    return false;
+
+                const __m128i dash   = _mm_cmpeq_epi8(v, _mm_set1_epi8('-'));
+                const __m128i values = _mm_add_epi8(v, _mm_shuffle_epi8(roll, _mm_add_epi8(dash, hi)));
+
+                const __m128i merged = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+                const __m128i packed = _mm_madd_epi16(merged, _mm_set1_epi32(0x00011000));
+
+                _mm_storeu_si128((__m128i*)out, _mm_shuffle_epi8(packed, pack));
+                in += 16;
+                out += 12;
+            }
+            return true;
+        }
+
+        RT_TARGET_AVX2 bool decodeAvx2(uint8_t*& out, const char*& in, const char* end)
+        {
+            const __m256i lutLo  = _mm256_broadcastsi128_si256(_mm_setr_epi8(RT_BASE64_DECODE_LO));
+            const __m256i lutHi  = _mm256_broadcastsi128_si256(_mm_setr_epi8(RT_BASE64_DECODE_HI));
+            const __m256i roll   = _mm256_broadcastsi128_si256(_mm_setr_epi8(RT_BASE64_DECODE_ROLL));
+            const __m256i nibble = _mm256_set1_epi8(0x0F);
+            const __m256i pack   = _mm256_broadcastsi128_si256(
+                _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+            const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 7, 7);
+
+            while (end - in >= 48)
+            {
+                const __m256i v  = _mm256_loadu_si256((const __m256i*)in);
+                const __m256i hi = _mm256_and_si256(_mm256_srli_epi32(v, 4), nibble);
+                const __m256i lo = _mm256_and_si256(v, nibble);
+
+                if (!_mm256_testz_si256(_mm256_shuffle_epi8(lutLo, lo), _mm256_shuffle_epi8(lutHi, hi)))
+                    return false;
+
+                const __m256i dash   = _mm256_cmpeq_epi8(v, _mm256_set1_epi8('-'));
+                const __m256i values = _mm256_add_epi8(v, _mm256_shuffle_epi8(roll, _mm256_add_epi8(dash, hi)));
+
+                const __m256i merged = _mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140));
+                const __m256i packed = _mm256_madd_epi16(merged, _mm256_set1_epi32(0x00011000));
+                const __m256i bytes  = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(packed, pack), lanes);
+
+                _mm256_storeu_si256((__m256i*)out, bytes);
+                in += 32;
+                out += 24;
+            }
+            return true;
+        }
+
+        #undef RT_BASE64_ENCODE_OFFSETS
+        #undef RT_BASE64_DECODE_LO
+        #undef RT_BASE64_DECODE_HI
+        #undef RT_BASE64_DECODE_ROLL
+
+#endif
+    }  // namespace
+
+    size_t Base64::encodedSize(const size_t len)
+    {
+        return (len + 2) / 3 * 4;
     }
 
-    void Base64::encode(String& dest, const String& inp)
+    size_t Base64::decodedSize(const char* src, const size_t len)
     {
-        uint8_t p[3]{0, 0, 0};
-        int64_t n = (int64_t)inp.size();
-        dest.reserve(uint32_t(4 * double(n) / 3));
+        if (len == 0 || len % 4 != 0)
+            return 0;
+
+        size_t size = len / 4 * 3;
+        if (src[len - 1] == Padding)
+            size -= src[len - 2] == Padding ? 2 : 1;
+        return size;
+    }
+
+    size_t Base64::encode(char* dest, const void* src, const size_t len)
+    {
+        const uint8_t* in  = (const uint8_t*)src;
+        const uint8_t* end = in + len;
+        char*          out = dest;
+
+#if RT_ARCH_X64
+        switch (Cpu::level())
+        {
+        case SIMD_AVX2:
+            encodeAvx2(out, in, end);
+            encodeSsse3(out, in, end);
+            break;
+        case SIMD_SSE42:
+            encodeSsse3(out, in, end);
+            break;
+        default:
+            break;
+        }
+#endif
+        encodeScalar(out, in, end);
 
-        for (int64_t i = 0; i < n; i += 3)
+        if (const size_t rem = size_t(end - in); rem > 0)
         {
-            p[2] = (uint8_t)inp[i];
-            if (i + 1 > n)
-                p[1] = 0;
-            else
-                p[1] = (uint8_t)inp[i + 1];
+            const uint32_t cb = uint32_t(in[0]) << 16 | (rem > 1 ? uint32_t(in[1]) << 8 : 0);
+
+            out[0] = SymbolSet[cb >> 18];
+            out[1] = SymbolSet[cb >> 12 & MaxMask];
+            out[2] = rem > 1 ? SymbolSet[cb >> 6 & MaxMask] : Padding;
+            out[3] = Padding;
+            out += 4;
+        }
+        return size_t(out - dest);
+    }
+
+    size_t Base64::decode(void* dest, const char* src, const size_t len)
+    {
+        if (len % 4 != 0)
+            return Npos;
+        if (len == 0)
+            return 0;
 
-            if (i + 2 > n)
-                p[0] = 0;
-            else
-                p[0] = (uint8_t)inp[i + 2];
+        uint8_t*    out = (uint8_t*)dest;
+        const char* in  = src;
 
-            const int64_t cb = (int64_t)p[2] << 16 | (int64_t)p[1] << 8 | (int64_t)p[0];
-            dest.push_back(SymbolSet[cb >> 18 & MaxMask]);
-            dest.push_back(SymbolSet[cb >> 12 & MaxMask]);
-            dest.push_back(SymbolSet[cb >> 6 & MaxMask]);
-            dest.push_back(SymbolSet[cb & MaxMask]);
+        // The last group is left to the end, since it may be padded.
+        const char* end  = src + len;
+        const char* body = end - 4;
+
+#if RT_ARCH_X64
+        bool valid = true;
+        switch (Cpu::level())
+        {
+        case SIMD_AVX2:
+            valid = decodeAvx2(out, in, end) && decodeSsse3(out, in, end);
+            break;
+        case SIMD_SSE42:
+            valid = decodeSsse3(out, in, end);
+            break;
+        default:
+            break;
         }
+        if (!valid)
+            return Npos;
+#endif
+        if (!decodeScalar(out, in, body))
+            return Npos;
+
+        const int a = DecodeValues.values[uint8_t(in[0])];
+        const int b = DecodeValues.values[uint8_t(in[1])];
+        if ((a | b) < 0)
+            return Npos;
+
+        uint32_t cb = uint32_t(a) << 18 | uint32_t(b) << 12;
+        *out++      = uint8_t(cb >> 16);
 
-        if (const int64_t r3 = 3 - n % 3;
-            dest.size() >= 4 && r3 <= 2)
+        if (in[2] == Padding)
         {
-            n = (int64_t)dest.size();
-            for (int64_t i = 0; i < r3; ++i)
-                dest[n - (i + 1)] = SymbolSet[64];
+            if (in[3] != Padding)
+                return Npos;
+        }
+        else
+        {
+            const int c = DecodeValues.values[uint8_t(in[2])];
+            if (c < 0)
+                return Npos;
+
+            cb |= uint32_t(c) << 6;
+            *out++ = uint8_t(cb >> 8);
+
+            if (in[3] != Padding)
+            {
+                const int d = DecodeValues.values[uint8_t(in[3])];
+                if (d < 0)
+                    return Npos;
+
+                cb |= uint32_t(d);
+                *out++ = uint8_t(cb);
+            }
         }
+        return size_t(out - (uint8_t*)dest);
+    }
+
+    String Base64::encode(const String& inp)
+    {
+        String copy;
+        encode(copy, inp);
+        return copy;
+    }
+
+    void Base64::encode(String& dest, const String& inp)
+    {
+        const size_t at = dest.size();
+        dest.resize(at + encodedSize(inp.size()));
+        encode(dest.data() + at, inp.data(), inp.size());
     }
 
     String Base64::decode(const String& inp)
@@ -86,47 +391,159 @@ namespace Rt2
         return copy;
     }
 
-    int decodeIndex(const char ch)
+    bool Base64::decode(String& dest, const String& inp)
     {
-        switch (ch)
+        const size_t at = dest.size();
+        dest.resize(at + decodedSize(inp.data(), inp.size()));
+
+        if (decode(dest.data() + at, inp.data(), inp.size()) == Npos)
         {
-        case UpperCaseAz:
-            return ch - 'A';
-        case LowerCaseAz:
-            return ch - 'a' + 26;
-        case Digits09:
-            return ch - '0' + 52;
-        case '-':
-        case '+':
-        case '=':
-            return 0;
-        default:
-            return -1;
+            dest.resize(at);
+            return false;
+        }
+        return true;
+    }
+
+    Base64Encoder::Base64Encoder(OStream& out) :
+        _out(out)
+    {
+    }
+
+    void Base64Encoder::emit(const uint8_t* data, const size_t len)
+    {
+        _buffer.resize(Base64::encodedSize(len));
+        Base64::encode(_buffer.data(), data, len);
+        _out.write(_buffer.data(), (std::streamsize)_buffer.size());
+    }
+
+    void Base64Encoder::write(const void* data, size_t len)
+    {
+        const uint8_t* in = (const uint8_t*)data;
+
+        if (_count > 0)
+        {
+            while (_count < 3 && len > 0)
+            {
+                _pending[_count++] = *in++;
+                --len;
+            }
+            if (_count < 3)
+                return;
+
+            emit(_pending, 3);
+            _count = 0;
         }
+
+        while (len >= 3)
+        {
+            const size_t size = Min(len - len % 3, ChunkSize);
+            emit(in, size);
+            in += size;
+            len -= size;
+        }
+
+        while (len > 0)
+        {
+            _pending[_count++] = *in++;
+            --len;
+        }
+    }
+
+    void Base64Encoder::finish()
+    {
+        if (_count > 0)
+            emit(_pending, _count);
+        _count = 0;
+    }
+
+    void Base64Encoder::encode(OStream& out, IStream& in)
+    {
+        Base64Encoder encoder(out);
+
+        String chunk(ChunkSize, 0);
+        while (in.read(chunk.data(), (std::streamsize)chunk.size()), in.gcount() > 0)
+            encoder.write(chunk.data(), (size_t)in.gcount());
+        encoder.finish();
+    }
+
+    Base64Decoder::Base64Decoder(OStream& out) :
+        _out(out)
+    {
+    }
+
+    bool Base64Decoder::emit(const char* data, const size_t len)
+    {
+        if (_padded)
+            return false;
+
+        _buffer.resize(Base64::decodedSize(data, len));
+        if (Base64::decode(_buffer.data(), data, len) == Npos)
+            return false;
+
+        _padded = data[len - 1] == Padding;
+        _out.write(_buffer.data(), (std::streamsize)_buffer.size());
+        return true;
     }
 
-    void Base64::decode(String& dest, const String& inp)
+    bool Base64Decoder::write(const char* data, size_t len)
     {
-        if (inp.size() % 4 > 0)
-            return;
+        if (_failed)
+            return false;
+
+        if (_count > 0)
+        {
+            while (_count < 4 && len > 0)
+            {
+                _pending[_count++] = *data++;
+                --len;
+            }
+            if (_count < 4)
+                return true;
+
+            _count = 0;
+            if (!emit(_pending, 4))
+            {
+                _failed = true;
+                return false;
+            }
+        }
+
+        while (len >= 4)
+        {
+            const size_t size = Min(len - len % 4, ChunkSize);
+            if (!emit(data, size))
+            {
+                _failed = true;
+                return false;
+            }
 
-        const int64_t n = (int64_t)inp.size();
+            data += size;
+            len -= size;
+        }
 
-        for (int64_t i = 0; i < n; i += 4)
+        while (len > 0)
         {
-            const int a = decodeIndex(inp[i]);
-            const int b = decodeIndex(inp[i + 1]);
-            const int c = decodeIndex(inp[i + 2]);
-            const int d = decodeIndex(inp[i + 3]);
+            _pending[_count++] = *data++;
+            --len;
+        }
+        return true;
+    }
 
-            const int64_t cb = (int64_t)a << 18 | (int64_t)b << 12 | (int64_t)c << 6 | (int64_t)d;
-            const uint8_t ra = (uint8_t)((cb & 0xFF0000) >> 16);
-            const uint8_t rb = (uint8_t)((cb & 0x00FF00) >> 8);
-            const uint8_t rc = (uint8_t)(cb & 0x0000FF);
+    bool Base64Decoder::finish() const
+    {
+        return !_failed && _count == 0;
+    }
+
+    bool Base64Decoder::decode(OStream& out, IStream& in)
+    {
+        Base64Decoder decoder(out);
 
-            if (ra > 0) dest.push_back((char)ra);
-            if (rb > 0) dest.push_back((char)rb);
-            if (rc > 0) dest.push_back((char)rc);
+        String chunk(ChunkSize, 0);
+        while (in.read(chunk.data(), (std::streamsize)chunk.size()), in.gcount() > 0)
+        {
+            if (!decoder.write(chunk.data(), (size_t)in.gcount()))
+                return false;
         }
+        return decoder.finish();
     }
 }  // namespace Rt2
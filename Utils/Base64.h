@@ -24,6 +24,12 @@
 
 namespace Rt2
 {
+    /**
+     * \brief Base64 with the alphabet A-Z a-z 0-9 + - and = padding.
+     *
+     * Whole blocks are converted with SSSE3 or AVX2 shuffles when
+     * Cpu::level allows it, and with lookup tables otherwise.
+     */
     class Base64
     {
     public:
@@ -31,9 +37,120 @@ namespace Rt2
 
         static String decode(const String& inp);
 
+        /**
+         * \brief Appends the encoded input to dest.
+         */
         static void encode(String& dest, const String& inp);
 
-        static void decode(String& dest, const String& inp);
+        /**
+         * \brief Appends the decoded input to dest.
+         * \return False if the input is not a multiple of four characters
+         * long or holds a character outside of the alphabet, in which
+         * case dest is left as it was.
+         */
+        static bool decode(String& dest, const String& inp);
+
+        /**
+         * \brief Encodes len bytes of src into dest, which must
+         * have room for encodedSize(len) characters.
+         * \return The number of characters written.
+         */
+        static size_t encode(char* dest, const void* src, size_t len);
+
+        /**
+         * \brief Decodes len characters of src into dest, which must
+         * have room for decodedSize(src, len) bytes.
+         * \return The number of bytes written, or Npos if the input
+         * is not valid.
+         */
+        static size_t decode(void* dest, const char* src, size_t len);
+
+        static size_t encodedSize(size_t len);
+
+        /**
+         * \return The exact number of bytes that src decodes to,
+         * or zero if len is not a multiple of four.
+         */
+        static size_t decodedSize(const char* src, size_t len);
+    };
+
+    /**
+     * \brief Encodes a sequence of writes to a stream.
+     *
+     * Input is converted in chunks of ChunkSize bytes, with at most two
+     * bytes held back between writes, until finish writes the padding.
+     */
+    class Base64Encoder
+    {
+    public:
+        static constexpr size_t ChunkSize = 0xC000;
+
+    private:
+        OStream& _out;
+        String   _buffer;
+        uint8_t  _pending[3]{};
+        size_t   _count{0};
+
+    public:
+        explicit Base64Encoder(OStream& out);
+
+        void write(const void* data, size_t len);
+
+        /**
+         * \brief Writes the bytes that are held back, with padding.
+         */
+        void finish();
+
+        /**
+         * \brief Encodes the remainder of in to out.
+         */
+        static void encode(OStream& out, IStream& in);
+
+    private:
+        void emit(const uint8_t* data, size_t len);
+    };
+
+    /**
+     * \brief Decodes a sequence of writes to a stream.
+     *
+     * Input is converted in chunks of ChunkSize characters, with at most
+     * three characters held back between writes.
+     */
+    class Base64Decoder
+    {
+    public:
+        static constexpr size_t ChunkSize = 0x10000;
+
+    private:
+        OStream& _out;
+        String   _buffer;
+        char     _pending[4]{};
+        size_t   _count{0};
+        bool     _padded{false};
+        bool     _failed{false};
+
+    public:
+        explicit Base64Decoder(OStream& out);
+
+        /**
+         * \return False once a character outside of the
+         * alphabet or anything after the padding is seen.
+         */
+        bool write(const char* data, size_t len);
+
+        /**
+         * \return True if every character was decoded.
+         */
+        bool finish() const;
+
+        /**
+         * \brief Decodes the remainder of in to out.
+         * \return False if the input is not valid.
+         */
+        static bool decode(OStream& out, IStream& in);
+
+    private:
+        bool emit(const char* data, size_t len);
     };
 
 }  // namespace Rt2
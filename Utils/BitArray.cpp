@@ -0,0 +1,271 @@
+/*
+-------------------------------------------------------------------------------
+    Copyright (c) Charles Carley.
+
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+-------------------------------------------------------------------------------
+*/
+#include "Utils/BitArray.h"
+#include <cstring>
+
+namespace Rt2
+{
+    namespace
+    {
+        U64 wordsFor(const U64 bits)
+        {
+            return (bits + BitArray::WordBits - 1) / BitArray::WordBits;
+        }
+    }  // namespace
+
+    BitArray::BitArray(const U64 bits, const bool value)
+    {
+        resize(bits, value);
+    }
+
+    BitArray::BitArray(const BitArray& rhs)
+    {
+        *this = rhs;
+    }
+
+    BitArray::~BitArray()
+    {
+        clear();
+    }
+
+    BitArray& BitArray::operator=(const BitArray& rhs)
+    {
+        if (this != &rhs)
+        {
+            reserve(rhs._size);
+            if (rhs._size > 0)
+                memcpy(_words, rhs._words, sizeof(U64) * rhs.wordCount());
+            _size = rhs._size;
+        }
+        return *this;
+    }
+
+    void BitArray::clear()
+    {
+        if (_words)
+        {
+            WordAllocator::deallocateArray(_words, _capacity);
+            _words = nullptr;
+        }
+        _size = _capacity = 0;
+    }
+
+    void BitArray::reserve(const U64 bits)
+    {
+        const U64 words = wordsFor(bits);
+        if (words > _capacity)
+        {
+            const U64 capacity = Max<U64>(words, _capacity * 2);
+
+            _words = _alloc.reallocateArray(_words, capacity, wordCount(), true);
+            if (!_words)
+                throw Exception("Failed to reserve bit array memory");
+            _capacity = capacity;
+        }
+    }
+
+    void BitArray::resize(const U64 bits, const bool value)
+    {
+        reserve(bits);
+
+        const U64 from  = wordCount();
+        const U64 words = wordsFor(bits);
+        if (bits > _size)
+        {
+            // The tail of the last word is already zero.
+            if (value && _size % WordBits)
+                _words[from - 1] |= ~U64(0) << (_size % WordBits);
+            if (words > from)
+                memset(_words + from, value ? 0xFF : 0, sizeof(U64) * (words - from));
+        }
+        _size = bits;
+        trim();
+    }
+
+    void BitArray::setAll()
+    {
+        if (_size > 0)
+        {
+            memset(_words, 0xFF, sizeof(U64) * wordCount());
+            trim();
+        }
+    }
+
+    void BitArray::resetAll()
+    {
+        if (_size > 0)
+            memset(_words, 0, sizeof(U64) * wordCount());
+    }
+
+    U64 BitArray::count() const
+    {
+        return Bits::popCount(_words, wordCount());
+    }
+
+    bool BitArray::any() const
+    {
+        return findFirst() != Npos;
+    }
+
+    U64 BitArray::findFirst() const
+    {
+        const U64 words = wordCount();
+        for (U64 w = 0; w < words; ++w)
+        {
+            if (_words[w])
+                return w * WordBits + (U64)Bits::countTrailingZeros(_words[w]);
+        }
+        return Npos;
+    }
+
+    U64 BitArray::findNext(const U64 bit) const
+    {
+        const U64 start = bit + 1;
+        if (start >= _size)
+            return Npos;
+
+        U64 w    = start / WordBits;
+        U64 word = _words[w] & ~U64(0) << (start % WordBits);
+
+        const U64 words = wordCount();
+        for (;;)
+        {
+            if (word)
+                return w * WordBits + (U64)Bits::countTrailingZeros(word);
+            if (++w >= words)
+                return Npos;
+            word = _words[w];
+        }
+    }
+
+    BitArray& BitArray::operator|=(const BitArray& rhs)
+    {
+        if (rhs._size > _size)
+            resize(rhs._size);
+
+        const U64 words = rhs.wordCount();
+        for (U64 w = 0; w < words; ++w)
+            _words[w] |= rhs._words[w];
+        return *this;
+    }
+
+    BitArray& BitArray::operator^=(const BitArray& rhs)
+    {
+        if (rhs._size > _size)
+            resize(rhs._size);
+
+        const U64 words = rhs.wordCount();
+        for (U64 w = 0; w < words; ++w)
+            _words[w] ^= rhs._words[w];
+        return *this;
+    }
+
+    BitArray& BitArray::operator&=(const BitArray& rhs)
+    {
+        const U64 words  = wordCount();
+        const U64 shared = Min<U64>(words, rhs.wordCount());
+
+        U64 w = 0;
+        for (; w < shared; ++w)
+            _words[w] &= rhs._words[w];
+        for (; w < words; ++w)
+            _words[w] = 0;
+        return *this;
+    }
+
+    BitArray& BitArray::andNot(const BitArray& rhs)
+    {
+        const U64 shared = Min<U64>(wordCount(), rhs.wordCount());
+        for (U64 w = 0; w < shared; ++w)
+            _words[w] &= ~rhs._words[w];
+        trim();
+        return *this;
+    }
+
+    bool BitArray::operator==(const BitArray& rhs) const
+    {
+        if (_size != rhs._size)
+            return false;
+        return _size == 0 || memcmp(_words, rhs._words, sizeof(U64) * wordCount()) == 0;
+    }
+
+    void BitArray::trim()
+    {
+        if (_size % WordBits)
+            _words[wordCount() - 1] &= ~(~U64(0) << (_size % WordBits));
+    }
+
+    DenseIdSet::DenseIdSet(const U32 universe)
+    {
+        _bits.reserve(universe);
+    }
+
+    void DenseIdSet::clear()
+    {
+        _bits.resetAll();
+        _size = 0;
+    }
+
+    bool DenseIdSet::insert(const U32 id)
+    {
+        if (id >= _bits.size())
+            _bits.resize(U64(id) + 1);
+        else if (_bits.get(id))
+            return false;
+
+        _bits.set(id);
+        ++_size;
+        return true;
+    }
+
+    bool DenseIdSet::erase(const U32 id)
+    {
+        if (!contains(id))
+            return false;
+
+        _bits.reset(id);
+        --_size;
+        return true;
+    }
+
+    DenseIdSet& DenseIdSet::operator|=(const DenseIdSet& rhs)
+    {
+        _bits |= rhs._bits;
+        _size = _bits.count();
+        return *this;
+    }
+
+    DenseIdSet& DenseIdSet::operator&=(const DenseIdSet& rhs)
+    {
+        _bits &= rhs._bits;
+        _size = _bits.count();
+        return *this;
+    }
+
+    DenseIdSet& DenseIdSet::operator-=(const DenseIdSet& rhs)
+    {
+        _bits.andNot(rhs._bits);
+        _size = _bits.count();
+        return *this;
+    }
+
+}  // namespace Rt2
@@ -0,0 +1,249 @@
+/*
+-------------------------------------------------------------------------------
+    Copyright (c) Charles Carley.
+
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+-------------------------------------------------------------------------------
+*/
+#pragma once
+
+#include "Utils/Allocator.h"
+#include "Utils/Bits.h"
+#include "Utils/Definitions.h"
+
+namespace Rt2
+{
+    /**
+     * \brief Dynamically sized array of bits packed into 64-bit words.
+     *
+     * Bits past size() in the last word are always zero, so counts
+     * and searches can work a whole word at a time.
+     */
+    class BitArray
+    {
+    public:
+        using SizeType      = U64;
+        using WordAllocator = Allocator<U64, U64>;
+
+        static constexpr U64 WordBits = 64;
+
+    private:
+        U64*          _words{nullptr};
+        U64           _size{0};
+        U64           _capacity{0};
+        WordAllocator _alloc;
+
+    public:
+        BitArray() = default;
+
+        explicit BitArray(U64 bits, bool value = false);
+
+        BitArray(const BitArray& rhs);
+
+        ~BitArray();
+
+        BitArray& operator=(const BitArray& rhs);
+
+        void clear();
+
+        /**
+         * \brief Sets the number of bits. New bits are set to value.
+         */
+        void resize(U64 bits, bool value = false);
+
+        void reserve(U64 bits);
+
+        bool get(const U64 bit) const
+        {
+            RT_ASSERT(bit < _size)
+            return (_words[bit >> 6] >> (bit & 63) & 1) != 0;
+        }
+
+        bool operator[](const U64 bit) const
+        {
+            return get(bit);
+        }
+
+        void set(const U64 bit)
+        {
+            RT_ASSERT(bit < _size)
+            _words[bit >> 6] |= U64(1) << (bit & 63);
+        }
+
+        void set(const U64 bit, const bool value)
+        {
+            if (value)
+                set(bit);
+            else
+                reset(bit);
+        }
+
+        void reset(const U64 bit)
+        {
+            RT_ASSERT(bit < _size)
+            _words[bit >> 6] &= ~(U64(1) << (bit & 63));
+        }
+
+        void flip(const U64 bit)
+        {
+            RT_ASSERT(bit < _size)
+            _words[bit >> 6] ^= U64(1) << (bit & 63);
+        }
+
+        void setAll();
+
+        void resetAll();
+
+        /**
+         * \return The number of set bits.
+         */
+        U64 count() const;
+
+        bool any() const;
+
+        bool none() const { return !any(); }
+
+        /**
+         * \return The index of the first set bit or Npos.
+         */
+        U64 findFirst() const;
+
+        /**
+         * \return The index of the first set bit after bit or Npos.
+         */
+        U64 findNext(U64 bit) const;
+
+        /**
+         * \brief Calls fn with the index of each set bit in ascending order.
+         */
+        template <typename Fn>
+        void forEachSet(Fn&& fn) const
+        {
+            const U64 words = wordCount();
+            for (U64 w = 0; w < words; ++w)
+            {
+                U64 word = _words[w];
+                while (word)
+                {
+                    fn(w * WordBits + (U64)Bits::countTrailingZeros(word));
+                    word &= word - 1;
+                }
+            }
+        }
+
+        /**
+         * \brief Bitwise or. The array grows to the size of rhs if it is larger.
+         */
+        BitArray& operator|=(const BitArray& rhs);
+
+        /**
+         * \brief Bitwise xor. The array grows to the size of rhs if it is larger.
+         */
+        BitArray& operator^=(const BitArray& rhs);
+
+        /**
+         * \brief Bitwise and. Bits past the end of rhs are cleared.
+         */
+        BitArray& operator&=(const BitArray& rhs);
+
+        /**
+         * \brief Clears every bit that is set in rhs.
+         */
+        BitArray& andNot(const BitArray& rhs);
+
+        bool operator==(const BitArray& rhs) const;
+
+        bool operator!=(const BitArray& rhs) const { return !(*this == rhs); }
+
+        U64 size() const { return _size; }
+
+        bool empty() const { return _size == 0; }
+
+        U64 wordCount() const { return (_size + WordBits - 1) / WordBits; }
+
+        const U64* data() const { return _words; }
+
+    private:
+        void trim();
+    };
+
+    /**
+     * \brief Set of small unsigned integer ids backed by a BitArray.
+     *
+     * Uses one bit per possible id instead of a hash table entry per member,
+     * so it suits dense id ranges; the storage grows to the largest id inserted.
+     */
+    class DenseIdSet
+    {
+    private:
+        BitArray _bits;
+        U64      _size{0};
+
+    public:
+        DenseIdSet() = default;
+
+        /**
+         * \param universe Reserves room for the ids [0, universe).
+         */
+        explicit DenseIdSet(U32 universe);
+
+        void clear();
+
+        /**
+         * \return False if the id was already in the set.
+         */
+        bool insert(U32 id);
+
+        /**
+         * \return False if the id was not in the set.
+         */
+        bool erase(U32 id);
+
+        bool contains(const U32 id) const
+        {
+            return id < _bits.size() && _bits.get(id);
+        }
+
+        /**
+         * \return The id if it is in the set, otherwise Npos.
+         */
+        size_t find(const U32 id) const
+        {
+            return contains(id) ? id : Npos;
+        }
+
+        template <typename Fn>
+        void forEach(Fn&& fn) const
+        {
+            _bits.forEachSet([&fn](const U64 id)
+                             { fn((U32)id); });
+        }
+
+        DenseIdSet& operator|=(const DenseIdSet& rhs);
+
+        DenseIdSet& operator&=(const DenseIdSet& rhs);
+
+        DenseIdSet& operator-=(const DenseIdSet& rhs);
+
+        size_t size() const { return (size_t)_size; }
+
+        bool empty() const { return _size == 0; }
+
+        const BitArray& bits() const { return _bits; }
+    };
+
+}  // namespace Rt2
@@ -0,0 +1,112 @@
+/*
+-------------------------------------------------------------------------------
+    Copyright (c) Charles Carley.
+
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+-------------------------------------------------------------------------------
+*/
+#include "Utils/Bits.h"
+#include "Utils/Cpu.h"
+
+#if RT_ARCH_X64
+    #include <immintrin.h>
+#endif
+
+namespace Rt2
+{
+    namespace
+    {
+        U64 popCountScalar(const U64* words, const U64 count)
+        {
+            U64 total = 0;
+            for (U64 i = 0; i < count; ++i)
+                total += (U64)Bits::popCount(words[i]);
+            return total;
+        }
+
+#if RT_ARCH_X64
+        RT_TARGET_SSE42 U64 popCountSse42(const U64* words, const U64 count)
+        {
+            U64 total = 0;
+            for (U64 i = 0; i < count; ++i)
+                total += (U64)_mm_popcnt_u64(words[i]);
+            return total;
+        }
+
+        // Counts nibbles with a shuffle lookup and sums the
+        // bytes with sad; W. Mula, N. Kurz and D. Lemire.
+        RT_TARGET_AVX2 U64 popCountAvx2(const U64* words, const U64 count)
+        {
+            const __m256i table = _mm256_setr_epi8(
+                0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+            const __m256i low = _mm256_set1_epi8(0x0F);
+
+            __m256i acc = _mm256_setzero_si256();
+
+            U64 i = 0;
+            while (i + 4 <= count)
+            {
+                // Byte counters hold at most 8 per block,
+                // so flush to the 64-bit lanes every 31 blocks.
+                __m256i local = _mm256_setzero_si256();
+
+                const U64 end = Min<U64>(count - count % 4, i + 31 * 4);
+                for (; i < end; i += 4)
+                {
+                    const __m256i v  = _mm256_loadu_si256((const __m256i*)(words + i));
+                    const __m256i lo = _mm256_and_si256(v, low);
+                    const __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), low);
+
+                    local = _mm256_add_epi8(local, _mm256_shuffle_epi8(table, lo));
+                    local = _mm256_add_epi8(local, _mm256_shuffle_epi8(table, hi));
+                }
+                acc = _mm256_add_epi64(acc, _mm256_sad_epu8(local, _mm256_setzero_si256()));
+            }
+
+            U64 total = (U64)_mm256_extract_epi64(acc, 0) +
+                        (U64)_mm256_extract_epi64(acc, 1) +
+                        (U64)_mm256_extract_epi64(acc, 2) +
+                        (U64)_mm256_extract_epi64(acc, 3);
+
+            for (; i < count; ++i)
+                total += (U64)_mm_popcnt_u64(words[i]);
+            return total;
+        }
+#endif
+    }  // namespace
+
+    U64 Bits::popCount(const U64* words, const U64 count)
+    {
+        if (!words || count == 0)
+            return 0;
+
+#if RT_ARCH_X64
+        switch (Cpu::level())
+        {
+        case SIMD_AVX2:
+            return popCountAvx2(words, count);
+        case SIMD_SSE42:
+            return popCountSse42(words, count);
+        default:
+            break;
+        }
+#endif
+        return popCountScalar(words, count);
+    }
+
+}  // namespace Rt2
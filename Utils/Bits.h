@@ -0,0 +1,93 @@
+/*
+-------------------------------------------------------------------------------
+    Copyright (c) Charles Carley.
+
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+-------------------------------------------------------------------------------
+*/
+#pragma once
+
+#include "Utils/Definitions.h"
+
+#if RT_COMPILER == RT_COMPILER_MSVC
+    #include <intrin.h>
+#endif
+
+namespace Rt2
+{
+    class Bits
+    {
+    public:
+        static int popCount(U64 word);
+
+        /**
+         * \return The index of the lowest set bit. The word must not be zero.
+         */
+        static int countTrailingZeros(U64 word);
+
+        /**
+         * \return The number of zero bits above the highest set bit.
+         * The word must not be zero.
+         */
+        static int countLeadingZeros(U64 word);
+
+        /**
+         * \return The number of set bits in the first count words.
+         * Uses AVX2 or the popcnt instruction when the processor has them.
+         */
+        static U64 popCount(const U64* words, U64 count);
+    };
+
+    RT_FORCE_INLINE int Bits::popCount(const U64 word)
+    {
+#if RT_COMPILER == RT_COMPILER_MSVC
+        // Portable form; __popcnt64 would fault on
+        // processors without the instruction.
+        U64 v = word - (word >> 1 & 0x5555555555555555ull);
+        v     = (v & 0x3333333333333333ull) + (v >> 2 & 0x3333333333333333ull);
+        v     = (v + (v >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+        return (int)(v * 0x0101010101010101ull >> 56);
+#else
+        return __builtin_popcountll(word);
+#endif
+    }
+
+    RT_FORCE_INLINE int Bits::countTrailingZeros(const U64 word)
+    {
+        RT_ASSERT(word != 0)
+#if RT_COMPILER == RT_COMPILER_MSVC
+        unsigned long idx;
+        _BitScanForward64(&idx, word);
+        return (int)idx;
+#else
+        return __builtin_ctzll(word);
+#endif
+    }
+
+    RT_FORCE_INLINE int Bits::countLeadingZeros(const U64 word)
+    {
+        RT_ASSERT(word != 0)
+#if RT_COMPILER == RT_COMPILER_MSVC
+        unsigned long idx;
+        _BitScanReverse64(&idx, word);
+        return 63 - (int)idx;
+#else
+        return __builtin_clzll(word);
+#endif
+    }
+
+}  // namespace Rt2
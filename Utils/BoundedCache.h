@@ -0,0 +1,466 @@
+/*
+-------------------------------------------------------------------------------
+    Copyright (c) Charles Carley.
+
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+-------------------------------------------------------------------------------
+*/
+#pragma once
+
+#include <functional>
+#include "Utils/Array.h"
+#include "Utils/Definitions.h"
+#include "Utils/HashMap.h"
+#include "Utils/Timer.h"
+
+namespace Rt2
+{
+    enum CachePolicy
+    {
+        // Evicts the least recently used entry.
+        CACHE_LRU = 0,
+        // Second chance; entries referenced since the hand last
+        // passed them are skipped once before being evicted.
+        CACHE_CLOCK,
+        // Adaptive replacement; balances recency against frequency
+        // using ghost lists of recently evicted keys.
+        CACHE_ARC,
+    };
+
+    struct CacheStats
+    {
+        U64 hits{0};
+        U64 misses{0};
+        U64 evictions{0};
+        U64 expirations{0};
+
+        double hitRate() const
+        {
+            const U64 total = hits + misses;
+            return total ? double(hits) / double(total) : 0.0;
+        }
+    };
+
+    /**
+     * \brief Cache that holds at most capacity entries.
+     *
+     * Entries live in one contiguous array and are threaded onto intrusive
+     * lists by index, with a HashTable from key to entry. get and put are
+     * O(1) for every policy.
+     *
+     * Entries may have a time to live, measured in milliseconds by the
+     * cache's clock. Expired entries are dropped when they are next looked up.
+     */
+    template <typename Key, typename Value>
+    class BoundedCache
+    {
+    public:
+        using Clock = std::function<U64()>;
+
+    private:
+        enum List
+        {
+            // Resident entries. LRU and CLOCK only use Recent.
+            Recent = 0,
+            Frequent,
+            // ARC ghosts; keys that were recently evicted.
+            RecentGhost,
+            FrequentGhost,
+            Free,
+            ListCount,
+        };
+
+        struct Node
+        {
+            Key   key{};
+            Value value{};
+            U64   expires{0};
+            U32   prev{Npos32};
+            U32   next{Npos32};
+            U8    list{Free};
+            bool  referenced{false};
+        };
+
+        struct Links
+        {
+            U32 head{Npos32};
+            U32 tail{Npos32};
+            U32 size{0};
+        };
+
+        using Nodes = Array<Node>;
+        using Index = HashTable<Key, U32>;
+
+        Nodes       _nodes;
+        Index       _index;
+        Links       _lists[ListCount];
+        U32         _capacity;
+        U32         _target{0};
+        U64         _ttl{0};
+        CachePolicy _policy;
+        CacheStats  _stats;
+        Clock       _clock;
+
+    public:
+        explicit BoundedCache(U32 capacity, CachePolicy policy = CACHE_LRU) :
+            _capacity(Max<U32>(capacity, 1)),
+            _policy(policy),
+            _clock([]
+                   { return Timer::monotonic() / 1000; })
+        {
+            clear();
+        }
+
+        BoundedCache(const BoundedCache&) = delete;
+
+        void clear()
+        {
+            // ARC keeps up to capacity ghosts beside the resident entries.
+            const U32 count = _policy == CACHE_ARC ? _capacity * 2 : _capacity;
+
+            _nodes.clear();
+            _nodes.reserve(count);
+            _nodes.resizeFast(count);
+            _index.clear();
+            _index.reserve(count);
+
+            for (Links& links : _lists)
+                links = {};
+            for (U32 i = 0; i < count; ++i)
+                pushFront(Free, i);
+            _target = 0;
+        }
+
+        /**
+         * \brief Looks up key and marks it as used.
+         * \return A pointer to the value, or null on a miss.
+         */
+        Value* get(const Key& key)
+        {
+            const U32 idx = lookup(key);
+            if (idx == Npos32 || !resident(idx) || expired(idx))
+            {
+                ++_stats.misses;
+                return nullptr;
+            }
+
+            ++_stats.hits;
+            touch(idx);
+            return &_nodes[idx].value;
+        }
+
+        bool get(const Key& key, Value& dest)
+        {
+            if (const Value* value = get(key))
+            {
+                dest = *value;
+                return true;
+            }
+            return false;
+        }
+
+        /**
+         * \brief Tests for key without marking it or counting a hit or miss.
+         */
+        bool contains(const Key& key) const
+        {
+            const size_t pos = _index.find(key);
+            if (pos == Npos)
+                return false;
+
+            const Node& node = _nodes[_index.at(pos)];
+            return node.list <= Frequent && (node.expires == 0 || node.expires > _clock());
+        }
+
+        /**
+         * \brief Inserts or replaces the value of key.
+         * \param ttl The time to live in milliseconds. Zero uses the default
+         * set with setTtl, which in turn defaults to no expiry.
+         */
+        void put(const Key& key, const Value& value, const U64 ttl = 0)
+        {
+            U32 idx = lookup(key);
+            if (idx != Npos32 && resident(idx))
+            {
+                _nodes[idx].value = value;
+                touch(idx);
+            }
+            else if (_policy == CACHE_ARC)
+                idx = admitArc(key, value, idx);
+            else
+                idx = admit(key, value);
+
+            const U64 life   = ttl ? ttl : _ttl;
+            _nodes[idx].expires = life ? _clock() + life : 0;
+        }
+
+        bool erase(const Key& key)
+        {
+            const U32 idx = lookup(key);
+            if (idx == Npos32)
+                return false;
+
+            const bool wasResident = resident(idx);
+            release(idx);
+            return wasResident;
+        }
+
+        /**
+         * \brief Sets the time to live, in milliseconds, for entries
+         * put without one. Zero disables expiry.
+         */
+        void setTtl(const U64 ttl)
+        {
+            _ttl = ttl;
+        }
+
+        /**
+         * \brief Replaces the millisecond clock used for expiry.
+         */
+        void setClock(const Clock& clock)
+        {
+            if (clock)
+                _clock = clock;
+        }
+
+        const CacheStats& stats() const
+        {
+            return _stats;
+        }
+
+        void resetStats()
+        {
+            _stats = {};
+        }
+
+        U32 size() const
+        {
+            return _lists[Recent].size + _lists[Frequent].size;
+        }
+
+        bool empty() const
+        {
+            return size() == 0;
+        }
+
+        U32 capacity() const
+        {
+            return _capacity;
+        }
+
+        CachePolicy policy() const
+        {
+            return _policy;
+        }
+
+    private:
+        U32 lookup(const Key& key) const
+        {
+            const size_t pos = _index.find(key);
+            return pos == Npos ? Npos32 : _index.at(pos);
+        }
+
+        bool resident(const U32 idx) const
+        {
+            return _nodes[idx].list <= Frequent;
+        }
+
+        bool expired(const U32 idx)
+        {
+            const U64 expires = _nodes[idx].expires;
+            if (expires == 0 || expires > _clock())
+                return false;
+
+            ++_stats.expirations;
+            release(idx);
+            return true;
+        }
+
+        void touch(const U32 idx)
+        {
+            switch (_policy)
+            {
+            case CACHE_CLOCK:
+                _nodes[idx].referenced = true;
+                break;
+            case CACHE_ARC:
+                move(idx, Frequent);
+                break;
+            case CACHE_LRU:
+            default:
+                move(idx, Recent);
+                break;
+            }
+        }
+
+        U32 admit(const Key& key, const Value& value)
+        {
+            if (size() >= _capacity)
+            {
+                U32 victim = _lists[Recent].tail;
+                if (_policy == CACHE_CLOCK)
+                {
+                    // Give referenced entries a second pass; this
+                    // ends since every pass clears one reference.
+                    while (_nodes[victim].referenced)
+                    {
+                        _nodes[victim].referenced = false;
+                        move(victim, Recent);
+                        victim = _lists[Recent].tail;
+                    }
+                }
+                ++_stats.evictions;
+                release(victim);
+            }
+            return acquire(key, value, Recent);
+        }
+
+        U32 admitArc(const Key& key, const Value& value, const U32 ghost)
+        {
+            const U32 c  = _capacity;
+            const U32 t1 = _lists[Recent].size;
+            const U32 b1 = _lists[RecentGhost].size;
+            const U32 b2 = _lists[FrequentGhost].size;
+
+            if (ghost != Npos32)
+            {
+                // A ghost hit shows which list evicted too early,
+                // so shift the target size toward it.
+                const bool recent = _nodes[ghost].list == RecentGhost;
+                if (recent)
+                    _target = Min<U32>(c, _target + Max<U32>(b2 / b1, 1));
+                else
+                    _target = _target - Min<U32>(_target, Max<U32>(b1 / b2, 1));
+
+                release(ghost);
+                if (size() >= c)
+                    replace(!recent);
+                return acquire(key, value, Frequent);
+            }
+
+            if (t1 + b1 >= c)
+            {
+                if (t1 < c)
+                {
+                    release(_lists[RecentGhost].tail);
+                    if (size() >= c)
+                        replace(false);
+                }
+                else
+                {
+                    ++_stats.evictions;
+                    release(_lists[Recent].tail);
+                }
+            }
+            else if (size() + b1 + b2 >= c)
+            {
+                if (size() + b1 + b2 >= 2 * c)
+                    release(_lists[FrequentGhost].tail);
+                if (size() >= c)
+                    replace(false);
+            }
+            return acquire(key, value, Recent);
+        }
+
+        void replace(const bool frequentGhostHit)
+        {
+            const U32 t1 = _lists[Recent].size;
+
+            const List from = t1 > 0 && (t1 > _target || (frequentGhostHit && t1 == _target))
+                                  ? Recent
+                                  : Frequent;
+
+            const U32 victim = _lists[from].tail;
+            if (victim == Npos32)
+                return;
+
+            ++_stats.evictions;
+            _nodes[victim].value = Value{};
+            move(victim, from == Recent ? RecentGhost : FrequentGhost);
+        }
+
+        U32 acquire(const Key& key, const Value& value, const List list)
+        {
+            const U32 idx = _lists[Free].head;
+            RT_ASSERT(idx != Npos32)
+
+            Node& node      = _nodes[idx];
+            node.key        = key;
+            node.value      = value;
+            node.referenced = false;
+            move(idx, list);
+
+            _index.insert(key, idx);
+            return idx;
+        }
+
+        void release(const U32 idx)
+        {
+            Node& node = _nodes[idx];
+            _index.remove(node.key);
+
+            node.key     = Key{};
+            node.value   = Value{};
+            node.expires = 0;
+            move(idx, Free);
+        }
+
+        void move(const U32 idx, const List list)
+        {
+            unlink(idx);
+            pushFront(list, idx);
+        }
+
+        void pushFront(const U8 list, const U32 idx)
+        {
+            Node&  node  = _nodes[idx];
+            Links& links = _lists[list];
+
+            node.list = list;
+            node.prev = Npos32;
+            node.next = links.head;
+
+            if (links.head != Npos32)
+                _nodes[links.head].prev = idx;
+            else
+                links.tail = idx;
+
+            links.head = idx;
+            ++links.size;
+        }
+
+        void unlink(const U32 idx)
+        {
+            Node&  node  = _nodes[idx];
+            Links& links = _lists[node.list];
+
+            if (node.prev != Npos32)
+                _nodes[node.prev].next = node.next;
+            else
+                links.head = node.next;
+
+            if (node.next != Npos32)
+                _nodes[node.next].prev = node.prev;
+            else
+                links.tail = node.prev;
+
+            node.prev = node.next = Npos32;
+            --links.size;
+        }
+    };
+
+}  // namespace Rt2
@@ -23,14 +23,15 @@
     #define _CRT_SECURE_NO_WARNINGS 1
 #endif
 #include "Utils/Char.h"
-#include <bitset>
+#include <cctype>
+#include <cfloat>
+#include <cstdio>
 #include <cstdlib>
 #include <cstring>
-#include <iomanip>
 #include <limits>
 #include <sstream>
-#include "Utils/TextStreamWriter.h"
-#include "Utils/StreamMethods.h"
+#include "Utils/HexCodec.h"
+#include "Utils/NumberFormat.h"
 #include "Utils/String.h"
 #include "Utils/SymbolStream.h"
 
@@ -60,72 +61,288 @@ namespace Rt2
         return strncmp(a, b, std::min(al, bl)) == 0;
     }
 
-    int16_t Char::toInt16(const char* in, const int16_t def, const int base)
+    namespace
     {
-        if (in && *in)
+        template <typename T, typename W>
+        ParseResult narrow(ParseResult result, const W& wide, T& v)
+        {
+            if (result.error == PE_INVALID)
+                return result;
+
+            if (wide > W(std::numeric_limits<T>::max()))
+            {
+                v            = std::numeric_limits<T>::max();
+                result.error = PE_RANGE;
+            }
+            else if (wide < W(std::numeric_limits<T>::min()))
+            {
+                v            = std::numeric_limits<T>::min();
+                result.error = PE_RANGE;
+            }
+            else
+                v = T(wide);
+            return result;
+        }
+
+        // Handles the parts of the strtol syntax that NumberParse does not:
+        // leading white space, an explicit sign and the 0x prefix.
+        const char* skipPrefix(const char* in, bool& negative, int& base)
+        {
+            while (isspace((unsigned char)*in))
+                ++in;
+
+            negative = false;
+            if (*in == '-' || *in == '+')
+                negative = *in++ == '-';
+
+            if ((base == 0 || base == 16) &&
+                in[0] == '0' && (in[1] | 0x20) == 'x' && isxdigit((unsigned char)in[2]))
+            {
+                in += 2;
+                base = 16;
+            }
+            else if (base == 0)
+                base = *in == '0' ? 8 : 10;
+            return in;
+        }
+
+        int64_t toSigned(const char* in, int base)
+        {
+            bool negative;
+            in = skipPrefix(in, negative, base);
+
+            U64 mag = 0;
+
+            const ParseResult r = NumberParse::integer(in, in + strlen(in), mag, base);
+            if (r.error == PE_INVALID || mag == 0)
+                return 0;
+
+            if (negative)
+            {
+                if (r.error == PE_RANGE || mag - 1 > U64(std::numeric_limits<int64_t>::max()))
+                    return std::numeric_limits<int64_t>::min();
+                return -int64_t(mag - 1) - 1;
+            }
+
+            if (r.error == PE_RANGE || mag > U64(std::numeric_limits<int64_t>::max()))
+                return std::numeric_limits<int64_t>::max();
+            return int64_t(mag);
+        }
+
+        uint64_t toUnsigned(const char* in, int base)
+        {
+            bool negative;
+            in = skipPrefix(in, negative, base);
+
+            U64 mag = 0;
+
+            const ParseResult r = NumberParse::integer(in, in + strlen(in), mag, base);
+            if (r.error == PE_INVALID)
+                return 0;
+            if (r.error == PE_RANGE)
+                return std::numeric_limits<uint64_t>::max();
+
+            // like strtoull, a negative value wraps around
+            return negative ? 0 - mag : mag;
+        }
+
+        template <typename T>
+        T clamp(const int64_t v)
+        {
+            if (v > std::numeric_limits<T>::max())
+                return std::numeric_limits<T>::max();
+            if (v < std::numeric_limits<T>::min())
+                return std::numeric_limits<T>::min();
+            return static_cast<T>(v);
+        }
+
+        template <typename T>
+        T clamp(const uint64_t v)
+        {
+            if (v > std::numeric_limits<T>::max())
+                return std::numeric_limits<T>::max();
+            return static_cast<T>(v);
+        }
+
+        const char* skipLeading(const char* in)
         {
-            const long long v = std::strtoll(in, nullptr, base);
+            while (isspace((unsigned char)*in))
+                ++in;
+            if (*in == '+' && in[1] != '-')
+                ++in;
+            return in;
+        }
 
-            if (v > std::numeric_limits<int16_t>::max())
-                return std::numeric_limits<int16_t>::max();
+        constexpr char HexDigits[] = "0123456789ABCDEF";
 
-            if (v < std::numeric_limits<int16_t>::min())
-                return std::numeric_limits<int16_t>::min();
+        constexpr size_t CommaLength = NumberFormat::IntegerLength + NumberFormat::IntegerLength / 3;
+
+        size_t copyOut(char* buf, const size_t cap, const char* src, const size_t len)
+        {
+            if (!buf || len > cap)
+                return 0;
+            memcpy(buf, src, len);
+            return len;
+        }
+
+        template <typename T>
+        size_t formatInteger(char* buf, const size_t cap, const T v)
+        {
+            if (buf && cap >= NumberFormat::IntegerLength)
+                return NumberFormat::integer(buf, v);
 
-            return static_cast<int16_t>(v);
+            char tmp[NumberFormat::IntegerLength];
+            return copyOut(buf, cap, tmp, NumberFormat::integer(tmp, v));
         }
+
+        template <typename T>
+        size_t formatReal(char* buf, const size_t cap, const T v)
+        {
+            if (buf && cap >= NumberFormat::RealLength)
+                return NumberFormat::real(buf, v);
+
+            char tmp[NumberFormat::RealLength];
+            return copyOut(buf, cap, tmp, NumberFormat::real(tmp, v));
+        }
+
+        template <typename T>
+        size_t formatHexDigits(char* buf, const size_t cap, T v)
+        {
+            constexpr size_t len = sizeof(T) << 1;
+            if (!buf || cap < len)
+                return 0;
+
+            for (size_t i = len; i > 1; i -= 2)
+            {
+                buf[i - 1] = HexDigits[v & 0xF];
+                buf[i - 2] = HexDigits[v >> 4 & 0xF];
+                v          = T(v >> 4 >> 4);
+            }
+            return len;
+        }
+
+        template <typename T>
+        size_t formatBinaryDigits(char* buf, const size_t cap, const T v)
+        {
+            constexpr size_t len = sizeof(T) << 3;
+            if (!buf || cap < len)
+                return 0;
+
+            for (size_t i = 0; i < len; ++i)
+                buf[i] = char('0' + (v >> (len - 1 - i) & 1));
+            return len;
+        }
+
+        // Matches the output of a stream with std::fixed set, which
+        // writes with the classic locale whatever LC_NUMERIC is.
+        void formatFixed(String& dest, const double v, const int precision)
+        {
+            char      buf[64];
+            const int len = snprintf(buf, sizeof buf, "%.*f", precision, v);
+            if (len < 0)
+                dest.clear();
+            else if (len < (int)sizeof buf)
+                dest.assign(buf, NumberFormat::classicPoint(buf, U32(len)));
+            else
+            {
+                dest.resize(size_t(len));
+                snprintf(&dest[0], dest.size() + 1, "%.*f", precision, v);
+                dest.resize(NumberFormat::classicPoint(&dest[0], U32(len)));
+            }
+        }
+
+        template <typename T, size_t Length, size_t (*Format)(char*, size_t, T)>
+        void assign(String& dest, const T v)
+        {
+            char buf[Length];
+            dest.assign(buf, Format(buf, Length, v));
+        }
+
+    }  // namespace
+
+    ParseResult Char::parse(const char* first, const char* last, int16_t& v, const int base)
+    {
+        I64 wide = 0;
+        return narrow(NumberParse::integer(first, last, wide, base), wide, v);
+    }
+
+    ParseResult Char::parse(const char* first, const char* last, int32_t& v, const int base)
+    {
+        I64 wide = 0;
+        return narrow(NumberParse::integer(first, last, wide, base), wide, v);
+    }
+
+    ParseResult Char::parse(const char* first, const char* last, int64_t& v, const int base)
+    {
+        return NumberParse::integer(first, last, v, base);
+    }
+
+    ParseResult Char::parse(const char* first, const char* last, uint16_t& v, const int base)
+    {
+        U64 wide = 0;
+        return narrow(NumberParse::integer(first, last, wide, base), wide, v);
+    }
+
+    ParseResult Char::parse(const char* first, const char* last, uint32_t& v, const int base)
+    {
+        U64 wide = 0;
+        return narrow(NumberParse::integer(first, last, wide, base), wide, v);
+    }
+
+    ParseResult Char::parse(const char* first, const char* last, uint64_t& v, const int base)
+    {
+        return NumberParse::integer(first, last, v, base);
+    }
+
+    ParseResult Char::parse(const char* first, const char* last, float& v)
+    {
+        return NumberParse::real(first, last, v);
+    }
+
+    ParseResult Char::parse(const char* first, const char* last, double& v)
+    {
+        return NumberParse::real(first, last, v);
+    }
+
+    int16_t Char::toInt16(const char* in, const int16_t def, const int base)
+    {
+        if (in && *in)
+            return clamp<int16_t>(toSigned(in, base));
         return def;
     }
 
     int32_t Char::toInt32(const char* in, const int32_t def, const int base)
     {
         if (in && *in)
-        {
-            const long long v = std::strtoll(in, nullptr, base);
-            if (v > std::numeric_limits<int32_t>::max())
-                return std::numeric_limits<int32_t>::max();
-            if (v < std::numeric_limits<int32_t>::min())
-                return std::numeric_limits<int32_t>::min();
-            return static_cast<int32_t>(v);
-        }
+            return clamp<int32_t>(toSigned(in, base));
         return def;
     }
 
     int64_t Char::toInt64(const char* in, const int64_t def, const int base)
     {
         if (in && *in)
-            return std::strtoll(in, nullptr, base);
+            return toSigned(in, base);
         return def;
     }
 
     uint16_t Char::toUint16(const char* in, const uint16_t def, const int base)
     {
         if (in && *in)
-        {
-            const unsigned long long v = std::strtoull(in, nullptr, base);
-            if (v > std::numeric_limits<uint16_t>::max())
-                return std::numeric_limits<uint16_t>::max();
-            return static_cast<uint16_t>(v);
-        }
+            return clamp<uint16_t>(toUnsigned(in, base));
         return def;
     }
 
     uint32_t Char::toUint32(const char* in, const uint32_t def, const int base)
     {
         if (in && *in)
-        {
-            const unsigned long long v = std::strtoull(in, nullptr, base);
-            if (v > std::numeric_limits<uint32_t>::max())
-                return std::numeric_limits<uint32_t>::max();
-            return static_cast<uint32_t>(v);
-        }
+            return clamp<uint32_t>(toUnsigned(in, base));
         return def;
     }
 
     uint64_t Char::toUint64(const char* in, const uint64_t def, const int base)
     {
         if (in && *in)
-            return std::strtoull(in, nullptr, base);
+            return toUnsigned(in, base);
         return def;
     }
 
@@ -192,7 +409,17 @@ namespace Rt2
     float Char::toFloat(const char* in, const float& def)
     {
         if (in && *in)
-            return std::strtof(in, nullptr);
+        {
+            in = skipLeading(in);
+
+            const char* hex = *in == '-' ? in + 1 : in;
+            if (hex[0] == '0' && (hex[1] | 0x20) == 'x')
+                return std::strtof(in, nullptr);
+
+            float v = 0.f;
+            parse(in, in + strlen(in), v);
+            return v;
+        }
         return def;
     }
 
@@ -200,11 +427,16 @@ namespace Rt2
     {
         if (in && *in)
         {
-            InputStringStream ss(in);
+            in = skipLeading(in);
 
-            PrintR64 a(0);
-            a.from(ss);
-            return (double)a;
+            double v = 0.0;
+            if (parse(in, in + strlen(in), v).error == PE_RANGE)
+            {
+                // keep the result that stream extraction gave
+                v = v < 0 ? -std::numeric_limits<double>::max()
+                          : std::numeric_limits<double>::max();
+            }
+            return v;
         }
         return def;
     }
@@ -224,24 +456,124 @@ namespace Rt2
         return toDouble(in.c_str(), def);
     }
 
+    size_t Char::format(char* buf, const size_t cap, const int16_t v)
+    {
+        return formatInteger(buf, cap, int32_t(v));
+    }
+
+    size_t Char::format(char* buf, const size_t cap, const int32_t v)
+    {
+        return formatInteger(buf, cap, v);
+    }
+
+    size_t Char::format(char* buf, const size_t cap, const int64_t v)
+    {
+        return formatInteger(buf, cap, v);
+    }
+
+    size_t Char::format(char* buf, const size_t cap, const uint16_t v)
+    {
+        return formatInteger(buf, cap, uint32_t(v));
+    }
+
+    size_t Char::format(char* buf, const size_t cap, const uint32_t v)
+    {
+        return formatInteger(buf, cap, v);
+    }
+
+    size_t Char::format(char* buf, const size_t cap, const uint64_t v)
+    {
+        return formatInteger(buf, cap, v);
+    }
+
+    size_t Char::format(char* buf, const size_t cap, const float v)
+    {
+        return formatReal(buf, cap, v);
+    }
+
+    size_t Char::format(char* buf, const size_t cap, const double v)
+    {
+        return formatReal(buf, cap, v);
+    }
+
+    size_t Char::formatHex(char* buf, const size_t cap, const uint8_t v)
+    {
+        return formatHexDigits(buf, cap, v);
+    }
+
+    size_t Char::formatHex(char* buf, const size_t cap, const uint16_t v)
+    {
+        return formatHexDigits(buf, cap, v);
+    }
+
+    size_t Char::formatHex(char* buf, const size_t cap, const uint32_t v)
+    {
+        return formatHexDigits(buf, cap, v);
+    }
+
+    size_t Char::formatHex(char* buf, const size_t cap, const uint64_t v)
+    {
+        return formatHexDigits(buf, cap, v);
+    }
+
+    size_t Char::formatBinary(char* buf, const size_t cap, const uint8_t v)
+    {
+        return formatBinaryDigits(buf, cap, v);
+    }
+
+    size_t Char::formatBinary(char* buf, const size_t cap, const uint16_t v)
+    {
+        return formatBinaryDigits(buf, cap, v);
+    }
+
+    size_t Char::formatBinary(char* buf, const size_t cap, const uint32_t v)
+    {
+        return formatBinaryDigits(buf, cap, v);
+    }
+
+    size_t Char::formatBinary(char* buf, const size_t cap, const uint64_t v)
+    {
+        return formatBinaryDigits(buf, cap, v);
+    }
+
+    size_t Char::formatComma(char* buf, const size_t cap, const size_t v)
+    {
+        char         tmp[NumberFormat::IntegerLength];
+        const size_t len   = NumberFormat::integer(tmp, U64(v));
+        const size_t total = len + (len - 1) / 3;
+        if (!buf || cap < total)
+            return 0;
+
+        // the first group holds whatever is left over from the groups of three
+        size_t group = len % 3 == 0 ? 3 : len % 3;
+        size_t j     = 0;
+        for (size_t i = 0; i < len; ++i)
+        {
+            if (group == 0)
+            {
+                buf[j++] = ',';
+                group    = 3;
+            }
+            buf[j++] = tmp[i];
+            --group;
+        }
+        return total;
+    }
+
     void Char::toString(String& dest, const float v, const bool sci)
     {
-        OutputStringStream oss;
         if (sci)
-            Ts::print(oss, PrintR32Sci(v));
+            assign<float, NumberFormat::RealLength, format>(dest, v);
         else
-            Ts::print(oss, PrintR32(v));
-        dest = oss.str();
+            formatFixed(dest, v, FLT_DIG);
     }
 
     void Char::toString(String& dest, const double v, const bool sci)
     {
-        OutputStringStream oss;
         if (sci)
-            Ts::print(oss, PrintR64Sci(v));
+            assign<double, NumberFormat::RealLength, format>(dest, v);
         else
-            Ts::print(oss, PrintR64(v));
-        dest = oss.str();
+            formatFixed(dest, v, DBL_DIG);
     }
 
     void Char::toString(String& dest, const bool v)
@@ -277,9 +609,7 @@ namespace Rt2
 
     void Char::toString(String& dest, const int16_t v)
     {
-        OutputStringStream oss;
-        Ts::print(oss, v);
-        dest = oss.str();
+        assign<int16_t, NumberFormat::IntegerLength, format>(dest, v);
     }
 
     String Char::toString(const int16_t v)
@@ -291,9 +621,7 @@ namespace Rt2
 
     void Char::toString(String& dest, const int32_t v)
     {
-        OutputStringStream oss;
-        Ts::print(oss, v);
-        dest = oss.str();
+        assign<int32_t, NumberFormat::IntegerLength, format>(dest, v);
     }
 
     String Char::toString(const int32_t v)
@@ -305,9 +633,7 @@ namespace Rt2
 
     void Char::toString(String& dest, const int64_t v)
     {
-        OutputStringStream oss;
-        Ts::print(oss, v);
-        dest = oss.str();
+        assign<int64_t, NumberFormat::IntegerLength, format>(dest, v);
     }
 
     String Char::toString(const int64_t v)
@@ -319,9 +645,7 @@ namespace Rt2
 
     void Char::toString(String& dest, const uint16_t v)
     {
-        OutputStringStream oss;
-        Ts::print(oss, v);
-        dest = oss.str();
+        assign<uint16_t, NumberFormat::IntegerLength, format>(dest, v);
     }
 
     String Char::toString(const uint16_t v)
@@ -333,9 +657,7 @@ namespace Rt2
 
     void Char::toString(String& dest, const uint32_t v)
     {
-        OutputStringStream oss;
-        Ts::print(oss, v);
-        dest = oss.str();
+        assign<uint32_t, NumberFormat::IntegerLength, format>(dest, v);
     }
 
     String Char::toString(const uint32_t v)
@@ -347,9 +669,7 @@ namespace Rt2
 
     void Char::toString(String& dest, const uint64_t v)
     {
-        OutputStringStream oss;
-        Ts::print(oss, v);
-        dest = oss.str();
+        assign<uint64_t, NumberFormat::IntegerLength, format>(dest, v);
     }
 
     String Char::toString(const uint64_t v)
@@ -361,18 +681,13 @@ namespace Rt2
 
     void Char::toHexString(String& dest, const void* p, const size_t len)
     {
-        OutputStringStream oss;
-        const char*        ch = (const char*)p;
-        for (uint32_t i = 0; i < len; ++i)
-            Ts::print(oss, Hex((uint8_t)ch[i]));
-        dest = oss.str();
+        dest.clear();
+        HexCodec::encode(dest, p, len);
     }
 
     void Char::toHexString(String& dest, const uint8_t v)
     {
-        std::ostringstream oss;
-        Ts::print(oss, Hex(v));
-        dest = oss.str();
+        assign<uint8_t, sizeof(uint8_t) << 1, formatHex>(dest, v);
     }
 
     String Char::toHexString(const uint8_t v)
@@ -384,9 +699,7 @@ namespace Rt2
 
     void Char::toHexString(String& dest, const uint16_t v)
     {
-        std::ostringstream oss;
-        Ts::print(oss, Hex(v));
-        dest = oss.str();
+        assign<uint16_t, sizeof(uint16_t) << 1, formatHex>(dest, v);
     }
 
     String Char::toHexString(const uint16_t v)
@@ -398,9 +711,7 @@ namespace Rt2
 
     void Char::toHexString(String& dest, const uint32_t v)
     {
-        std::ostringstream oss;
-        Ts::print(oss, Hex(v));
-        dest = oss.str();
+        assign<uint32_t, sizeof(uint32_t) << 1, formatHex>(dest, v);
     }
 
     String Char::toHexString(const uint32_t v)
@@ -412,9 +723,7 @@ namespace Rt2
 
     void Char::toHexString(String& dest, const uint64_t v)
     {
-        std::ostringstream oss;
-        Ts::print(oss, Hex(v));
-        dest = oss.str();
+        assign<uint64_t, sizeof(uint64_t) << 1, formatHex>(dest, v);
     }
 
     String Char::toHexString(const uint64_t v)
@@ -426,8 +735,7 @@ namespace Rt2
 
     void Char::toBinaryString(String& dest, const uint8_t v)
     {
-        const std::bitset<8> bs(v);
-        dest = bs.to_string();
+        assign<uint8_t, 8, formatBinary>(dest, v);
     }
 
     String Char::toBinaryString(const uint8_t v)
@@ -439,8 +747,7 @@ namespace Rt2
 
     void Char::toBinaryString(String& dest, const uint16_t v)
     {
-        const std::bitset<16> bs(v);
-        dest = bs.to_string();
+        assign<uint16_t, 16, formatBinary>(dest, v);
     }
 
     String Char::toBinaryString(const uint16_t v)
@@ -452,8 +759,7 @@ namespace Rt2
 
     void Char::toBinaryString(String& dest, const uint32_t v)
     {
-        const std::bitset<32> bs(v);
-        dest = bs.to_string();
+        assign<uint32_t, 32, formatBinary>(dest, v);
     }
 
     String Char::toBinaryString(const uint32_t v)
@@ -465,8 +771,7 @@ namespace Rt2
 
     void Char::toBinaryString(String& dest, const uint64_t v)
     {
-        const std::bitset<64> bs(v);
-        dest = bs.to_string();
+        assign<uint64_t, 64, formatBinary>(dest, v);
     }
 
     String Char::toBinaryString(const uint64_t v)
@@ -534,29 +839,7 @@ namespace Rt2
 
     void Char::commaInt(String& dest, const size_t& iv)
     {
-        dest.clear();
-
-        const String tmp = toString(iv);
-
-        if (size_t s = tmp.size(); s > 3)
-        {
-            const size_t k = s % 3;
-            size_t       j = k == 0 ? 1 : 0;
-            for (size_t i = 0; i < s; ++i)
-            {
-                if (i + 1 >= k)
-                {
-                    dest.push_back(tmp[i]);
-                    if (j % 3 == 0 && (i + 1) < s)
-                        dest.push_back(',');
-                    j++;
-                }
-                else
-                    dest.push_back(tmp[i]);
-            }
-        }
-        else
-            dest = tmp;
+        assign<size_t, CommaLength, formatComma>(dest, iv);
     }
 
     String Char::commaInt(const size_t& iv)
@@ -21,6 +21,7 @@
 */
 #pragma once
 #include <cstdint>
+#include "Utils/NumberParse.h"
 #include "Utils/String.h"
 
 namespace Rt2
@@ -33,6 +34,28 @@ namespace Rt2
         static bool equals(const char* a, const char* b, size_t max);
         static bool equals(const char* a, size_t al, const char* b, size_t bl);
 
+        /**
+         * \brief Parses the number at the start of [first, last).
+         *
+         * Follows the rules of NumberParse. Values that do not fit in the
+         * destination are clamped to its range and reported with PE_RANGE.
+         */
+        static ParseResult parse(const char* first, const char* last, int16_t& v, int base = 10);
+
+        static ParseResult parse(const char* first, const char* last, int32_t& v, int base = 10);
+
+        static ParseResult parse(const char* first, const char* last, int64_t& v, int base = 10);
+
+        static ParseResult parse(const char* first, const char* last, uint16_t& v, int base = 10);
+
+        static ParseResult parse(const char* first, const char* last, uint32_t& v, int base = 10);
+
+        static ParseResult parse(const char* first, const char* last, uint64_t& v, int base = 10);
+
+        static ParseResult parse(const char* first, const char* last, float& v);
+
+        static ParseResult parse(const char* first, const char* last, double& v);
+
         static int16_t toInt16(const char* in,
                                int16_t     def  = -1,
                                int         base = 10);
@@ -95,6 +118,63 @@ namespace Rt2
 
         static double toDouble(const String& in, const double& def = 0.0);
 
+        /**
+         * \brief Writes v into buf without a null terminator.
+         *
+         * None of the format functions allocate. Integers are written in
+         * decimal, reals in the shortest form that reads back exactly.
+         * \return The number of characters written, or zero if cap is too
+         * small to hold the result.
+         */
+        static size_t format(char* buf, size_t cap, int16_t v);
+
+        static size_t format(char* buf, size_t cap, int32_t v);
+
+        static size_t format(char* buf, size_t cap, int64_t v);
+
+        static size_t format(char* buf, size_t cap, uint16_t v);
+
+        static size_t format(char* buf, size_t cap, uint32_t v);
+
+        static size_t format(char* buf, size_t cap, uint64_t v);
+
+        static size_t format(char* buf, size_t cap, float v);
+
+        static size_t format(char* buf, size_t cap, double v);
+
+        /**
+         * \brief Zero padded, upper case hex with two digits per byte of v.
+         */
+        static size_t formatHex(char* buf, size_t cap, uint8_t v);
+
+        static size_t formatHex(char* buf, size_t cap, uint16_t v);
+
+        static size_t formatHex(char* buf, size_t cap, uint32_t v);
+
+        static size_t formatHex(char* buf, size_t cap, uint64_t v);
+
+        /**
+         * \brief Zero padded with one digit per bit of v.
+         */
+        static size_t formatBinary(char* buf, size_t cap, uint8_t v);
+
+        static size_t formatBinary(char* buf, size_t cap, uint16_t v);
+
+        static size_t formatBinary(char* buf, size_t cap, uint32_t v);
+
+        static size_t formatBinary(char* buf, size_t cap, uint64_t v);
+
+        /**
+         * \brief Decimal with a comma between each group of three digits.
+         */
+        static size_t formatComma(char* buf, size_t cap, size_t v);
+
+        /**
+         * \brief Converts v to text.
+         * \param sci When true v is written in the shortest form that
+         * reads back exactly, otherwise in fixed notation with FLT_DIG or
+         * DBL_DIG decimal places.
+         */
         static void toString(String& dest, float v, bool sci=false);
 
         static void toString(String& dest, double v, bool sci=false);
@@ -176,77 +256,131 @@ namespace Rt2
         static String commaInt(const size_t& iv);
     };
 
+    enum CharClass
+    {
+        CC_NONE      = 0,
+        CC_NEWLINE   = 1 << 0,
+        CC_SPACE     = 1 << 1,
+        CC_DECIMAL   = 1 << 2,
+        CC_LOWER     = 1 << 3,
+        CC_UPPER     = 1 << 4,
+        CC_SIGN      = 1 << 5,
+        CC_REAL      = 1 << 6,
+        CC_PRINTABLE = 1 << 7,
+        CC_QUOTE     = 1 << 8,
+        CC_LETTER    = CC_LOWER | CC_UPPER,
+        CC_ALNUM     = CC_LETTER | CC_DECIMAL,
+    };
+
+    /**
+     * \brief One entry of CharClass bits per byte value.
+     */
+    struct CharClassTable
+    {
+        uint16_t bits[256]{};
+
+        constexpr CharClassTable()
+        {
+            for (int ch = 0; ch < 256; ++ch)
+            {
+                uint16_t v = 0;
+                if (ch == '\r' || ch == '\n')
+                    v |= CC_NEWLINE | CC_SPACE;
+                if (ch == ' ' || ch == '\t')
+                    v |= CC_SPACE;
+                if (ch >= '0' && ch <= '9')
+                    v |= CC_DECIMAL | CC_REAL;
+                if (ch >= 'a' && ch <= 'z')
+                    v |= CC_LOWER;
+                if (ch >= 'A' && ch <= 'Z')
+                    v |= CC_UPPER;
+                if (ch == '-')
+                    v |= CC_SIGN | CC_REAL;
+                if (ch == '+' || ch == 'E' || ch == 'e' || ch == 'F' || ch == 'f' || ch == '.')
+                    v |= CC_REAL;
+                if (ch >= 32 && ch < 128)
+                    v |= CC_PRINTABLE;
+                if (ch == '"' || ch == '\'')
+                    v |= CC_QUOTE;
+                bits[ch] = v;
+            }
+        }
+    };
+
+    inline constexpr CharClassTable CharClasses;
+
+    /**
+     * \return True if ch is a byte value with any of the CharClass bits
+     * in mask. Values outside of [0, 255], such as negative chars, have none.
+     */
+    constexpr bool isClass(const int ch, const int mask)
+    {
+        return (unsigned)ch < 256 && (CharClasses.bits[ch] & mask) != 0;
+    }
+
     inline bool isNewLine(const int constant)
     {
-        return constant == '\r' || constant == '\n';
+        return isClass(constant, CC_NEWLINE);
     }
 
     inline bool isWhiteSpace(const int ch)
     {
-        return ch == ' ' || ch == '\t' || isNewLine(ch);
+        return isClass(ch, CC_SPACE);
     }
 
     inline bool isWs(const int ch)
     {
-        return ch == ' ' || ch == '\t' || isNewLine(ch);
+        return isClass(ch, CC_SPACE);
     }
 
     inline bool isDecimal(const int ch)
     {
-        return ch >= '0' && ch <= '9';
+        return isClass(ch, CC_DECIMAL);
     }
 
     inline bool isLower(const int ch)
     {
-        return ch >= 'a' && ch <= 'z';
+        return isClass(ch, CC_LOWER);
     }
 
     inline bool isUpper(const int ch)
     {
-        return ch >= 'A' && ch <= 'Z';
+        return isClass(ch, CC_UPPER);
     }
 
     inline bool isLetter(const int ch)
     {
-        return isLower(ch) || isUpper(ch);
+        return isClass(ch, CC_LETTER);
     }
 
     inline bool isInteger(const int ch)
     {
-        return isDecimal(ch) || ch == '-';
+        return isClass(ch, CC_DECIMAL | CC_SIGN);
     }
 
     inline bool isReal(const int ch)
     {
-        return isDecimal(ch) || ch == '-' ||
-               ch == '+' ||
-               ch == 'E' ||
-               ch == 'e' ||
-               ch == 'F' ||
-               ch == 'f' ||
-               ch == '.';
+        return isClass(ch, CC_REAL);
     }
 
     inline bool isPrintable(const int constant)
     {
-        return constant >= 32 && constant < 128;
+        return isClass(constant, CC_PRINTABLE);
     }
 
     inline bool isPrintableAscii(const int constant)
     {
-        return isPrintable(constant) ||
-               isWhiteSpace(constant) ||
-               isNewLine(constant);
+        return isClass(constant, CC_PRINTABLE | CC_SPACE);
     }
 
     inline bool isAlphaNumeric(const int ch)
     {
-        return isLower(ch) || isUpper(ch) || isDecimal(ch);
+        return isClass(ch, CC_ALNUM);
     }
 
     inline bool isQuote(const int ch)
     {
-        return ch == '"' || ch == '\'';
+        return isClass(ch, CC_QUOTE);
     }
 
     using Ch = Char;
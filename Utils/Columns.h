@@ -0,0 +1,343 @@
+/*
+-------------------------------------------------------------------------------
+    Copyright (c) Charles Carley.
+
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+-------------------------------------------------------------------------------
+*/
+#pragma once
+
+#include <tuple>
+#include <utility>
+#include "Utils/Allocator.h"
+#include "Utils/Array.h"
+#include "Utils/Definitions.h"
+
+namespace Rt2
+{
+    /**
+     * \brief Non owning view of one column of a Columns container.
+     */
+    template <typename T>
+    class ColumnSpan
+    {
+    private:
+        T*  _data{nullptr};
+        U32 _size{0};
+
+    public:
+        ColumnSpan() = default;
+
+        ColumnSpan(T* data, const U32 size) :
+            _data(data),
+            _size(size)
+        {
+        }
+
+        T* data() const
+        {
+            return _data;
+        }
+
+        U32 size() const
+        {
+            return _size;
+        }
+
+        bool empty() const
+        {
+            return _size == 0;
+        }
+
+        T* begin() const
+        {
+            return _data;
+        }
+
+        T* end() const
+        {
+            return _data + _size;
+        }
+
+        T& operator[](const U32 idx) const
+        {
+            RT_ASSERT(idx < _size)
+            return _data[idx];
+        }
+    };
+
+    /**
+     * \brief Structure of arrays container.
+     *
+     * Each field is kept in its own cache line aligned buffer so that loops
+     * which only touch a few fields only pull those fields into the cache.
+     * Rows are pushed and removed across every column at once, and removal
+     * is unordered like Array::remove.
+     */
+    template <typename... Ts>
+    class Columns
+    {
+    public:
+        static constexpr size_t ColumnCount = sizeof...(Ts);
+        static constexpr U32    Alignment   = 64;
+
+        static_assert(ColumnCount > 0, "at least one column is required");
+
+        template <size_t I>
+        using ColumnType = std::tuple_element_t<I, std::tuple<Ts...>>;
+
+        template <typename T>
+        using Column = Array<T, AOP_DEFAULT_TYPE, AlignedAllocator<T, U32, Alignment>>;
+
+        template <bool Const>
+        class RowProxy
+        {
+        private:
+            using Owner = std::conditional_t<Const, const Columns, Columns>;
+
+            Owner* _owner;
+            U32    _row;
+
+            friend class Columns;
+
+            RowProxy(Owner* owner, const U32 row) :
+                _owner(owner),
+                _row(row)
+            {
+            }
+
+        public:
+            template <size_t I>
+            auto& get() const
+            {
+                return _owner->template at<I>(_row);
+            }
+
+            U32 index() const
+            {
+                return _row;
+            }
+
+            std::tuple<Ts...> values() const
+            {
+                return _owner->values(_row);
+            }
+        };
+
+        using Row      = RowProxy<false>;
+        using ConstRow = RowProxy<true>;
+
+    private:
+        std::tuple<Column<Ts>...> _columns;
+        U32                       _size{0};
+
+    public:
+        Columns() = default;
+
+        Columns(const Columns&) = default;
+
+        ~Columns() = default;
+
+        Columns& operator=(const Columns&) = default;
+
+        /**
+         * \brief Appends one row; one value per column.
+         * \return The index of the new row.
+         */
+        U32 push_back(const Ts&... values)
+        {
+            if (_size + 1 > Allocator<U8, U32>::limit)
+                throw Exception("Allocation limit (", Allocator<U8, U32>::limit, ") exceed");
+            if (_size + 1 > capacity())
+                reserve(_size == 0 ? 16 : _size * 2);
+
+            pushImpl(std::index_sequence_for<Ts...>{}, values...);
+            return _size++;
+        }
+
+        /**
+         * \brief Removes a row by moving the last row into its place.
+         */
+        void remove(const U32 row)
+        {
+            if (row >= _size)
+                throw Exception("row index ", row, " out of range");
+            removeImpl(std::index_sequence_for<Ts...>{}, row);
+            --_size;
+        }
+
+        /**
+         * \brief Removes a row and shifts the rows after it down by one.
+         */
+        void removeOrdered(const U32 row)
+        {
+            if (row >= _size)
+                throw Exception("row index ", row, " out of range");
+            removeOrderedImpl(std::index_sequence_for<Ts...>{}, row);
+            --_size;
+        }
+
+        void pop_back()
+        {
+            if (_size > 0)
+                remove(_size - 1);
+        }
+
+        void reserve(const U32 rows)
+        {
+            reserveImpl(std::index_sequence_for<Ts...>{}, rows);
+        }
+
+        void clear()
+        {
+            clearImpl(std::index_sequence_for<Ts...>{});
+            _size = 0;
+        }
+
+        template <size_t I>
+        ColumnSpan<ColumnType<I>> column()
+        {
+            return {std::get<I>(_columns).data(), _size};
+        }
+
+        template <size_t I>
+        ColumnSpan<const ColumnType<I>> column() const
+        {
+            return {std::get<I>(_columns).data(), _size};
+        }
+
+        template <size_t I>
+        ColumnType<I>& at(const U32 row)
+        {
+            RT_ASSERT(row < _size)
+            return std::get<I>(_columns).data()[row];
+        }
+
+        template <size_t I>
+        const ColumnType<I>& at(const U32 row) const
+        {
+            RT_ASSERT(row < _size)
+            return std::get<I>(_columns).data()[row];
+        }
+
+        std::tuple<Ts...> values(const U32 row) const
+        {
+            return valuesImpl(std::index_sequence_for<Ts...>{}, row);
+        }
+
+        Row row(const U32 row)
+        {
+            RT_ASSERT(row < _size)
+            return {this, row};
+        }
+
+        ConstRow row(const U32 row) const
+        {
+            RT_ASSERT(row < _size)
+            return {this, row};
+        }
+
+        Row operator[](const U32 row)
+        {
+            return this->row(row);
+        }
+
+        ConstRow operator[](const U32 row) const
+        {
+            return this->row(row);
+        }
+
+        U32 size() const
+        {
+            return _size;
+        }
+
+        bool empty() const
+        {
+            return _size == 0;
+        }
+
+        U32 capacity() const
+        {
+            return std::get<0>(_columns).capacity();
+        }
+
+    private:
+        template <size_t... I>
+        void pushImpl(std::index_sequence<I...>, const Ts&... values)
+        {
+            (std::get<I>(_columns).push_back(values), ...);
+        }
+
+        template <size_t... I>
+        void removeImpl(std::index_sequence<I...>, const U32 row)
+        {
+            (removeFrom(std::get<I>(_columns), row), ...);
+        }
+
+        template <size_t... I>
+        void removeOrderedImpl(std::index_sequence<I...>, const U32 row)
+        {
+            (removeOrderedFrom(std::get<I>(_columns), row), ...);
+        }
+
+        template <size_t... I>
+        void reserveImpl(std::index_sequence<I...>, const U32 rows)
+        {
+            (std::get<I>(_columns).reserve(rows), ...);
+        }
+
+        template <size_t... I>
+        void clearImpl(std::index_sequence<I...>)
+        {
+            (std::get<I>(_columns).clear(), ...);
+        }
+
+        template <size_t... I>
+        std::tuple<Ts...> valuesImpl(std::index_sequence<I...>, const U32 row) const
+        {
+            return std::tuple<Ts...>(at<I>(row)...);
+        }
+
+        // Elements are always constructed by the allocator, so the
+        // vacated slot is reset rather than destroyed.
+        template <typename T>
+        static void removeFrom(Column<T>& col, const U32 row)
+        {
+            const U32 last = col.size() - 1;
+
+            T* data = col.data();
+            if (row != last)
+                data[row] = std::move(data[last]);
+            data[last] = T();
+            col.resizeFast(last);
+        }
+
+        template <typename T>
+        static void removeOrderedFrom(Column<T>& col, const U32 row)
+        {
+            const U32 last = col.size() - 1;
+
+            T* data = col.data();
+            for (U32 i = row; i < last; ++i)
+                data[i] = std::move(data[i + 1]);
+            data[last] = T();
+            col.resizeFast(last);
+        }
+    };
+
+}  // namespace Rt2
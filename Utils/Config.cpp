@@ -248,6 +248,11 @@ namespace Rt2
         Su::splitRejectEmpty(values, string(key), ',');
     }
 
+    void Config::csv(const String& key, StringTable& values)
+    {
+        Su::splitRejectEmpty(values, string(key), ',');
+    }
+
     const StringMap& Config::attributes() const
     {
         return _attributes;
@@ -76,6 +76,8 @@ namespace Rt2
 
         void csv(const String& key, StringArray &values);
 
+        void csv(const String& key, StringTable& values);
+
         const StringMap& attributes() const;
     };
 
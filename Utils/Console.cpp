@@ -25,6 +25,7 @@
 #include <sstream>
 #include "FixedString.h"
 #include "Utils/Char.h"
+#include "Utils/HexCodec.h"
 #include "Utils/Path.h"
 #include "Utils/TextStreamWriter.h"
 #ifdef _WIN32
@@ -228,61 +229,10 @@ namespace Rt2
         Detail::Private::error(str);
     }
 
-    void printHexLine(OStream&     dest,
-                      const char*  buffer,
-                      const size_t offs,
-                      const size_t max)
-    {
-        if (!buffer)
-            return;
-
-        size_t        i, j;
-        unsigned char ch;
-
-        for (i = 0x00; i < 0x10; ++i)
-        {
-            j = i + offs;
-            if (i % 0x09 == 0x08)
-                dest << ' ';
-            if (j >= max)
-                dest << "00 ";
-            else
-            {
-                ch = buffer[j];
-                dest << std::setfill('0')
-                     << std::setw(2)
-                     << std::uppercase
-                     << std::hex << (unsigned int)ch
-                     << ' ';
-            }
-        }
-
-        dest << '|';
-        for (i = 0x00; i < 0x10; ++i)
-        {
-            j = i + offs;
-            if (j >= max)
-                dest << '.';
-            else
-            {
-                ch = buffer[j];
-                if (ch >= 0x20 && ch < 0x7F)
-                    dest << (char)ch;
-                else
-                    dest << '.';
-            }
-        }
-        dest << '|';
-        dest << '\n';
-    }
-
     void printHex(OStream& dest, const char* buffer, const uint32_t len)
     {
         if (buffer)
-        {
-            for (size_t i = 0; i < len; i += 0x10)
-                printHexLine(dest, buffer, i, len);
-        }
+            HexCodec::dump(dest, buffer, len);
     }
 
     void printHex(const char* buffer, const uint32_t len)
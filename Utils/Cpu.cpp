@@ -0,0 +1,132 @@
+/*
+-------------------------------------------------------------------------------
+    Copyright (c) Charles Carley.
+
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+-------------------------------------------------------------------------------
+*/
+#include "Utils/Cpu.h"
+#include <atomic>
+
+#if RT_ARCH_X64
+    #if RT_COMPILER == RT_COMPILER_MSVC
+        #include <intrin.h>
+    #else
+        #include <cpuid.h>
+    #endif
+#endif
+
+namespace Rt2
+{
+    namespace
+    {
+        std::atomic<int> LevelCap{SIMD_AVX2};
+
+#if RT_ARCH_X64
+        void cpuid(const U32 leaf, const U32 sub, U32 reg[4])
+        {
+    #if RT_COMPILER == RT_COMPILER_MSVC
+            int out[4];
+            __cpuidex(out, (int)leaf, (int)sub);
+            for (int i = 0; i < 4; ++i)
+                reg[i] = (U32)out[i];
+    #else
+            if (!__get_cpuid_count(leaf, sub, &reg[0], &reg[1], &reg[2], &reg[3]))
+                reg[0] = reg[1] = reg[2] = reg[3] = 0;
+    #endif
+        }
+
+        U64 xgetbv()
+        {
+            // Clang's _xgetbv needs the xsave target, clang-cl
+            // takes the inline assembly instead.
+    #if RT_COMPILER == RT_COMPILER_MSVC && !defined(__clang__)
+            return _xgetbv(0);
+    #else
+            U32 eax, edx;
+            __asm__ volatile("xgetbv"
+                             : "=a"(eax), "=d"(edx)
+                             : "c"(0));
+            return U64(edx) << 32 | eax;
+    #endif
+        }
+#endif
+
+        CpuFeatures detect()
+        {
+            CpuFeatures cpu;
+#if RT_ARCH_X64
+            U32 reg[4];
+            cpuid(0, 0, reg);
+            const U32 maxLeaf = reg[0];
+
+            cpuid(1, 0, reg);
+            cpu.sse2   = (reg[3] >> 26 & 1) != 0;
+            cpu.ssse3  = (reg[2] >> 9 & 1) != 0;
+            cpu.sse41  = (reg[2] >> 19 & 1) != 0;
+            cpu.sse42  = (reg[2] >> 20 & 1) != 0;
+            cpu.popcnt = (reg[2] >> 23 & 1) != 0;
+
+            // AVX also needs the OS to save the YMM registers.
+            const bool osxsave = (reg[2] >> 27 & 1) != 0;
+            cpu.avx            = (reg[2] >> 28 & 1) != 0 && osxsave && (xgetbv() & 6) == 6;
+
+            if (maxLeaf >= 7)
+            {
+                cpuid(7, 0, reg);
+                cpu.avx2 = cpu.avx && (reg[1] >> 5 & 1) != 0;
+                cpu.bmi1 = (reg[1] >> 3 & 1) != 0;
+                cpu.bmi2 = (reg[1] >> 8 & 1) != 0;
+            }
+#endif
+            return cpu;
+        }
+    }  // namespace
+
+    const CpuFeatures& Cpu::features()
+    {
+        static const CpuFeatures cpu = detect();
+        return cpu;
+    }
+
+    SimdLevel Cpu::detected()
+    {
+        static const SimdLevel level = []
+        {
+            const CpuFeatures& cpu = features();
+            if (cpu.avx2 && cpu.sse42 && cpu.popcnt && cpu.bmi1 && cpu.bmi2)
+                return SIMD_AVX2;
+            if (cpu.sse42 && cpu.ssse3 && cpu.popcnt)
+                return SIMD_SSE42;
+            if (cpu.sse2)
+                return SIMD_SSE2;
+            return SIMD_SCALAR;
+        }();
+        return level;
+    }
+
+    SimdLevel Cpu::level()
+    {
+        return (SimdLevel)Min<int>(detected(), LevelCap.load(std::memory_order_relaxed));
+    }
+
+    void Cpu::setLevel(const SimdLevel maximum)
+    {
+        LevelCap.store(maximum, std::memory_order_relaxed);
+    }
+
+}  // namespace Rt2
@@ -0,0 +1,92 @@
+/*
+-------------------------------------------------------------------------------
+    Copyright (c) Charles Carley.
+
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+-------------------------------------------------------------------------------
+*/
+#pragma once
+
+#include "Utils/Definitions.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+    #define RT_ARCH_X64 1
+#else
+    #define RT_ARCH_X64 0
+#endif
+
+// Marks a function as compiled for an instruction set that the rest of the
+// build does not assume. Only call such a function after checking Cpu::level.
+// Clang needs it to inline the intrinsics, clang-cl included.
+#if RT_ARCH_X64 && (defined(__clang__) || RT_COMPILER == RT_COMPILER_GNU)
+    #define RT_TARGET_SSE42 __attribute__((target("sse4.2,popcnt")))
+    #define RT_TARGET_AVX2 __attribute__((target("avx2,bmi,bmi2,popcnt")))
+#else
+    #define RT_TARGET_SSE42
+    #define RT_TARGET_AVX2
+#endif
+
+namespace Rt2
+{
+    enum SimdLevel
+    {
+        SIMD_SCALAR = 0,
+        SIMD_SSE2,
+        SIMD_SSE42,
+        SIMD_AVX2,
+    };
+
+    struct CpuFeatures
+    {
+        bool sse2{false};
+        bool ssse3{false};
+        bool sse41{false};
+        bool sse42{false};
+        bool popcnt{false};
+        bool avx{false};
+        bool avx2{false};
+        bool bmi1{false};
+        bool bmi2{false};
+    };
+
+    class Cpu
+    {
+    public:
+        /**
+         * \return The features reported by the processor and enabled by the OS.
+         */
+        static const CpuFeatures& features();
+
+        /**
+         * \return The highest SIMD level that both the processor supports
+         * and is allowed by setLevel.
+         */
+        static SimdLevel level();
+
+        /**
+         * \brief Caps the SIMD level used by dispatching code. Mainly for
+         * testing and benchmarking the scalar fallbacks.
+         */
+        static void setLevel(SimdLevel maximum);
+
+        /**
+         * \return The SIMD level supported by the processor.
+         */
+        static SimdLevel detected();
+    };
+
+}  // namespace Rt2
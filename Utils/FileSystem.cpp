@@ -21,6 +21,8 @@
 */
 #include "Utils/FileSystem.h"
 #include "Console.h"
+#include "Utils/MultiMatcher.h"
+#include "Utils/StringTable.h"
 #ifdef _WIN32
     #include <corecrt_io.h>
 #endif
@@ -39,12 +41,10 @@ namespace Rt2
         const String sep = "/";
         const String swp = "\\";
 #endif
-        String cp1;
-        Su::trimWs(cp1, path);
-
-        String cp2;
-        Su::replaceAll(cp2, cp1, swp, sep);
-        return cp2;
+        String cp;
+        Su::trimWs(cp, path);
+        Su::replaceAll(cp, swp, sep);
+        return cp;
     }
 
     FilePath FileSystem::normalize(const FilePath& path)
@@ -230,14 +230,20 @@ namespace Rt2
 
     String FileSystem::sanitize(const String& path)
     {
-        // only dealing with Unix path separators.
-        String n1;
-        Su::replaceAll(n1, path, "\\", "/");
-
-        // Take double slashes out of the equation
-        String n2;
-        Su::replaceAll(n2, n1, "//", "/");
-        return n2;
+        // Swaps \ for / and takes double slashes out of the equation in
+        // one pass. Each pair of separators, in either direction, becomes a
+        // single /, the same as swapping first and then collapsing //.
+        static const MultiMatcher separators = {
+            {"\\",   "/"},
+            {"//",   "/"},
+            {"/\\",  "/"},
+            {"\\/",  "/"},
+            {"\\\\", "/"},
+        };
+
+        String result;
+        separators.replaceAll(result, path);
+        return result;
     }
 
     String FileSystem::sanitizePlatform(const String& path)
@@ -253,13 +259,15 @@ namespace Rt2
 
     String FileSystem::unixPath(const String& path)
     {
-        String cp1;
-        Su::trimWs(cp1, path);
-
-        String cp2;
-        Su::replaceAll(cp2, cp1, "\\\\", "\\");
-        Su::replaceAll(cp2, cp1, "\\", "/");
-        return cp2;
+        // Each separator maps to one, so UNC prefixes are kept.
+        String cp;
+        Su::trimWs(cp, path);
+        for (char& ch : cp)
+        {
+            if (ch == '\\')
+                ch = '/';
+        }
+        return cp;
     }
 
     FilePath FileSystem::unixPath(const FilePath& path)
@@ -285,6 +293,17 @@ namespace Rt2
         }
     }
 
+    void FileSystem::list(const String& path, StringTable& dest)
+    {
+        if (const DirectoryEntry fp{FilePath(path)};
+            isDirectory(fp))
+        {
+            const DirectoryIterator it = tryGet(fp);
+            for (const auto& val : it)
+                dest.append(val.path().string());
+        }
+    }
+
     void FileSystem::count(const String& path, size_t& dirs, size_t& files, size_t& size)
     {
         const auto it = tryGet(DirectoryEntry(path));
@@ -98,6 +98,12 @@ namespace Rt2
 
         static void list(const String& path, DirectoryEntryArray& dest);
 
+        /**
+         * \brief Appends the path of each entry in the directory to dest,
+         * in the order they are read.
+         */
+        static void list(const String& path, StringTable& dest);
+
         static void count(const String& path, size_t &dirs, size_t &files, size_t &size);
     };
 
@@ -0,0 +1,461 @@
+/*
+-------------------------------------------------------------------------------
+    Copyright (c) Charles Carley.
+
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+-------------------------------------------------------------------------------
+*/
+#include "Utils/Filter.h"
+#include <cmath>
+#include <cstring>
+#include "Utils/Exception.h"
+
+namespace Rt2
+{
+    namespace
+    {
+        constexpr U32 BloomMagic   = 0x464D4C42;  // BLMF
+        constexpr U32 BlockedMagic = 0x464B4C42;  // BLKF
+        constexpr U32 CuckooMagic  = 0x464B4355;  // UCKF
+
+        // Blocks fill unevenly, so a blocked filter needs
+        // more bits than a standard one for the same rate.
+        constexpr double BlockedOverhead = 1.25;
+
+        template <typename T>
+        void put(String& dest, const T& value)
+        {
+            dest.append((const char*)&value, sizeof(T));
+        }
+
+        template <typename T>
+        void take(const String& src, size_t& at, T& value)
+        {
+            if (at + sizeof(T) > src.size())
+                throw Exception("filter buffer is truncated");
+            memcpy(&value, src.data() + at, sizeof(T));
+            at += sizeof(T);
+        }
+
+        template <typename T>
+        void putArray(String& dest, const SimpleArray<T>& array)
+        {
+            put(dest, U64(array.size()));
+            if (!array.empty())
+                dest.append((const char*)array.data(), sizeof(T) * array.size());
+        }
+
+        template <typename T>
+        void takeArray(const String& src, size_t& at, SimpleArray<T>& array)
+        {
+            U64 count;
+            take(src, at, count);
+            if (count > (src.size() - at) / sizeof(T))
+                throw Exception("filter buffer is truncated");
+
+            array.resizeFast(0);
+            array.reserve((U32)count);
+            array.resizeFast((U32)count);
+            if (count > 0)
+                memcpy(array.data(), src.data() + at, sizeof(T) * count);
+            at += sizeof(T) * count;
+        }
+
+        void zero(SimpleArray<U64>& words, const U64 count)
+        {
+            words.resizeFast(0);
+            words.reserve((U32)count);
+            words.resizeFast((U32)count);
+            if (count > 0)
+                memset(words.data(), 0, sizeof(U64) * count);
+        }
+
+        // The second hash used to derive the remaining probes.
+        U64 rehash(const hash_t hash)
+        {
+            return Hash(U64(hash)) | 1;
+        }
+    }  // namespace
+
+    BloomFilter::BloomFilter(const size_t expected, const double falsePositiveRate)
+    {
+        reset(expected, falsePositiveRate);
+    }
+
+    void BloomFilter::reset(const size_t expected, const double falsePositiveRate)
+    {
+        const double n    = double(Max<size_t>(expected, 1));
+        const double p    = Clamp(falsePositiveRate, 1e-9, 0.5);
+        const double ln2  = std::log(2.0);
+        const double bits = std::ceil(-n * std::log(p) / (ln2 * ln2));
+
+        _rate   = p;
+        _bits   = roundBits(U64(bits));
+        _hashes = Clamp<U32>(U32(std::lround(bits / n * ln2)), 1, 16);
+        _count  = 0;
+
+        if (_bits / 64 >= Npos32)
+            throw Exception("filter is too large");
+        zero(_words, _bits / 64);
+    }
+
+    void BloomFilter::clear()
+    {
+        zero(_words, _bits / 64);
+        _count = 0;
+    }
+
+    U64 BloomFilter::roundBits(const U64 bits) const
+    {
+        return Max<U64>((bits + 63) & ~U64(63), 64);
+    }
+
+    U32 BloomFilter::magic() const
+    {
+        return BloomMagic;
+    }
+
+    void BloomFilter::insertHash(const hash_t hash)
+    {
+        const U64 h2 = rehash(hash);
+
+        U64 h = hash;
+        for (U32 i = 0; i < _hashes; ++i, h += h2)
+        {
+            const U64 bit = h % _bits;
+            _words[U32(bit >> 6)] |= U64(1) << (bit & 63);
+        }
+        ++_count;
+    }
+
+    bool BloomFilter::containsHash(const hash_t hash) const
+    {
+        const U64 h2 = rehash(hash);
+
+        U64 h = hash;
+        for (U32 i = 0; i < _hashes; ++i, h += h2)
+        {
+            const U64 bit = h % _bits;
+            if (!(_words[U32(bit >> 6)] & U64(1) << (bit & 63)))
+                return false;
+        }
+        return true;
+    }
+
+    double BloomFilter::falsePositiveRate() const
+    {
+        // (1 - e^(-kn/m))^k
+        const double k = double(_hashes);
+        return std::pow(1.0 - std::exp(-k * double(_count) / double(_bits)), k);
+    }
+
+    void BloomFilter::save(String& dest) const
+    {
+        dest.clear();
+        dest.reserve(40 + _words.size() * sizeof(U64));
+
+        put(dest, magic());
+        put(dest, _hashes);
+        put(dest, _bits);
+        put(dest, _count);
+        put(dest, _rate);
+        putArray(dest, _words);
+    }
+
+    void BloomFilter::load(const String& src)
+    {
+        size_t at = 0;
+
+        U32 mark;
+        take(src, at, mark);
+        if (mark != magic())
+            throw Exception("the buffer does not hold this type of filter");
+
+        U32    hashes;
+        U64    bits, count;
+        double rate;
+        take(src, at, hashes);
+        take(src, at, bits);
+        take(src, at, count);
+        take(src, at, rate);
+
+        Words words;
+        takeArray(src, at, words);
+        if (bits == 0 || bits != U64(words.size()) * 64 || hashes < 1 || hashes > 16)
+            throw Exception("invalid filter buffer");
+
+        _hashes = hashes;
+        _bits   = bits;
+        _count  = count;
+        _rate   = rate;
+        _words.swap(words);
+    }
+
+    BlockedBloomFilter::BlockedBloomFilter(const size_t expected, const double falsePositiveRate) :
+        BloomFilter(1, 0.5)
+    {
+        // The base constructor can not reach the
+        // overrides, so size the filter again here.
+        reset(expected, falsePositiveRate);
+    }
+
+    U32 BlockedBloomFilter::magic() const
+    {
+        return BlockedMagic;
+    }
+
+    U64 BlockedBloomFilter::roundBits(const U64 bits) const
+    {
+        const U64 scaled = U64(double(bits) * BlockedOverhead);
+        return Max<U64>((scaled + BlockBits - 1) / BlockBits, 1) * BlockBits;
+    }
+
+    void BlockedBloomFilter::insertHash(const hash_t hash)
+    {
+        const U64 h2    = rehash(hash);
+        const U64 block = (hash % (_bits / BlockBits)) * BlockWords;
+
+        U32       h    = U32(h2);
+        const U32 step = U32(h2 >> 32) | 1;
+        for (U32 i = 0; i < _hashes; ++i, h += step)
+        {
+            const U32 bit = h & (BlockBits - 1);
+            _words[U32(block + (bit >> 6))] |= U64(1) << (bit & 63);
+        }
+        ++_count;
+    }
+
+    bool BlockedBloomFilter::containsHash(const hash_t hash) const
+    {
+        const U64 h2    = rehash(hash);
+        const U64 block = (hash % (_bits / BlockBits)) * BlockWords;
+
+        U32       h    = U32(h2);
+        const U32 step = U32(h2 >> 32) | 1;
+        for (U32 i = 0; i < _hashes; ++i, h += step)
+        {
+            const U32 bit = h & (BlockBits - 1);
+            if (!(_words[U32(block + (bit >> 6))] & U64(1) << (bit & 63)))
+                return false;
+        }
+        return true;
+    }
+
+    CuckooFilter::CuckooFilter(const size_t expected, const double falsePositiveRate)
+    {
+        reset(expected, falsePositiveRate);
+    }
+
+    void CuckooFilter::reset(const size_t expected, const double falsePositiveRate)
+    {
+        // Buckets of four reach about 95% occupancy before inserts fail.
+        size_t buckets = Max<size_t>(size_t(std::ceil(double(expected) / (BucketSize * 0.95))), 1);
+        NextPow2(buckets);
+        if (buckets * BucketSize >= Npos32)
+            throw Exception("filter is too large");
+
+        // Lookups check 2 * BucketSize fingerprints, so f >= log2(2b / p).
+        const double p    = Clamp(falsePositiveRate, 1e-9, 0.5);
+        const U32    bits = Clamp<U32>(U32(std::ceil(std::log2(2.0 * BucketSize / p))), 8, 16);
+
+        _fingerprintMask = U16((U32(1) << bits) - 1);
+        _mask            = buckets - 1;
+
+        _table.resizeFast(0);
+        _table.reserve(U32(buckets * BucketSize));
+        _table.resizeFast(U32(buckets * BucketSize));
+        clear();
+    }
+
+    void CuckooFilter::clear()
+    {
+        if (!_table.empty())
+            memset(_table.data(), 0, sizeof(U16) * _table.size());
+        _count       = 0;
+        _victim      = 0;
+        _victimIndex = 0;
+    }
+
+    U16 CuckooFilter::fingerprint(const hash_t hash) const
+    {
+        // The top bits of the hash, whatever its width. The bucket
+        // index is mixed from the whole hash. Zero marks an empty entry.
+        const U16 fp = U16(hash >> (sizeof(hash_t) * 8 - 16)) & _fingerprintMask;
+        return fp ? fp : 1;
+    }
+
+    U64 CuckooFilter::alternate(const U64 index, const U16 fp) const
+    {
+        return (index ^ Hash(U64(fp))) & _mask;
+    }
+
+    bool CuckooFilter::place(const U64 index, const U16 fp)
+    {
+        U16* bucket = _table.data() + index * BucketSize;
+        for (U32 i = 0; i < BucketSize; ++i)
+        {
+            if (bucket[i] == 0)
+            {
+                bucket[i] = fp;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool CuckooFilter::find(const U64 index, const U16 fp) const
+    {
+        const U16* bucket = _table.data() + index * BucketSize;
+        return bucket[0] == fp || bucket[1] == fp || bucket[2] == fp || bucket[3] == fp;
+    }
+
+    bool CuckooFilter::erase(const U64 index, const U16 fp)
+    {
+        U16* bucket = _table.data() + index * BucketSize;
+        for (U32 i = 0; i < BucketSize; ++i)
+        {
+            if (bucket[i] == fp)
+            {
+                bucket[i] = 0;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool CuckooFilter::insertHash(const hash_t hash)
+    {
+        // A pending victim means the last insert ran out of kicks.
+        if (_victim != 0)
+            return false;
+
+        U16       fp = fingerprint(hash);
+        const U64 i1 = Hash(U64(hash)) & _mask;
+        const U64 i2 = alternate(i1, fp);
+
+        ++_count;
+        if (place(i1, fp) || place(i2, fp))
+            return true;
+
+        U64 index = _seed & 1 ? i1 : i2;
+        for (U32 n = 0; n < MaxKicks; ++n)
+        {
+            // xorshift64
+            _seed ^= _seed << 13;
+            _seed ^= _seed >> 7;
+            _seed ^= _seed << 17;
+
+            U16& slot = _table[U32(index * BucketSize + (_seed & (BucketSize - 1)))];
+            Swap(fp, slot);
+
+            index = alternate(index, fp);
+            if (place(index, fp))
+                return true;
+        }
+
+        // The key is still represented, but the
+        // filter accepts no more inserts.
+        _victim      = fp;
+        _victimIndex = index;
+        return true;
+    }
+
+    bool CuckooFilter::containsHash(const hash_t hash) const
+    {
+        const U16 fp = fingerprint(hash);
+        const U64 i1 = Hash(U64(hash)) & _mask;
+        const U64 i2 = alternate(i1, fp);
+
+        if (find(i1, fp) || find(i2, fp))
+            return true;
+        return _victim == fp && (_victimIndex == i1 || _victimIndex == i2);
+    }
+
+    bool CuckooFilter::removeHash(const hash_t hash)
+    {
+        const U16 fp = fingerprint(hash);
+        const U64 i1 = Hash(U64(hash)) & _mask;
+        const U64 i2 = alternate(i1, fp);
+
+        if (erase(i1, fp) || erase(i2, fp))
+        {
+            --_count;
+            if (_victim != 0)
+            {
+                // Try to move the victim into the freed room.
+                const U16 victim = _victim;
+                const U64 index  = _victimIndex;
+                if (place(index, victim) || place(alternate(index, victim), victim))
+                    _victim = 0;
+            }
+            return true;
+        }
+
+        if (_victim == fp && (_victimIndex == i1 || _victimIndex == i2))
+        {
+            _victim = 0;
+            --_count;
+            return true;
+        }
+        return false;
+    }
+
+    void CuckooFilter::save(String& dest) const
+    {
+        dest.clear();
+        dest.reserve(40 + _table.size() * sizeof(U16));
+
+        put(dest, CuckooMagic);
+        put(dest, _fingerprintMask);
+        put(dest, _victim);
+        put(dest, _mask);
+        put(dest, _count);
+        put(dest, _victimIndex);
+        putArray(dest, _table);
+    }
+
+    void CuckooFilter::load(const String& src)
+    {
+        size_t at = 0;
+
+        U32 mark;
+        take(src, at, mark);
+        if (mark != CuckooMagic)
+            throw Exception("the buffer does not hold this type of filter");
+
+        U16 fpMask, victim;
+        U64 mask, count, victimIndex;
+        take(src, at, fpMask);
+        take(src, at, victim);
+        take(src, at, mask);
+        take(src, at, count);
+        take(src, at, victimIndex);
+
+        Fingerprints table;
+        takeArray(src, at, table);
+        if (!IsPow2(size_t(mask + 1)) || U64(table.size()) != (mask + 1) * BucketSize || victimIndex > mask)
+            throw Exception("invalid filter buffer");
+
+        _fingerprintMask = fpMask;
+        _victim          = victim;
+        _mask            = mask;
+        _count           = count;
+        _victimIndex     = victimIndex;
+        _table.swap(table);
+    }
+
+}  // namespace Rt2
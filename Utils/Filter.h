@@ -0,0 +1,355 @@
+/*
+-------------------------------------------------------------------------------
+    Copyright (c) Charles Carley.
+
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+-------------------------------------------------------------------------------
+*/
+#pragma once
+
+#include "Utils/Array.h"
+#include "Utils/Definitions.h"
+#include "Utils/HashMap.h"
+#include "Utils/Hash.h"
+#include "Utils/IndexCache.h"
+#include "Utils/String.h"
+
+namespace Rt2
+{
+    /**
+     * \brief Probabilistic set membership test with no false negatives.
+     *
+     * Keys are hashed with the project Hash functions and the k probe
+     * positions are derived by double hashing. Keys can not be removed.
+     */
+    class BloomFilter
+    {
+    public:
+        using Words = SimpleArray<U64>;
+
+    protected:
+        Words  _words;
+        U64    _bits{0};
+        U64    _count{0};
+        U32    _hashes{1};
+        double _rate{0.01};
+
+    public:
+        /**
+         * \param expected The number of keys the filter is sized for.
+         * \param falsePositiveRate The target false positive rate, in (0, 1).
+         */
+        explicit BloomFilter(size_t expected = 0x400, double falsePositiveRate = 0.01);
+
+        virtual ~BloomFilter() = default;
+
+        /**
+         * \brief Resizes the filter and removes every key.
+         */
+        void reset(size_t expected, double falsePositiveRate);
+
+        void clear();
+
+        virtual void insertHash(hash_t hash);
+
+        virtual bool containsHash(hash_t hash) const;
+
+        template <typename T>
+        void insert(const T& key)
+        {
+            insertHash(Hash(key));
+        }
+
+        /**
+         * \return False if the key was never inserted, true if it may have been.
+         */
+        template <typename T>
+        bool contains(const T& key) const
+        {
+            return containsHash(Hash(key));
+        }
+
+        /**
+         * \return The expected false positive rate for the current number of keys.
+         */
+        double falsePositiveRate() const;
+
+        /**
+         * \brief Writes the filter to a flat byte buffer.
+         */
+        void save(String& dest) const;
+
+        /**
+         * \brief Restores a filter written by save.
+         * \throws Exception if the buffer was not written by this filter type.
+         */
+        void load(const String& src);
+
+        U64 bits() const { return _bits; }
+
+        U32 hashes() const { return _hashes; }
+
+        U64 size() const { return _count; }
+
+    protected:
+        virtual U32 magic() const;
+
+        virtual U64 roundBits(U64 bits) const;
+    };
+
+    /**
+     * \brief BloomFilter that confines the probes of each key to one 512-bit
+     * block, so a lookup touches a single cache line.
+     *
+     * The false positive rate is slightly higher than the standard filter
+     * for the same size, which the sizing compensates for.
+     */
+    class BlockedBloomFilter : public BloomFilter
+    {
+    public:
+        static constexpr U32 BlockBits  = 512;
+        static constexpr U32 BlockWords = BlockBits / 64;
+
+        explicit BlockedBloomFilter(size_t expected = 0x400, double falsePositiveRate = 0.01);
+
+        void insertHash(hash_t hash) override;
+
+        bool containsHash(hash_t hash) const override;
+
+    protected:
+        U32 magic() const override;
+
+        U64 roundBits(U64 bits) const override;
+    };
+
+    /**
+     * \brief Probabilistic set membership test that supports removal.
+     *
+     * Stores a short fingerprint of each key in one of two buckets of four
+     * entries. Removing a key that was never inserted may remove another
+     * key with the same fingerprint, so only remove keys that were added.
+     */
+    class CuckooFilter
+    {
+    public:
+        static constexpr U32 BucketSize = 4;
+        static constexpr U32 MaxKicks   = 500;
+
+        using Fingerprints = SimpleArray<U16>;
+
+    private:
+        Fingerprints _table;
+        U64          _mask{0};
+        U64          _count{0};
+        U16          _fingerprintMask{0xFF};
+        U16          _victim{0};
+        U64          _victimIndex{0};
+        U64          _seed{0x2545F4914F6CDD1D};
+
+    public:
+        /**
+         * \param expected The number of keys the filter is sized for.
+         * \param falsePositiveRate Selects the fingerprint size, from 8 to 16 bits.
+         */
+        explicit CuckooFilter(size_t expected = 0x400, double falsePositiveRate = 0.01);
+
+        void reset(size_t expected, double falsePositiveRate);
+
+        void clear();
+
+        /**
+         * \return False if the filter is too full to hold the key.
+         */
+        bool insertHash(hash_t hash);
+
+        bool containsHash(hash_t hash) const;
+
+        bool removeHash(hash_t hash);
+
+        template <typename T>
+        bool insert(const T& key)
+        {
+            return insertHash(Hash(key));
+        }
+
+        template <typename T>
+        bool contains(const T& key) const
+        {
+            return containsHash(Hash(key));
+        }
+
+        template <typename T>
+        bool remove(const T& key)
+        {
+            return removeHash(Hash(key));
+        }
+
+        void save(String& dest) const;
+
+        void load(const String& src);
+
+        U64 size() const { return _count; }
+
+        U64 capacity() const { return (_mask + 1) * BucketSize; }
+
+        double loadFactor() const { return double(_count) / double(capacity()); }
+
+    private:
+        U16 fingerprint(hash_t hash) const;
+
+        U64 alternate(U64 index, U16 fp) const;
+
+        bool place(U64 index, U16 fp);
+
+        bool find(U64 index, U16 fp) const;
+
+        bool erase(U64 index, U16 fp);
+    };
+
+    /**
+     * \brief Cache with a BloomFilter in front of the set, so that most
+     * misses are answered without probing the table.
+     */
+    template <typename T, typename Filter = BlockedBloomFilter>
+    class FilteredCache
+    {
+    private:
+        Cache<T> _cache;
+        Filter   _filter;
+
+    public:
+        explicit FilteredCache(const size_t expected = 0x400, const double rate = 0.01) :
+            _filter(expected, rate)
+        {
+        }
+
+        void save(const T& value)
+        {
+            _filter.insert(value);
+            _cache.save(value);
+        }
+
+        bool exists(const T& value) const
+        {
+            return _filter.contains(value) && _cache.exists(value);
+        }
+
+        const Filter& filter() const { return _filter; }
+    };
+
+    /**
+     * \brief HashTable with a CuckooFilter in front of it, so that most
+     * lookups of missing keys skip the hash chain.
+     *
+     * The filter is rebuilt from the table at twice the size if it fills up.
+     */
+    template <typename Key, typename Value>
+    class FilteredHashTable
+    {
+    public:
+        using Table = HashTable<Key, Value>;
+
+    private:
+        Table        _table;
+        CuckooFilter _filter;
+        double       _rate;
+
+    public:
+        explicit FilteredHashTable(const size_t expected = 0x400, const double rate = 0.01) :
+            _filter(expected, rate),
+            _rate(rate)
+        {
+        }
+
+        bool insert(const Key& key, const Value& val)
+        {
+            if (!_table.insert(key, val))
+                return false;
+
+            if (!_filter.insert(key))
+                rebuild();
+            return true;
+        }
+
+        void remove(const Key& key)
+        {
+            if (_table.find(key) != Npos)
+            {
+                _filter.remove(key);
+                _table.remove(key);
+            }
+        }
+
+        size_t find(const Key& key) const
+        {
+            if (!_filter.contains(key))
+                return Npos;
+            return _table.find(key);
+        }
+
+        bool contains(const Key& key) const
+        {
+            return find(key) != Npos;
+        }
+
+        Value& get(const Key& key)
+        {
+            const size_t i = find(key);
+            if (i == Npos)
+                throw Exception("element not found");
+            return _table.at(i);
+        }
+
+        void clear()
+        {
+            _table.clear();
+            _filter.clear();
+        }
+
+        size_t size() const { return _table.size(); }
+
+        bool empty() const { return _table.empty(); }
+
+        const Table& table() const { return _table; }
+
+        const CuckooFilter& filter() const { return _filter; }
+
+    private:
+        void rebuild()
+        {
+            size_t expected = Max<size_t>(_table.size(), 0x10) * 2;
+            for (;;)
+            {
+                _filter.reset(expected, _rate);
+
+                bool placed = true;
+                for (const auto& entry : _table)
+                {
+                    if (!_filter.insert(entry.first))
+                    {
+                        placed = false;
+                        break;
+                    }
+                }
+                if (placed)
+                    return;
+                expected *= 2;
+            }
+        }
+    };
+
+}  // namespace Rt2
@@ -21,31 +21,58 @@
 */
 #pragma once
 #include <cstdint>
+#include <string>
+#include <string_view>
 #include "Utils/Char.h"
 #include "Utils/Hash.h"
 
 namespace Rt2
 {
+    /**
+     * \brief Fixed capacity, null terminated string.
+     *
+     * The hash is kept up to date by every modification, so comparisons
+     * and hash table lookups never walk the characters twice. Everything
+     * is constexpr so that constant keys can be built at compile time.
+     */
     template <const uint16_t L>
     class FixedString
     {
     public:
         typedef char Pointer[L + 1];
 
+        /**
+         * \brief Transparent hash function object.
+         *
+         * FixedString and std::string_view keys with the same characters
+         * hash to the same value.
+         */
+        struct Hasher
+        {
+            using is_transparent = void;
+
+            constexpr hash_t operator()(const FixedString& str) const
+            {
+                return str.hash();
+            }
+
+            constexpr hash_t operator()(const std::string_view& str) const
+            {
+                return HashFnv(str.data(), str.size());
+            }
+        };
+
     private:
-        Pointer        _buffer;
-        uint16_t       _size;
-        mutable hash_t _hash;
+        Pointer  _buffer{};
+        uint16_t _size{0};
+        hash_t   _hash{Npos};
 
-        void copy(const char*     src,
-                  const uint16_t& size,
-                  const uint16_t& other = Npos16)
+        // Like append, copying stops at the first null character.
+        constexpr void copy(const char* src, const size_t size)
         {
-            const uint16_t val = Min(size, Min(L, other));
+            const size_t val = Min<size_t>(size, L);
 
             _size = 0;
-            _hash = Npos;
-
             while (_size < val && src[_size])
             {
                 _buffer[_size] = src[_size];
@@ -53,199 +80,240 @@ namespace Rt2
             }
 
             _buffer[_size] = 0;
+            rehash();
         }
 
-    public:
-        FixedString() :
-            _size(0),
-            _hash(-1)
+        constexpr void rehash()
         {
-            _buffer[_size] = 0;
+            _hash = HashFnv(_buffer, _size);
         }
 
-        FixedString(const FixedString& rhs) :
-            _size(0),
-            _hash(Npos)
+    public:
+        constexpr FixedString() = default;
+
+        constexpr FixedString(const FixedString& rhs) = default;
+
+        constexpr explicit FixedString(const char* rhs)
         {
-            if (rhs.size())
-                copy(rhs.c_str(), rhs.size(), rhs.size());
-            else
-                _buffer[_size] = 0;
+            if (rhs)
+                copy(rhs, Npos);
         }
 
-        explicit FixedString(const char* rhs) :
-            _size(0),
-            _hash(Npos)
+        constexpr FixedString(const char* rhs, const uint16_t& size)
         {
             if (rhs)
-                copy(rhs, Npos16, Npos16);
-            else
-                _buffer[_size] = 0;
+                copy(rhs, size);
         }
 
-        FixedString(const char* rhs, const uint16_t& size) :
-            _size(0),
-            _hash(Npos)
+        constexpr explicit FixedString(const std::string_view& rhs)
         {
-            if (rhs)
-                copy(rhs, size, size);
-            else
-                _buffer[_size] = 0;
+            copy(rhs.data(), rhs.size());
         }
 
-        void push_back(char ch)
+        constexpr void push_back(char ch)
         {
             if (_size >= L)
                 return;
 
             _buffer[_size++] = ch;
             _buffer[_size]   = 0;
+            rehash();
         }
 
-        void resize(uint16_t ns)
+        constexpr void resize(uint16_t ns)
         {
             if (ns <= L)
             {
                 _size          = ns;
                 _buffer[_size] = 0;
+                rehash();
             }
         }
 
-        void append(const char* str)
+        constexpr void append(const char* str)
         {
-            const uint16_t len = Clamp<uint16_t>((uint16_t)Char::length(str), 0, L);
+            if (!str)
+                return;
+
+            while (_size < L && *str)
+                _buffer[_size++] = *str++;
 
-            uint16_t       a   = 0;
-            while (a < len)
-                push_back(str[a++]);
+            _buffer[_size] = 0;
+            rehash();
+        }
+
+        template <const uint16_t OL>
+        constexpr void append(const FixedString<OL>& str)
+        {
+            append(std::string_view(str.c_str(), str.size()));
         }
 
-        void append(const FixedString& str)
+        constexpr void append(const std::string_view& str)
         {
-            const uint16_t len = str._size;
+            size_t a = 0;
+            while (_size < L && a < str.size() && str[a])
+                _buffer[_size++] = str[a++];
 
-            uint16_t a = 0;
-            while (a < len)
-                push_back(str._buffer[a++]);
+            _buffer[_size] = 0;
+            rehash();
         }
 
-        FixedString& operator=(const FixedString& rhs)
+        constexpr FixedString& operator=(const FixedString& rhs) = default;
+
+        template <const uint16_t OL>
+        constexpr FixedString& operator=(const FixedString<OL>& o)
         {
-            if (this != &rhs && rhs._size > 0)
-                copy(rhs.c_str(), rhs.size(), rhs.size());
+            copy(o.c_str(), o.size());
             return *this;
         }
 
-        template <const uint16_t OL>
-        FixedString<L>& operator=(const FixedString<OL>& o)
+        constexpr FixedString& operator=(const std::string_view& o)
         {
-            if (o.size() > 0)
-                copy(o.c_str(), o.size(), OL);
+            copy(o.data(), o.size());
             return *this;
         }
 
-        FixedString operator+(const FixedString& rhs)
+        constexpr FixedString operator+(const FixedString& rhs) const
         {
             FixedString lhs = *this;
             lhs.append(rhs);
             return lhs;
         }
 
-        FixedString operator+=(const FixedString& rhs)
+        constexpr FixedString& operator+=(const FixedString& rhs)
         {
             append(rhs);
             return *this;
         }
 
-        FixedString operator+(const char* str)
+        constexpr FixedString operator+(const char* str) const
         {
             FixedString lhs = *this;
             lhs.append(str);
             return lhs;
         }
 
-        FixedString operator+=(const char* str)
+        constexpr FixedString& operator+=(const char* str)
         {
             append(str);
             return *this;
         }
 
-        const char* c_str()const
+        constexpr const char* c_str() const
         {
             return _buffer;
         }
 
-        char* data()
+        constexpr const char* data() const
         {
             return _buffer;
         }
 
-        void clear()
+        constexpr std::string_view view() const
+        {
+            return {_buffer, _size};
+        }
+
+        constexpr operator std::string_view() const
+        {
+            return view();
+        }
+
+        constexpr void clear()
         {
             _buffer[0] = 0;
             _size      = 0;
+            _hash      = Npos;
         }
 
-        bool empty()const
+        constexpr bool empty() const
         {
             return _size == 0;
         }
 
-        uint16_t size()const
+        constexpr uint16_t size() const
         {
             return _size;
         }
 
-        static uint16_t capacity()
+        static constexpr uint16_t capacity()
         {
             return L;
         }
 
-        char operator[](uint16_t i) const
+        constexpr char operator[](uint16_t i) const
         {
-            RT_ASSERT(i < _size && i < L);
+            RT_ASSERT(i < _size && i < L)
             return _buffer[i];
         }
 
-        char at(uint16_t i) const
+        constexpr char at(uint16_t i) const
         {
-            RT_ASSERT(i < _size && i < L);
+            RT_ASSERT(i < _size && i < L)
             return _buffer[i];
         }
 
-        char& operator[](uint16_t i)
+        /**
+         * \brief Replaces the character at i.
+         *
+         * There is no non-const character access, since writing through
+         * it would leave the cached hash stale.
+         */
+        constexpr void set(uint16_t i, char ch)
         {
-            RT_ASSERT(i < _size && i < L);
-            return _buffer[i];
+            RT_ASSERT(i < _size && i < L)
+            _buffer[i] = ch;
+            rehash();
         }
 
-        char at(uint16_t i)
+        /**
+         * \return The Hash of the characters, or Npos if the string is empty.
+         */
+        constexpr hash_t hash() const
         {
-            RT_ASSERT(i < _size && i < L);
-            return _buffer[i];
+            return _hash;
         }
 
-        hash_t hash()const
+        constexpr bool operator==(const std::string_view& str) const
         {
-            if (_hash != -1)
-                return _hash;
-
-            if (_size == 0 || !_buffer)
-                return -1;
+            return _size == str.size() &&
+                   std::char_traits<char>::compare(_buffer, str.data(), _size) == 0;
+        }
 
-            _hash = Hash(_buffer);
-            return _hash;
+        constexpr bool operator!=(const std::string_view& str) const
+        {
+            return !(*this == str);
         }
 
-        bool operator==(const FixedString& str) const
+        template <const uint16_t OL>
+        constexpr bool operator==(const FixedString<OL>& str) const
         {
-            return hash() == str.hash();
+            return _hash == str.hash() && *this == str.view();
         }
 
-        bool operator!=(const FixedString& str) const
+        template <const uint16_t OL>
+        constexpr bool operator!=(const FixedString<OL>& str) const
         {
-            return hash() != str.hash();
+            return !(*this == str);
         }
     };
 
-}  // namespace Jam
+    template <const uint16_t L>
+    constexpr bool operator==(const std::string_view& a, const FixedString<L>& b)
+    {
+        return b == a;
+    }
+
+    template <const uint16_t L>
+    constexpr bool operator!=(const std::string_view& a, const FixedString<L>& b)
+    {
+        return !(b == a);
+    }
+
+    template <const uint16_t L>
+    constexpr hash_t Hash(const FixedString<L>& key)
+    {
+        return key.hash();
+    }
+
+}  // namespace Rt2
@@ -0,0 +1,400 @@
+/*
+-------------------------------------------------------------------------------
+    Copyright (c) Charles Carley.
+
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+-------------------------------------------------------------------------------
+*/
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include "Utils/Array.h"
+#include "Utils/Definitions.h"
+
+namespace Rt2
+{
+    /**
+     * \brief Sorted map stored in two contiguous arrays, one for the keys
+     * and one for the values.
+     *
+     * Inserts are appended to an unsorted tail and are merged into the
+     * sorted part in one pass the next time the map is read. Small maps
+     * are searched linearly, larger ones with a binary search.
+     * Keys are unique; inserting an existing key keeps the first value.
+     */
+    template <typename Key,
+              typename Value,
+              int ArrayOptions = AOP_SIMPLE_TYPE,
+              U16 LinearLimit  = 0x10>
+    class FlatMap
+    {
+    public:
+        struct Pair
+        {
+            Key   key;
+            Value value;
+
+            bool operator<(const Pair& rhs) const { return key < rhs.key; }
+            bool operator>(const Pair& rhs) const { return rhs.key < key; }
+            bool operator==(const Pair& rhs) const { return !(key < rhs.key) && !(rhs.key < key); }
+        };
+
+        using Keys    = Array<Key, ArrayOptions>;
+        using Values  = Array<Value, ArrayOptions>;
+        using KvPairs = Array<Pair, ArrayOptions>;
+
+        using SizeType         = typename Keys::SizeType;
+        using ValuePointerType = typename Values::PointerType;
+        using ValueCallback    = std::function<int(const Value&)>;
+
+    private:
+        // [0, _sorted) is sorted and unique, [_sorted, size) is pending.
+        mutable Keys     _keys;
+        mutable Values   _values;
+        mutable SizeType _sorted{0};
+
+    public:
+        FlatMap() = default;
+
+        FlatMap(const FlatMap& rhs) = default;
+
+        ~FlatMap() = default;
+
+        FlatMap& operator=(const FlatMap& rhs) = default;
+
+        void clear()
+        {
+            _keys.clear();
+            _values.clear();
+            _sorted = 0;
+        }
+
+        void reserve(const SizeType& space)
+        {
+            _keys.reserve(space);
+            _values.reserve(space);
+        }
+
+        /**
+         * \brief Queues the pair for insertion. The pair is merged
+         * into the map by the next lookup or by commit.
+         */
+        void insert(const Key& key, const Value& val)
+        {
+            _keys.push_back(key);
+            _values.push_back(val);
+        }
+
+        /**
+         * \brief Inserts the pair or replaces the value of an existing key.
+         */
+        void assign(const Key& key, const Value& val)
+        {
+            if (Value* value = find(key))
+                *value = val;
+            else
+                insert(key, val);
+        }
+
+        bool contains(const Key& key) const
+        {
+            return indexOf(key) != Npos32;
+        }
+
+        const Value& get(const Key& key, const Value& error = {}) const
+        {
+            const SizeType idx = indexOf(key);
+            return idx == Npos32 ? error : _values[idx];
+        }
+
+        Value* find(const Key& key) const
+        {
+            const SizeType idx = indexOf(key);
+            return idx == Npos32 ? nullptr : &_values[idx];
+        }
+
+        /**
+         * \return The index of key or Npos32 if it is not in the map.
+         */
+        SizeType indexOf(const Key& key) const
+        {
+            commit();
+
+            const SizeType idx = lowerBound(key);
+            if (idx < _sorted && !(key < _keys[idx]))
+                return idx;
+            return Npos32;
+        }
+
+        /**
+         * \return The index of the first key not less than key.
+         */
+        SizeType lowerBound(const Key& key) const
+        {
+            commit();
+
+            if (_sorted <= LinearLimit)
+            {
+                SizeType i = 0;
+                while (i < _sorted && _keys[i] < key)
+                    ++i;
+                return i;
+            }
+
+            SizeType lo = 0, hi = _sorted;
+            while (lo < hi)
+            {
+                const SizeType mid = (lo + hi) >> 1;
+                if (_keys[mid] < key)
+                    lo = mid + 1;
+                else
+                    hi = mid;
+            }
+            return lo;
+        }
+
+        /**
+         * \return The index of the first key greater than key.
+         */
+        SizeType upperBound(const Key& key) const
+        {
+            SizeType idx = lowerBound(key);
+            if (idx < _sorted && !(key < _keys[idx]))
+                ++idx;
+            return idx;
+        }
+
+        bool erase(const Key& key)
+        {
+            const SizeType idx = indexOf(key);
+            if (idx == Npos32)
+                return false;
+
+            const SizeType last = _keys.size() - 1;
+            for (SizeType i = idx; i < last; ++i)
+            {
+                _keys[i]   = _keys[i + 1];
+                _values[i] = _values[i + 1];
+            }
+
+            // The storage stays constructed, so reset the
+            // released slot rather than destroying it.
+            _keys[last]   = Key{};
+            _values[last] = Value{};
+            _keys.resizeFast(last);
+            _values.resizeFast(last);
+            --_sorted;
+            return true;
+        }
+
+        /**
+         * \brief Merges rhs into this map in a single linear pass.
+         * Keys already in this map keep their values.
+         */
+        void merge(const FlatMap& rhs)
+        {
+            commit();
+            rhs.commit();
+
+            if (rhs.empty())
+                return;
+
+            Keys   keys;
+            Values values;
+            mergeSorted(_keys.data(),
+                        _values.data(),
+                        _sorted,
+                        rhs._keys.data(),
+                        rhs._values.data(),
+                        rhs._sorted,
+                        keys,
+                        values);
+
+            _keys.swap(keys);
+            _values.swap(values);
+            _sorted = _keys.size();
+        }
+
+        /**
+         * \brief Sorts the pending inserts and merges them into the map.
+         */
+        void commit() const
+        {
+            const SizeType total = _keys.size();
+            if (_sorted >= total)
+                return;
+
+            const SizeType pending = total - _sorted;
+
+            SimpleArray<SizeType> order(pending);
+            for (SizeType i = 0; i < pending; ++i)
+                order.push_back(_sorted + i);
+
+            const Keys& keys = _keys;
+            std::stable_sort(order.begin(),
+                             order.end(),
+                             [&keys](const SizeType a, const SizeType b)
+                             { return keys[a] < keys[b]; });
+
+            Keys   tailKeys(pending);
+            Values tailValues(pending);
+            for (const SizeType idx : order)
+            {
+                tailKeys.push_back(_keys[idx]);
+                tailValues.push_back(_values[idx]);
+            }
+
+            Keys   mergedKeys;
+            Values mergedValues;
+            mergeSorted(_keys.data(),
+                        _values.data(),
+                        _sorted,
+                        tailKeys.data(),
+                        tailValues.data(),
+                        pending,
+                        mergedKeys,
+                        mergedValues);
+
+            _keys.swap(mergedKeys);
+            _values.swap(mergedValues);
+            _sorted = _keys.size();
+        }
+
+        void keys(Keys& dest, const bool descending = false) const
+        {
+            commit();
+            copy(dest, _keys, descending);
+        }
+
+        void values(Values& dest, const bool descending = false) const
+        {
+            commit();
+            copy(dest, _values, descending);
+        }
+
+        void values(const ValueCallback& dest, const bool descending = false) const
+        {
+            commit();
+            if (!dest)
+                return;
+
+            for (SizeType i = 0; i < _sorted; ++i)
+            {
+                if (dest(_values[descending ? _sorted - 1 - i : i]))
+                    break;
+            }
+        }
+
+        void keyValuePairs(KvPairs& dest, const bool descending = false) const
+        {
+            commit();
+
+            dest.clear();
+            dest.reserve(_sorted);
+            for (SizeType i = 0; i < _sorted; ++i)
+            {
+                const SizeType j = descending ? _sorted - 1 - i : i;
+                dest.push_back({_keys[j], _values[j]});
+            }
+        }
+
+        const Key& keyAt(const SizeType idx) const
+        {
+            commit();
+            return _keys.at(idx);
+        }
+
+        Value& valueAt(const SizeType idx) const
+        {
+            commit();
+            return _values.at(idx);
+        }
+
+        /**
+         * \return The values in ascending key order.
+         */
+        ValuePointerType begin()
+        {
+            commit();
+            return _values.begin();
+        }
+
+        ValuePointerType end()
+        {
+            commit();
+            return _values.end();
+        }
+
+        SizeType size() const
+        {
+            commit();
+            return _sorted;
+        }
+
+        bool empty() const
+        {
+            return _keys.empty();
+        }
+
+    private:
+        template <typename T>
+        static void copy(Array<T, ArrayOptions>&       dest,
+                         const Array<T, ArrayOptions>& src,
+                         const bool                    descending)
+        {
+            dest.clear();
+            dest.reserve(src.size());
+            for (SizeType i = 0; i < src.size(); ++i)
+                dest.push_back(src[descending ? src.size() - 1 - i : i]);
+        }
+
+        static void mergeSorted(const Key*     ak,
+                                const Value*   av,
+                                const SizeType an,
+                                const Key*     bk,
+                                const Value*   bv,
+                                const SizeType bn,
+                                Keys&          keys,
+                                Values&        values)
+        {
+            keys.reserve(an + bn);
+            values.reserve(an + bn);
+
+            SizeType a = 0, b = 0;
+            while (a < an || b < bn)
+            {
+                // On equal keys the left side wins; duplicates that
+                // follow an emitted key are dropped.
+                const bool takeA = b >= bn || (a < an && !(bk[b] < ak[a]));
+                const Key& key   = takeA ? ak[a] : bk[b];
+
+                if (keys.empty() || keys.back() < key)
+                {
+                    keys.push_back(key);
+                    values.push_back(takeA ? av[a] : bv[b]);
+                }
+
+                if (takeA)
+                    ++a;
+                else
+                    ++b;
+            }
+        }
+    };
+
+}  // namespace Rt2
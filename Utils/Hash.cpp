@@ -25,12 +25,6 @@
 
 namespace Rt2
 {
-    // magic numbers from http://www.isthe.com/chongo/tech/comp/fnv/
-    // constexpr size_t InitialFnv2 = 0x9E3779B9;
-
-    constexpr size_t InitialFnv  = 0x9E3779B1;
-    constexpr size_t MultipleFnv = 0x1000193;
-
     hash_t Hash(const char* key)
     {
         if (!key)
@@ -38,20 +32,9 @@ namespace Rt2
         return Hash(key, Char::length(key));
     }
 
-    // Fowler/Noll/Vo (FNV) Hash
     hash_t Hash(const char* key, const size_t len)
     {
-        if (!key || len == 0 || len == Npos)
-            return Npos;
-
-        size_t hash = InitialFnv;
-
-        for (size_t i = 0; key[i] && i < len; i++)
-        {
-            hash = hash ^ key[i];       // xor the low 8 bits
-            hash = hash * MultipleFnv;  // multiply by the magic number
-        }
-        return hash;
+        return HashFnv(key, len);
     }
 
     hash_t Hash(const uint32_t& key)
@@ -28,6 +28,31 @@ namespace Rt2
 {
     using hash_t = size_t;
 
+    // magic numbers from http://www.isthe.com/chongo/tech/comp/fnv/
+    constexpr size_t InitialFnv  = 0x9E3779B1;
+    constexpr size_t MultipleFnv = 0x1000193;
+
+    /**
+     * \brief Fowler/Noll/Vo (FNV) hash of at most len characters of key.
+     *
+     * This is the same function as Hash(const char*, size_t), but it
+     * can be evaluated at compile time.
+     */
+    constexpr hash_t HashFnv(const char* key, const size_t len)
+    {
+        if (!key || len == 0 || len == Npos)
+            return Npos;
+
+        size_t hash = InitialFnv;
+
+        for (size_t i = 0; i < len && key[i]; i++)
+        {
+            hash = hash ^ key[i];       // xor the low 8 bits
+            hash = hash * MultipleFnv;  // multiply by the magic number
+        }
+        return hash;
+    }
+
     extern hash_t Hash(const char* key);
     extern hash_t Hash(const char* key, size_t len);
     extern hash_t Hash(const uint32_t& key);
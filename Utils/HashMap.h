@@ -194,7 +194,9 @@ namespace Rt2
             const hash_t hr = hk & _capacity - 1;
             size_t       fh = _indices[hr];
 
-            while (fh != Npos && hk != _bucket[fh].hash)
+            // Distinct keys can share a hash, so
+            // the key itself decides the match.
+            while (fh != Npos && (hk != _bucket[fh].hash || !(_bucket[fh].first == key)))
                 fh = _next[fh];
 
             return fh;
@@ -230,8 +232,11 @@ namespace Rt2
             if (empty())
                 return;
 
-            size_t       fIndex = find(key);
-            const hash_t hash   = Hash(key) & _capacity - 1;
+            size_t fIndex = find(key);
+            if (fIndex == Npos)
+                return;
+
+            const hash_t hash = Hash(key) & _capacity - 1;
 
             size_t index  = _indices[hash];
             size_t pIndex = Npos;
@@ -254,7 +259,7 @@ namespace Rt2
             if (lIndex == fIndex)
             {
                 --_size;
-                _bucket[_size].~Pair();
+                _bucket[_size] = Pair();
                 return;
             }
 
@@ -280,8 +285,10 @@ namespace Rt2
             _next[fIndex]   = _indices[lHash];
             _indices[lHash] = fIndex;
 
+            // The bucket storage stays constructed until it is
+            // deallocated, so reset the slot instead of destroying it.
             --_size;
-            _bucket[_size].~Pair();
+            _bucket[_size] = Pair();
         }
 
         PointerType data()
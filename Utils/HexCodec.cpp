@@ -0,0 +1,324 @@
+/*
+-------------------------------------------------------------------------------
+    Copyright (c) Charles Carley.
+
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+-------------------------------------------------------------------------------
+*/
+#include "Utils/HexCodec.h"
+#include <cstring>
+#include "Utils/Cpu.h"
+
+#if RT_ARCH_X64
+    #include <immintrin.h>
+#endif
+
+namespace Rt2
+{
+    namespace
+    {
+        constexpr char Digits[] = "0123456789ABCDEF";
+
+        // The rows of a dump are written this many at a time.
+        constexpr size_t DumpRows = 256;
+
+        struct HexTables
+        {
+            char   pairs[256][2]{};
+            int8_t values[256]{};
+            char   printable[256]{};
+
+            constexpr HexTables()
+            {
+                for (int i = 0; i < 256; ++i)
+                {
+                    pairs[i][0]  = Digits[i >> 4];
+                    pairs[i][1]  = Digits[i & 0xF];
+                    values[i]    = -1;
+                    printable[i] = i >= 0x20 && i < 0x7F ? char(i) : '.';
+                }
+                for (int i = 0; i < 10; ++i)
+                    values['0' + i] = int8_t(i);
+                for (int i = 0; i < 6; ++i)
+                {
+                    values['A' + i] = int8_t(10 + i);
+                    values['a' + i] = int8_t(10 + i);
+                }
+            }
+        };
+
+        constexpr HexTables Tables;
+
+        void encodeScalar(char*& out, const uint8_t*& in, const uint8_t* end)
+        {
+            for (; in < end; ++in, out += 2)
+            {
+                out[0] = Tables.pairs[*in][0];
+                out[1] = Tables.pairs[*in][1];
+            }
+        }
+
+        bool decodeScalar(uint8_t*& out, const char*& in, const char* end)
+        {
+            for (; in < end; in += 2, ++out)
+            {
+                const int hi = Tables.values[uint8_t(in[0])];
+                const int lo = Tables.values[uint8_t(in[1])];
+                if ((hi | lo) < 0)
+                    return false;
+                *out = uint8_t(hi << 4 | lo);
+            }
+            return true;
+        }
+
+#if RT_ARCH_X64
+
+        RT_TARGET_SSE42 void encodeSsse3(char*& out, const uint8_t*& in, const uint8_t* end)
+        {
+            const __m128i digits = _mm_loadu_si128((const __m128i*)Digits);
+            const __m128i nibble = _mm_set1_epi8(0x0F);
+
+            for (; end - in >= 16; in += 16, out += 32)
+            {
+                const __m128i v  = _mm_loadu_si128((const __m128i*)in);
+                const __m128i hi = _mm_shuffle_epi8(digits, _mm_and_si128(_mm_srli_epi16(v, 4), nibble));
+                const __m128i lo = _mm_shuffle_epi8(digits, _mm_and_si128(v, nibble));
+
+                _mm_storeu_si128((__m128i*)out, _mm_unpacklo_epi8(hi, lo));
+                _mm_storeu_si128((__m128i*)(out + 16), _mm_unpackhi_epi8(hi, lo));
+            }
+        }
+
+        RT_TARGET_AVX2 void encodeAvx2(char*& out, const uint8_t*& in, const uint8_t* end)
+        {
+            const __m256i digits = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)Digits));
+            const __m256i nibble = _mm256_set1_epi8(0x0F);
+
+            for (; end - in >= 32; in += 32, out += 64)
+            {
+                const __m256i v  = _mm256_loadu_si256((const __m256i*)in);
+                const __m256i hi = _mm256_shuffle_epi8(digits, _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble));
+                const __m256i lo = _mm256_shuffle_epi8(digits, _mm256_and_si256(v, nibble));
+
+                // The unpacks work within lanes, so put the lanes back in order.
+                const __m256i a = _mm256_unpacklo_epi8(hi, lo);
+                const __m256i b = _mm256_unpackhi_epi8(hi, lo);
+
+                _mm256_storeu_si256((__m256i*)out, _mm256_permute2x128_si256(a, b, 0x20));
+                _mm256_storeu_si256((__m256i*)(out + 32), _mm256_permute2x128_si256(a, b, 0x31));
+            }
+        }
+
+        // Maps 16 digits to their values, clearing valid for anything else.
+        RT_TARGET_SSE42 __m128i digitValues(const __m128i v, __m128i& valid)
+        {
+            const __m128i digit  = _mm_sub_epi8(v, _mm_set1_epi8('0'));
+            const __m128i letter = _mm_sub_epi8(_mm_or_si128(v, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+
+            // unsigned x < n as min(x, n - 1) == x
+            const __m128i isDigit  = _mm_cmpeq_epi8(_mm_min_epu8(digit, _mm_set1_epi8(9)), digit);
+            const __m128i isLetter = _mm_cmpeq_epi8(_mm_min_epu8(letter, _mm_set1_epi8(5)), letter);
+
+            valid = _mm_and_si128(valid, _mm_or_si128(isDigit, isLetter));
+            return _mm_blendv_epi8(_mm_add_epi8(letter, _mm_set1_epi8(10)), digit, isDigit);
+        }
+
+        RT_TARGET_SSE42 bool decodeSsse3(uint8_t*& out, const char*& in, const char* end)
+        {
+            // Each pair of values becomes hi * 16 + lo in a 16-bit lane.
+            const __m128i weights = _mm_set1_epi16(0x0110);
+
+            for (; end - in >= 32; in += 32, out += 16)
+            {
+                __m128i       valid = _mm_set1_epi8(-1);
+                const __m128i a     = digitValues(_mm_loadu_si128((const __m128i*)in), valid);
+                const __m128i b     = digitValues(_mm_loadu_si128((const __m128i*)(in + 16)), valid);
+
+                if (_mm_movemask_epi8(valid) != 0xFFFF)
+                    return false;
+
+                const __m128i bytes = _mm_packus_epi16(_mm_maddubs_epi16(a, weights),
+                                                       _mm_maddubs_epi16(b, weights));
+                _mm_storeu_si128((__m128i*)out, bytes);
+            }
+            return true;
+        }
+
+        RT_TARGET_AVX2 __m256i digitValues(const __m256i v, __m256i& valid)
+        {
+            const __m256i digit  = _mm256_sub_epi8(v, _mm256_set1_epi8('0'));
+            const __m256i letter = _mm256_sub_epi8(_mm256_or_si256(v, _mm256_set1_epi8(0x20)), _mm256_set1_epi8('a'));
+
+            const __m256i isDigit  = _mm256_cmpeq_epi8(_mm256_min_epu8(digit, _mm256_set1_epi8(9)), digit);
+            const __m256i isLetter = _mm256_cmpeq_epi8(_mm256_min_epu8(letter, _mm256_set1_epi8(5)), letter);
+
+            valid = _mm256_and_si256(valid, _mm256_or_si256(isDigit, isLetter));
+            return _mm256_blendv_epi8(_mm256_add_epi8(letter, _mm256_set1_epi8(10)), digit, isDigit);
+        }
+
+        RT_TARGET_AVX2 bool decodeAvx2(uint8_t*& out, const char*& in, const char* end)
+        {
+            const __m256i weights = _mm256_set1_epi16(0x0110);
+
+            for (; end - in >= 64; in += 64, out += 32)
+            {
+                __m256i       valid = _mm256_set1_epi8(-1);
+                const __m256i a     = digitValues(_mm256_loadu_si256((const __m256i*)in), valid);
+                const __m256i b     = digitValues(_mm256_loadu_si256((const __m256i*)(in + 32)), valid);
+
+                if (_mm256_movemask_epi8(valid) != -1)
+                    return false;
+
+                // The pack interleaves the lanes of a and b.
+                const __m256i bytes = _mm256_packus_epi16(_mm256_maddubs_epi16(a, weights),
+                                                          _mm256_maddubs_epi16(b, weights));
+                _mm256_storeu_si256((__m256i*)out, _mm256_permute4x64_epi64(bytes, 0xD8));
+            }
+            return true;
+        }
+
+#endif
+
+        char* dumpRow(char* row, const uint8_t* in, const size_t count)
+        {
+            char* hex = row;
+            for (size_t i = 0; i < HexCodec::RowBytes; ++i)
+            {
+                if (i == 8)
+                    *hex++ = ' ';
+
+                const uint8_t ch = i < count ? in[i] : 0;
+                hex[0]           = Tables.pairs[ch][0];
+                hex[1]           = Tables.pairs[ch][1];
+                hex[2]           = ' ';
+                hex += 3;
+            }
+
+            *hex++ = '|';
+            for (size_t i = 0; i < HexCodec::RowBytes; ++i)
+                *hex++ = i < count ? Tables.printable[in[i]] : '.';
+            *hex++ = '|';
+            *hex++ = '\n';
+            return hex;
+        }
+    }  // namespace
+
+    size_t HexCodec::encode(char* dest, const void* src, const size_t len)
+    {
+        const uint8_t* in  = (const uint8_t*)src;
+        const uint8_t* end = in + len;
+        char*          out = dest;
+
+#if RT_ARCH_X64
+        switch (Cpu::level())
+        {
+        case SIMD_AVX2:
+            encodeAvx2(out, in, end);
+            encodeSsse3(out, in, end);
+            break;
+        case SIMD_SSE42:
+            encodeSsse3(out, in, end);
+            break;
+        default:
+            break;
+        }
+#endif
+        encodeScalar(out, in, end);
+        return size_t(out - dest);
+    }
+
+    size_t HexCodec::decode(void* dest, const char* src, const size_t len)
+    {
+        if (len % 2 != 0)
+            return Npos;
+
+        const char* in  = src;
+        const char* end = src + len;
+        uint8_t*    out = (uint8_t*)dest;
+
+#if RT_ARCH_X64
+        bool valid = true;
+        switch (Cpu::level())
+        {
+        case SIMD_AVX2:
+            valid = decodeAvx2(out, in, end) && decodeSsse3(out, in, end);
+            break;
+        case SIMD_SSE42:
+            valid = decodeSsse3(out, in, end);
+            break;
+        default:
+            break;
+        }
+        if (!valid)
+            return Npos;
+#endif
+        if (!decodeScalar(out, in, end))
+            return Npos;
+        return size_t(out - (uint8_t*)dest);
+    }
+
+    void HexCodec::encode(String& dest, const void* src, const size_t len)
+    {
+        const size_t at = dest.size();
+        dest.resize(at + (len << 1));
+        encode(dest.data() + at, src, len);
+    }
+
+    bool HexCodec::decode(String& dest, const StringView& src)
+    {
+        const size_t at = dest.size();
+        dest.resize(at + (src.size() >> 1));
+
+        if (decode(dest.data() + at, src.data(), src.size()) == Npos)
+        {
+            dest.resize(at);
+            return false;
+        }
+        return true;
+    }
+
+    size_t HexCodec::dumpSize(const size_t len)
+    {
+        return (len + RowBytes - 1) / RowBytes * RowSize;
+    }
+
+    size_t HexCodec::dump(char* dest, const void* src, const size_t len)
+    {
+        const uint8_t* in  = (const uint8_t*)src;
+        char*          out = dest;
+
+        for (size_t i = 0; i < len; i += RowBytes)
+            out = dumpRow(out, in + i, Min(len - i, RowBytes));
+        return size_t(out - dest);
+    }
+
+    void HexCodec::dump(OStream& out, const void* src, const size_t len)
+    {
+        constexpr size_t block = DumpRows * RowBytes;
+
+        String buffer;
+        buffer.resize(dumpSize(Min(len, block)));
+
+        const uint8_t* in = (const uint8_t*)src;
+        for (size_t i = 0; i < len; i += block)
+        {
+            const size_t size = dump(buffer.data(), in + i, Min(len - i, block));
+            out.write(buffer.data(), (std::streamsize)size);
+        }
+    }
+
+}  // namespace Rt2
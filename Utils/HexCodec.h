@@ -0,0 +1,94 @@
+/*
+-------------------------------------------------------------------------------
+    Copyright (c) Charles Carley.
+
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+-------------------------------------------------------------------------------
+*/
+#pragma once
+
+#include "Utils/String.h"
+
+namespace Rt2
+{
+    /**
+     * \brief Hex encoding of raw buffers and hexdump formatting.
+     *
+     * Encoding and decoding run 16 or 32 bytes at a time with SSSE3 or
+     * AVX2 shuffles when Cpu::level allows it, and through lookup tables
+     * otherwise.
+     */
+    class HexCodec
+    {
+    public:
+        /**
+         * \brief The number of bytes shown in one row of a dump.
+         */
+        static constexpr size_t RowBytes = 16;
+
+        /**
+         * \brief The number of characters in one row of a dump, with the newline.
+         */
+        static constexpr size_t RowSize = 68;
+
+        /**
+         * \brief Writes two upper case digits for each of the len bytes
+         * of src into dest, which must have room for 2 * len characters.
+         * \return The number of characters written.
+         */
+        static size_t encode(char* dest, const void* src, size_t len);
+
+        /**
+         * \brief Reads pairs of digits of either case from src.
+         * \return The number of bytes written to dest, or Npos if len is
+         * odd or src holds anything other than hex digits.
+         */
+        static size_t decode(void* dest, const char* src, size_t len);
+
+        /**
+         * \brief Appends the encoded bytes to dest.
+         */
+        static void encode(String& dest, const void* src, size_t len);
+
+        /**
+         * \brief Appends the decoded bytes to dest.
+         * \return False if src is not valid, in which case
+         * dest is left as it was.
+         */
+        static bool decode(String& dest, const StringView& src);
+
+        /**
+         * \return The number of characters that dump writes for len bytes.
+         */
+        static size_t dumpSize(size_t len);
+
+        /**
+         * \brief Formats len bytes of src as rows of RowBytes bytes, the hex
+         * digits followed by the printable characters between bars. The last
+         * row is padded with 00 and '.'.
+         * \param dest Must have room for dumpSize(len) characters.
+         * \return The number of characters written.
+         */
+        static size_t dump(char* dest, const void* src, size_t len);
+
+        /**
+         * \brief Writes the dump to out, a block of rows at a time.
+         */
+        static void dump(OStream& out, const void* src, size_t len);
+    };
+
+}  // namespace Rt2
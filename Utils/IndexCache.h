@@ -138,7 +138,7 @@ namespace Rt2
 
         bool exists(const T& value) const
         {
-            const typename Table::iterator it = _elements.find(value);
+            const typename Table::const_iterator it = _elements.find(value);
             return it != _elements.end();
         }
     };
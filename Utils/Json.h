@@ -105,13 +105,15 @@ namespace Rt2::Json
                     _value.push(value);
                 }
 
-                void push_back(const String& value)
+                void push_back(const StringView& value)
                 {
                     RT_GUARD_CHECK_VOID(!value.empty())
                     // only allow for 32 - 127, \n\r\t
-                    String nv;
-                    Su::filterAscii(nv, value);
-                    _value.push(nv);
+                    for (const char ch : value)
+                    {
+                        if (isPrintableAscii(ch))
+                            _value.push(ch);
+                    }
                 }
 
                 void clear()
@@ -122,6 +124,8 @@ namespace Rt2::Json
 
                 const String& value() const;
 
+                StringView view() const;
+
                 const Type& type() const;
 
                 void setType(const Type& type);
@@ -372,6 +376,11 @@ namespace Rt2::Json
                 return _value.value();
             }
 
+            inline StringView Token::view() const
+            {
+                return _value.view();
+            }
+
             inline const Type& Token::type() const
             {
                 return _type;
@@ -513,9 +522,9 @@ namespace Rt2::Json
                     return cast<ObjectValue>();
                 }
 
-                void setValue(const String& v)
+                void setValue(const StringView& v)
                 {
-                    _value.assign(v.c_str(), v.size());
+                    _value.assign(v.data(), v.size());
                     notifyStringChanged();
                 }
 
@@ -1188,9 +1197,9 @@ namespace Rt2::Json
 
             virtual void objectFinished() {}
 
-            virtual void keyValueParsed(const String&    key,
-                                        const Lex::Type& valueType,
-                                        const String&    value) {}
+            virtual void keyValueParsed(const StringView& key,
+                                        const Lex::Type&  valueType,
+                                        const StringView& value) {}
 
             virtual void arrayStarted() {}
 
@@ -1198,15 +1207,15 @@ namespace Rt2::Json
 
             virtual void arrayParsed() {}
 
-            virtual void stringParsed(const String& value) {}
+            virtual void stringParsed(const StringView& value) {}
 
-            virtual void integerParsed(const String& value) {}
+            virtual void integerParsed(const StringView& value) {}
 
-            virtual void doubleParsed(const String& value) {}
+            virtual void doubleParsed(const StringView& value) {}
 
-            virtual void booleanParsed(const String& value) {}
+            virtual void booleanParsed(const StringView& value) {}
 
-            virtual void pointerParsed(const String& value) {}
+            virtual void pointerParsed(const StringView& value) {}
         };
 
         Visitor* defaultVisitor();
@@ -1282,7 +1291,7 @@ namespace Rt2::Json
                         return;
                     }
 
-                    _visitor->keyValueParsed(t1.value(), type, t2.value());
+                    _visitor->keyValueParsed(t1.view(), type, t2.view());
 
                     scn.scan(tok);
                     if (tok.type() >= Lex::JT_NULL)
@@ -1327,19 +1336,19 @@ namespace Rt2::Json
                         _visitor->objectParsed();
                         break;
                     case Lex::JT_STRING:
-                        _visitor->stringParsed(t1.value());
+                        _visitor->stringParsed(t1.view());
                         break;
                     case Lex::JT_NULL:
-                        _visitor->pointerParsed(t1.value());
+                        _visitor->pointerParsed(t1.view());
                         break;
                     case Lex::JT_BOOL:
-                        _visitor->booleanParsed(t1.value());
+                        _visitor->booleanParsed(t1.view());
                         break;
                     case Lex::JT_NUMBER:
-                        _visitor->doubleParsed(t1.value());
+                        _visitor->doubleParsed(t1.view());
                         break;
                     case Lex::JT_INTEGER:
-                        _visitor->integerParsed(t1.value());
+                        _visitor->integerParsed(t1.view());
                         break;
                     case Lex::JT_UNDEFINED:
                     case Lex::JT_COLON:
@@ -1515,7 +1524,7 @@ namespace Rt2::Json
                 void parseError(const String& str, const Lex::Token& last) override
                 {
                     Console::println("parse error: ", str);
-                    Console::println("   : [", last.value().c_str(), ',', last.type(), ']');
+                    Console::println("   : [", last.view(), ',', last.type(), ']');
                     clear();
                 }
 
@@ -1567,9 +1576,9 @@ namespace Rt2::Json
                     }
                 }
 
-                void keyValueParsed(const String&    key,
-                                    const Lex::Type& valueType,
-                                    const String&    value) override
+                void keyValueParsed(const StringView& key,
+                                    const Lex::Type&  valueType,
+                                    const StringView& value) override
                 {
                     if (_obj.empty())
                     {
@@ -1627,11 +1636,11 @@ namespace Rt2::Json
                     if (obj != nullptr)
                     {
                         obj->setValue(value);
-                        top->insert(key, obj);
+                        top->insert(String(key), obj);
                     }
                 }
 
-                void handleArrayType(Value* obj, const String& value)
+                void handleArrayType(Value* obj, const StringView& value)
                 {
                     if (obj != nullptr)
                     {
@@ -1641,31 +1650,31 @@ namespace Rt2::Json
                     }
                 }
 
-                void stringParsed(const String& value) override
+                void stringParsed(const StringView& value) override
                 {
                     RT_GUARD_CHECK_VOID(!_arr.empty())
                     handleArrayType(new StringValue(), value);
                 }
 
-                void integerParsed(const String& value) override
+                void integerParsed(const StringView& value) override
                 {
                     RT_GUARD_CHECK_VOID(!_arr.empty())
                     handleArrayType(new IntegerValue(), value);
                 }
 
-                void doubleParsed(const String& value) override
+                void doubleParsed(const StringView& value) override
                 {
                     RT_GUARD_CHECK_VOID(!_arr.empty())
                     handleArrayType(new RealValue(), value);
                 }
 
-                void booleanParsed(const String& value) override
+                void booleanParsed(const StringView& value) override
                 {
                     RT_GUARD_CHECK_VOID(!_arr.empty())
                     handleArrayType(new BoolValue(), value);
                 }
 
-                void pointerParsed(const String& value) override
+                void pointerParsed(const StringView& value) override
                 {
                     RT_GUARD_CHECK_VOID(!_arr.empty())
                     handleArrayType(new PointerValue(), value);
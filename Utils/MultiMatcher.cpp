@@ -0,0 +1,315 @@
+/*
+-------------------------------------------------------------------------------
+    Copyright (c) Charles Carley.
+
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+-------------------------------------------------------------------------------
+*/
+#include "Utils/MultiMatcher.h"
+#include "Utils/Exception.h"
+
+namespace Rt2
+{
+    MultiMatcher::MultiMatcher(const std::initializer_list<std::pair<StringView, StringView>> replacements)
+    {
+        for (const auto& [pattern, replacement] : replacements)
+            add(pattern, replacement);
+        compile();
+    }
+
+    MultiMatcher::MultiMatcher(const StringMap& replacements)
+    {
+        for (const auto& [pattern, replacement] : replacements)
+            add(pattern, replacement);
+        compile();
+    }
+
+    U32 MultiMatcher::add(const StringView& pattern, const StringView& replacement)
+    {
+        if (pattern.empty())
+            throw Exception("a pattern cannot be empty");
+
+        _compiled = false;
+        _patterns.push_back({String(pattern), String(replacement)});
+        return (U32)_patterns.size() - 1;
+    }
+
+    void MultiMatcher::compile()
+    {
+        _compiled = false;
+        _next.clear();
+        _output.clear();
+        _depth.clear();
+        _lengths.clear();
+        _longest = 0;
+
+        // Give each byte that occurs in a pattern its own column.
+        // Column zero is shared by all of the other bytes.
+        size_t total   = 0;
+        U32    columns = 1;
+        std::fill_n(_classes, 256, U16(0));
+        for (const Pattern& pattern : _patterns)
+        {
+            for (const char ch : pattern.text)
+            {
+                if (U16& column = _classes[U8(ch)]; column == 0)
+                    column = (U16)columns++;
+            }
+            total += pattern.text.size();
+            _longest = Max(_longest, pattern.text.size());
+            _lengths.push_back((U32)pattern.text.size());
+        }
+
+        // Rows are a power of two wide so that a state
+        // and the offset of its row are a shift apart.
+        _shift = 0;
+        while ((U32(1) << _shift) < columns)
+            ++_shift;
+        _width = U32(1) << _shift;
+
+        if ((total + 1) * _width >= Npos32)
+            throw Exception("the pattern set is too large to compile");
+
+        const auto newState = [this](const U32 depth)
+        {
+            const U32 state = _depth.size();
+            _depth.push_back(depth);
+            _output.push_back(Npos32);
+            _next.resize(_next.size() + _width, Npos32);
+            return state;
+        };
+
+        // Insert the patterns into a trie, where output
+        // marks the first pattern that ends at a state.
+        newState(0);
+        for (U32 index = 0; index < (U32)_patterns.size(); ++index)
+        {
+            U32 state = 0;
+            for (const char ch : _patterns[index].text)
+            {
+                const U32 slot = state * _width + _classes[U8(ch)];
+                if (_next[slot] == Npos32)
+                {
+                    const U32 child = newState(_depth[state] + 1);
+                    _next[slot]     = child;
+                }
+                state = _next[slot];
+            }
+
+            if (_output[state] == Npos32)
+                _output[state] = index;
+        }
+
+        // Breadth first, fill in the missing transitions from the failure
+        // state, which is always at a smaller depth and so already complete.
+        // States without a pattern of their own inherit the output of their
+        // failure state, which is the longest pattern ending there.
+        const U32 states = _depth.size();
+
+        Table fail;
+        fail.resize(states, 0);
+
+        Table queue;
+        queue.reserve(states);
+
+        for (U32 column = 0; column < _width; ++column)
+        {
+            if (U32& child = _next[column]; child == Npos32)
+                child = 0;
+            else
+                queue.push_back(child);
+        }
+
+        for (U32 head = 0; head < queue.size(); ++head)
+        {
+            const U32 state = queue[head];
+            const U32 row   = state * _width;
+            const U32 back  = fail[state] * _width;
+
+            for (U32 column = 0; column < _width; ++column)
+            {
+                const U32 to   = _next[back + column];
+                U32&      next = _next[row + column];
+
+                if (next == Npos32)
+                    next = to;
+                else
+                {
+                    fail[next] = to;
+                    if (_output[next] == Npos32)
+                        _output[next] = _output[to];
+                    queue.push_back(next);
+                }
+            }
+        }
+
+        // From here on the table holds row offsets rather than states.
+        for (U32& next : _next)
+            next <<= _shift;
+
+        _compiled = true;
+    }
+
+    void MultiMatcher::require() const
+    {
+        if (!_compiled)
+            throw Exception("the patterns have not been compiled");
+    }
+
+    template <typename Visitor>
+    size_t MultiMatcher::scan(const StringView& text, Visitor&& visit) const
+    {
+        require();
+        if (_patterns.empty())
+            return 0;
+
+        const U32* next    = _next.data();
+        const U32* output  = _output.data();
+        const U32* depth   = _depth.data();
+        const U32* lengths = _lengths.data();
+        const U8*  bytes   = (const U8*)text.data();
+
+        const size_t size  = text.size();
+        size_t       count = 0;
+        size_t       pos   = 0;
+
+        while (pos < size)
+        {
+            // Skip the bytes that leave the root where it is.
+            while (pos < size && next[_classes[bytes[pos]]] == 0)
+                ++pos;
+
+            U32    row   = 0;
+            U32    found = Npos32;
+            size_t start = 0, end = 0;
+
+            for (size_t i = pos; i < size; ++i)
+            {
+                row             = next[row + _classes[bytes[i]]];
+                const U32 state = row >> _shift;
+
+                // Once the longest live prefix begins past the start of the
+                // best match so far, nothing can begin earlier or extend it.
+                if (found != Npos32 && i + 1 - depth[state] > start)
+                    break;
+
+                if (const U32 index = output[state]; index != Npos32)
+                {
+                    const size_t from = i + 1 - lengths[index];
+                    if (found == Npos32 || from <= start)
+                    {
+                        found = index;
+                        start = from;
+                        end   = i + 1;
+                    }
+                }
+            }
+
+            if (found == Npos32)
+                break;
+
+            visit(start, end - start, found);
+            ++count;
+            pos = end;
+        }
+        return count;
+    }
+
+    bool MultiMatcher::containsAny(const StringView& text) const
+    {
+        require();
+
+        U32 row = 0;
+        for (const char ch : text)
+        {
+            row = _next[row + _classes[U8(ch)]];
+            if (_output[row >> _shift] != Npos32)
+                return true;
+        }
+        return false;
+    }
+
+    size_t MultiMatcher::findAll(MultiMatches& dest, const StringView& text) const
+    {
+        return scan(text,
+                    [&dest](const size_t offset, const size_t length, const U32 pattern)
+                    {
+                        dest.push_back({offset, length, pattern});
+                    });
+    }
+
+    size_t MultiMatcher::replaceAll(String& dest, const StringView& input) const
+    {
+        String result;
+        size_t from = 0;
+
+        const size_t count = scan(
+            input,
+            [&](const size_t offset, const size_t length, const U32 pattern)
+            {
+                if (result.empty())
+                    result.reserve(input.size() + _longest);
+                result.append(input.data() + from, offset - from);
+                result.append(_patterns[pattern].replacement);
+                from = offset + length;
+            });
+
+        if (count == 0)
+        {
+            if (dest.data() != input.data() || dest.size() != input.size())
+                dest.assign(input.data(), input.size());
+            return 0;
+        }
+
+        result.append(input.data() + from, input.size() - from);
+        dest.swap(result);
+        return count;
+    }
+
+    size_t MultiMatcher::replaceAll(String& inOut) const
+    {
+        return replaceAll(inOut, inOut);
+    }
+
+    const String& MultiMatcher::pattern(const U32 index) const
+    {
+        if (index >= _patterns.size())
+            throw Exception("array index out of bounds");
+        return _patterns[index].text;
+    }
+
+    const String& MultiMatcher::replacement(const U32 index) const
+    {
+        if (index >= _patterns.size())
+            throw Exception("array index out of bounds");
+        return _patterns[index].replacement;
+    }
+
+    void MultiMatcher::clear()
+    {
+        _patterns.clear();
+        _next.clear();
+        _output.clear();
+        _depth.clear();
+        _lengths.clear();
+        _longest  = 0;
+        _width    = 1;
+        _shift    = 0;
+        _compiled = false;
+    }
+
+}  // namespace Rt2
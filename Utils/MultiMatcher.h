@@ -0,0 +1,170 @@
+/*
+-------------------------------------------------------------------------------
+    Copyright (c) Charles Carley.
+
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+-------------------------------------------------------------------------------
+*/
+#pragma once
+
+#include <initializer_list>
+#include <utility>
+#include "Utils/Array.h"
+#include "Utils/String.h"
+
+namespace Rt2
+{
+    struct MultiMatch
+    {
+        size_t offset;
+        size_t length;
+        U32    pattern;
+    };
+
+    using MultiMatches = SimpleArray<MultiMatch>;
+
+    /**
+     * \brief Finds and replaces any number of patterns in a single
+     * pass over the text.
+     *
+     * The patterns are compiled into an Aho–Corasick automaton with a
+     * dense transition table. Bytes that appear in no pattern share one
+     * column of the table, so its width is the number of distinct
+     * pattern bytes plus one.
+     *
+     * Matches are reported leftmost first, preferring the longest pattern
+     * at a given offset, and never overlap. That is the order that
+     * chained calls to Su::replaceAll would produce if every pattern was
+     * replaced at the same time. After a match, at most the length of the
+     * longest pattern is scanned again, so a pass is linear in the size
+     * of the text.
+     *
+     * Once compiled the queries are const and safe to share between threads.
+     */
+    class MultiMatcher
+    {
+    private:
+        struct Pattern
+        {
+            String text;
+            String replacement;
+        };
+
+        using Patterns = std::vector<Pattern>;
+        using Table    = SimpleArray<U32>;
+
+        Patterns _patterns;
+        Table    _next;
+        Table    _output;
+        Table    _depth;
+        Table    _lengths;
+        U16      _classes[256]{};
+        U32      _width{1};
+        U32      _shift{0};
+        size_t   _longest{0};
+        bool     _compiled{false};
+
+    public:
+        MultiMatcher() = default;
+
+        /**
+         * \brief Adds each pattern and replacement pair in order and compiles.
+         */
+        MultiMatcher(std::initializer_list<std::pair<StringView, StringView>> replacements);
+
+        /**
+         * \brief Adds every key as a pattern that is replaced with its value
+         * and compiles.
+         */
+        explicit MultiMatcher(const StringMap& replacements);
+
+        /**
+         * \brief Adds a pattern. Adding invalidates the compiled
+         * automaton until the next call to compile.
+         * \param pattern The text to search for. It may not be empty.
+         * \param replacement The text that replaceAll substitutes for it.
+         * \return The index of the pattern, which is reported in MultiMatch.
+         * If the same pattern is added more than once, only the first one
+         * is ever matched.
+         * \throws Exception if the pattern is empty.
+         */
+        U32 add(const StringView& pattern, const StringView& replacement = {});
+
+        /**
+         * \brief Builds the automaton from the added patterns.
+         */
+        void compile();
+
+        /**
+         * \return True if any pattern occurs in the text. Stops at the
+         * first match.
+         */
+        bool containsAny(const StringView& text) const;
+
+        /**
+         * \brief Appends the matches in the text to dest.
+         * \return The number of matches that were found.
+         */
+        size_t findAll(MultiMatches& dest, const StringView& text) const;
+
+        /**
+         * \brief Copies the input to dest with every match substituted
+         * with the replacement of its pattern.
+         * \return The number of replacements that were made.
+         */
+        size_t replaceAll(String& dest, const StringView& input) const;
+
+        /**
+         * \brief Replaces the matches in place.
+         */
+        size_t replaceAll(String& inOut) const;
+
+        const String& pattern(U32 index) const;
+
+        const String& replacement(U32 index) const;
+
+        U32 size() const;
+
+        bool empty() const;
+
+        bool compiled() const;
+
+        void clear();
+
+    private:
+        void require() const;
+
+        template <typename Visitor>
+        size_t scan(const StringView& text, Visitor&& visit) const;
+    };
+
+    inline U32 MultiMatcher::size() const
+    {
+        return (U32)_patterns.size();
+    }
+
+    inline bool MultiMatcher::empty() const
+    {
+        return _patterns.empty();
+    }
+
+    inline bool MultiMatcher::compiled() const
+    {
+        return _compiled;
+    }
+
+}  // namespace Rt2
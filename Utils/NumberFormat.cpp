@@ -0,0 +1,543 @@
+/*
+-------------------------------------------------------------------------------
+    Copyright (c) Charles Carley.
+
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+-------------------------------------------------------------------------------
+*/
+#include "Utils/NumberFormat.h"
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace Rt2
+{
+    namespace
+    {
+        constexpr char DigitPairs[201] =
+            "00010203040506070809"
+            "10111213141516171819"
+            "20212223242526272829"
+            "30313233343536373839"
+            "40414243444546474849"
+            "50515253545556575859"
+            "60616263646566676869"
+            "70717273747576777879"
+            "80818283848586878889"
+            "90919293949596979899";
+
+        // Writes the digits of v so that the last one lands at end[-1].
+        void writeDigits(char* end, U64 v)
+        {
+            while (v >= 100)
+            {
+                const U64 q = v / 100;
+                const U32 r = U32(v - q * 100) << 1;
+
+                v = q;
+                *--end = DigitPairs[r + 1];
+                *--end = DigitPairs[r];
+            }
+
+            if (v >= 10)
+            {
+                const U32 r = U32(v) << 1;
+                *--end      = DigitPairs[r + 1];
+                *--end      = DigitPairs[r];
+            }
+            else
+                *--end = char('0' + v);
+        }
+
+        // Grisu2, after Florian Loitsch, "Printing Floating-Point
+        // Numbers Quickly and Accurately with Integers" (PLDI 2010).
+
+        struct DiyFp
+        {
+            U64 f;
+            int e;
+        };
+
+        DiyFp sub(const DiyFp& x, const DiyFp& y)
+        {
+            return {x.f - y.f, x.e};
+        }
+
+        // The upper 64 bits of the 128 bit product, rounded.
+        DiyFp mul(const DiyFp& x, const DiyFp& y)
+        {
+            const U64 u_lo = x.f & 0xFFFFFFFF;
+            const U64 u_hi = x.f >> 32;
+            const U64 v_lo = y.f & 0xFFFFFFFF;
+            const U64 v_hi = y.f >> 32;
+
+            const U64 p0 = u_lo * v_lo;
+            const U64 p1 = u_lo * v_hi;
+            const U64 p2 = u_hi * v_lo;
+            const U64 p3 = u_hi * v_hi;
+
+            U64 q = (p0 >> 32) + (p1 & 0xFFFFFFFF) + (p2 & 0xFFFFFFFF);
+            q += U64(1) << 31;
+
+            return {p3 + (p1 >> 32) + (p2 >> 32) + (q >> 32), x.e + y.e + 64};
+        }
+
+        DiyFp normalize(DiyFp x)
+        {
+            while ((x.f >> 63) == 0)
+            {
+                x.f <<= 1;
+                x.e--;
+            }
+            return x;
+        }
+
+        DiyFp normalizeTo(const DiyFp& x, const int e)
+        {
+            return {x.f << (x.e - e), e};
+        }
+
+        struct Boundaries
+        {
+            DiyFp w;
+            DiyFp minus;
+            DiyFp plus;
+        };
+
+        // Computes v and the midpoints between v and its neighbours,
+        // with the upper midpoint normalized and the lower one
+        // sharing its exponent.
+        template <typename T, typename Bits>
+        Boundaries boundaries(const T value)
+        {
+            constexpr int Precision = std::numeric_limits<T>::digits;
+            constexpr int Bias      = std::numeric_limits<T>::max_exponent - 1 + (Precision - 1);
+            constexpr int MinExp    = 1 - Bias;
+            constexpr U64 HiddenBit = U64(1) << (Precision - 1);
+
+            Bits bits;
+            memcpy(&bits, &value, sizeof(T));
+
+            const U64 e = U64(bits) >> (Precision - 1);
+            const U64 f = U64(bits) & (HiddenBit - 1);
+
+            const DiyFp v = e == 0
+                                ? DiyFp{f, MinExp}
+                                : DiyFp{f + HiddenBit, int(e) - Bias};
+
+            const bool closerBelow = f == 0 && e > 1;
+
+            const DiyFp plus  = normalize({2 * v.f + 1, v.e - 1});
+            const DiyFp minus = closerBelow
+                                    ? DiyFp{4 * v.f - 1, v.e - 2}
+                                    : DiyFp{2 * v.f - 1, v.e - 1};
+
+            return {normalize(v), normalizeTo(minus, plus.e), plus};
+        }
+
+        constexpr int Alpha = -60;
+
+        struct CachedPower
+        {
+            U64 f;
+            int e;
+            int k;
+        };
+
+        // Normalized 10^k for k = -300, -292, ..., 324.
+        constexpr int MinCachedExp  = -300;
+        constexpr int CachedExpStep = 8;
+
+        constexpr CachedPower CachedPowers[] = {
+            {0xAB70FE17C79AC6CA, -1060, -300},
+            {0xFF77B1FCBEBCDC4F, -1034, -292},
+            {0xBE5691EF416BD60C, -1007, -284},
+            {0x8DD01FAD907FFC3C,  -980, -276},
+            {0xD3515C2831559A83,  -954, -268},
+            {0x9D71AC8FADA6C9B5,  -927, -260},
+            {0xEA9C227723EE8BCB,  -901, -252},
+            {0xAECC49914078536D,  -874, -244},
+            {0x823C12795DB6CE57,  -847, -236},
+            {0xC21094364DFB5637,  -821, -228},
+            {0x9096EA6F3848984F,  -794, -220},
+            {0xD77485CB25823AC7,  -768, -212},
+            {0xA086CFCD97BF97F4,  -741, -204},
+            {0xEF340A98172AACE5,  -715, -196},
+            {0xB23867FB2A35B28E,  -688, -188},
+            {0x84C8D4DFD2C63F3B,  -661, -180},
+            {0xC5DD44271AD3CDBA,  -635, -172},
+            {0x936B9FCEBB25C996,  -608, -164},
+            {0xDBAC6C247D62A584,  -582, -156},
+            {0xA3AB66580D5FDAF6,  -555, -148},
+            {0xF3E2F893DEC3F126,  -529, -140},
+            {0xB5B5ADA8AAFF80B8,  -502, -132},
+            {0x87625F056C7C4A8B,  -475, -124},
+            {0xC9BCFF6034C13053,  -449, -116},
+            {0x964E858C91BA2655,  -422, -108},
+            {0xDFF9772470297EBD,  -396, -100},
+            {0xA6DFBD9FB8E5B88F,  -369,  -92},
+            {0xF8A95FCF88747D94,  -343,  -84},
+            {0xB94470938FA89BCF,  -316,  -76},
+            {0x8A08F0F8BF0F156B,  -289,  -68},
+            {0xCDB02555653131B6,  -263,  -60},
+            {0x993FE2C6D07B7FAC,  -236,  -52},
+            {0xE45C10C42A2B3B06,  -210,  -44},
+            {0xAA242499697392D3,  -183,  -36},
+            {0xFD87B5F28300CA0E,  -157,  -28},
+            {0xBCE5086492111AEB,  -130,  -20},
+            {0x8CBCCC096F5088CC,  -103,  -12},
+            {0xD1B71758E219652C,   -77,   -4},
+            {0x9C40000000000000,   -50,    4},
+            {0xE8D4A51000000000,   -24,   12},
+            {0xAD78EBC5AC620000,     3,   20},
+            {0x813F3978F8940984,    30,   28},
+            {0xC097CE7BC90715B3,    56,   36},
+            {0x8F7E32CE7BEA5C70,    83,   44},
+            {0xD5D238A4ABE98068,   109,   52},
+            {0x9F4F2726179A2245,   136,   60},
+            {0xED63A231D4C4FB27,   162,   68},
+            {0xB0DE65388CC8ADA8,   189,   76},
+            {0x83C7088E1AAB65DB,   216,   84},
+            {0xC45D1DF942711D9A,   242,   92},
+            {0x924D692CA61BE758,   269,  100},
+            {0xDA01EE641A708DEA,   295,  108},
+            {0xA26DA3999AEF774A,   322,  116},
+            {0xF209787BB47D6B85,   348,  124},
+            {0xB454E4A179DD1877,   375,  132},
+            {0x865B86925B9BC5C2,   402,  140},
+            {0xC83553C5C8965D3D,   428,  148},
+            {0x952AB45CFA97A0B3,   455,  156},
+            {0xDE469FBD99A05FE3,   481,  164},
+            {0xA59BC234DB398C25,   508,  172},
+            {0xF6C69A72A3989F5C,   534,  180},
+            {0xB7DCBF5354E9BECE,   561,  188},
+            {0x88FCF317F22241E2,   588,  196},
+            {0xCC20CE9BD35C78A5,   614,  204},
+            {0x98165AF37B2153DF,   641,  212},
+            {0xE2A0B5DC971F303A,   667,  220},
+            {0xA8D9D1535CE3B396,   694,  228},
+            {0xFB9B7CD9A4A7443C,   720,  236},
+            {0xBB764C4CA7A44410,   747,  244},
+            {0x8BAB8EEFB6409C1A,   774,  252},
+            {0xD01FEF10A657842C,   800,  260},
+            {0x9B10A4E5E9913129,   827,  268},
+            {0xE7109BFBA19C0C9D,   853,  276},
+            {0xAC2820D9623BF429,   880,  284},
+            {0x80444B5E7AA7CF85,   907,  292},
+            {0xBF21E44003ACDD2D,   933,  300},
+            {0x8E679C2F5E44FF8F,   960,  308},
+            {0xD433179D9C8CB841,   986,  316},
+            {0x9E19DB92B4E31BA9,  1013,  324},
+        };
+
+        // Returns a cached power of ten c such that the binary
+        // exponent of c * 2^e lies in [-60, -32].
+        const CachedPower& cachedPower(const int e)
+        {
+            // 78913 / 2^18 approximates log10(2)
+            const int f = Alpha - e - 1;
+            const int k = (f * 78913) / (1 << 18) + int(f > 0);
+
+            const int index = (-MinCachedExp + k + (CachedExpStep - 1)) / CachedExpStep;
+            return CachedPowers[index];
+        }
+
+        int largestPow10(const U32 n, U32& pow10)
+        {
+            constexpr U32 Powers[] = {
+                1000000000,
+                100000000,
+                10000000,
+                1000000,
+                100000,
+                10000,
+                1000,
+                100,
+                10,
+            };
+
+            for (int i = 0; i < 9; ++i)
+            {
+                if (n >= Powers[i])
+                {
+                    pow10 = Powers[i];
+                    return 10 - i;
+                }
+            }
+            pow10 = 1;
+            return 1;
+        }
+
+        void round(char*     buf,
+                   const int len,
+                   const U64 dist,
+                   const U64 delta,
+                   U64       rest,
+                   const U64 tenK)
+        {
+            while (rest < dist &&
+                   delta - rest >= tenK &&
+                   (rest + tenK < dist || dist - rest > rest + tenK - dist))
+            {
+                buf[len - 1]--;
+                rest += tenK;
+            }
+        }
+
+        void generate(char*        buf,
+                      int&         len,
+                      int&         exponent,
+                      const DiyFp& low,
+                      const DiyFp& w,
+                      const DiyFp& high)
+        {
+            U64 delta = sub(high, low).f;
+            U64 dist  = sub(high, w).f;
+
+            const DiyFp one = {U64(1) << -high.e, high.e};
+
+            U32 p1 = U32(high.f >> -one.e);
+            U64 p2 = high.f & (one.f - 1);
+
+            U32 pow10;
+            int n = largestPow10(p1, pow10);
+
+            while (n > 0)
+            {
+                const U32 d = p1 / pow10;
+                p1 %= pow10;
+
+                buf[len++] = char('0' + d);
+                --n;
+
+                const U64 rest = (U64(p1) << -one.e) + p2;
+                if (rest <= delta)
+                {
+                    exponent += n;
+                    round(buf, len, dist, delta, rest, U64(pow10) << -one.e);
+                    return;
+                }
+                pow10 /= 10;
+            }
+
+            int m = 0;
+            for (;;)
+            {
+                p2 *= 10;
+
+                buf[len++] = char('0' + (p2 >> -one.e));
+                p2 &= one.f - 1;
+                ++m;
+
+                delta *= 10;
+                dist *= 10;
+                if (p2 <= delta)
+                    break;
+            }
+
+            exponent -= m;
+            round(buf, len, dist, delta, p2, one.f);
+        }
+
+        // Writes the shortest digits of a finite, positive value to
+        // buf, so that value = buf * 10^exponent.
+        template <typename T, typename Bits>
+        int grisu2(char* buf, int& exponent, const T value)
+        {
+            const Boundaries   b = boundaries<T, Bits>(value);
+            const CachedPower& c = cachedPower(b.plus.e);
+
+            const DiyFp ck = {c.f, c.e};
+
+            const DiyFp w  = mul(b.w, ck);
+            const DiyFp lo = mul(b.minus, ck);
+            const DiyFp hi = mul(b.plus, ck);
+
+            int len  = 0;
+            exponent = -c.k;
+            generate(buf, len, exponent, {lo.f + 1, lo.e}, w, {hi.f - 1, hi.e});
+            return len;
+        }
+
+        U32 writeExponent(char* dest, int e)
+        {
+            char* p = dest;
+            if (e < 0)
+            {
+                *p++ = '-';
+                e    = -e;
+            }
+            else
+                *p++ = '+';
+
+            if (e < 10)
+                *p++ = '0';
+
+            const U32 n = NumberFormat::digits(U64(e));
+            writeDigits(p + n, U64(e));
+            return U32(p + n - dest);
+        }
+
+        // Lays out len digits with value digits * 10^exponent.
+        U32 layout(char* dest, const char* digits, const int len, const int exponent)
+        {
+            // decimal exponent of the leading digit
+            const int x = len + exponent - 1;
+
+            char* p = dest;
+            if (x < -4 || x >= 17)
+            {
+                *p++ = digits[0];
+                if (len > 1)
+                {
+                    *p++ = '.';
+                    memcpy(p, digits + 1, size_t(len - 1));
+                    p += len - 1;
+                }
+                *p++ = 'e';
+                p += writeExponent(p, x);
+            }
+            else if (exponent >= 0)
+            {
+                memcpy(p, digits, size_t(len));
+                p += len;
+                memset(p, '0', size_t(exponent));
+                p += exponent;
+            }
+            else if (x >= 0)
+            {
+                memcpy(p, digits, size_t(x + 1));
+                p += x + 1;
+                *p++ = '.';
+                memcpy(p, digits + x + 1, size_t(len - x - 1));
+                p += len - x - 1;
+            }
+            else
+            {
+                *p++ = '0';
+                *p++ = '.';
+                memset(p, '0', size_t(-x - 1));
+                p += -x - 1;
+                memcpy(p, digits, size_t(len));
+                p += len;
+            }
+            return U32(p - dest);
+        }
+
+        template <typename T, typename Bits>
+        U32 writeReal(char* dest, const T v)
+        {
+            char* p = dest;
+            if (std::signbit(v))
+                *p++ = '-';
+
+            if (std::isnan(v))
+            {
+                memcpy(p, "nan", 3);
+                return U32(p + 3 - dest);
+            }
+            if (std::isinf(v))
+            {
+                memcpy(p, "inf", 3);
+                return U32(p + 3 - dest);
+            }
+            if (v == 0)
+            {
+                *p++ = '0';
+                return U32(p - dest);
+            }
+
+            char digits[20];
+            int  exponent;
+
+            const int len = grisu2<T, Bits>(digits, exponent, std::abs(v));
+            return U32(p - dest) + layout(p, digits, len, exponent);
+        }
+
+    }  // namespace
+
+    U32 NumberFormat::digits(U64 v)
+    {
+        U32 n = 1;
+        for (;;)
+        {
+            if (v < 10) return n;
+            if (v < 100) return n + 1;
+            if (v < 1000) return n + 2;
+            if (v < 10000) return n + 3;
+            v /= 10000;
+            n += 4;
+        }
+    }
+
+    U32 NumberFormat::integer(char* dest, const U64 v)
+    {
+        const U32 n = digits(v);
+        writeDigits(dest + n, v);
+        return n;
+    }
+
+    U32 NumberFormat::integer(char* dest, const I64 v)
+    {
+        if (v < 0)
+        {
+            *dest = '-';
+            return 1 + integer(dest + 1, U64(0) - U64(v));
+        }
+        return integer(dest, U64(v));
+    }
+
+    U32 NumberFormat::real(char* dest, const double v)
+    {
+        return writeReal<double, U64>(dest, v);
+    }
+
+    U32 NumberFormat::real(char* dest, const float v)
+    {
+        return writeReal<float, U32>(dest, v);
+    }
+
+    U32 NumberFormat::classicPoint(char* dest, const U32 len)
+    {
+        const auto isDigit = [](const char ch)
+        {
+            return ch >= '0' && ch <= '9';
+        };
+
+        U32 i = 0;
+        if (i < len && (dest[i] == '-' || dest[i] == '+'))
+            ++i;
+
+        const U32 first = i;
+        while (i < len && isDigit(dest[i]))
+            ++i;
+
+        // The point may be several bytes long, it runs up
+        // to the fraction digits or to the exponent.
+        if (i == first || i >= len || dest[i] == '.' || dest[i] == 'e' || dest[i] == 'E')
+            return len;
+
+        U32 j = i;
+        while (j < len && !isDigit(dest[j]) && dest[j] != 'e' && dest[j] != 'E')
+            ++j;
+
+        dest[i] = '.';
+        memmove(dest + i + 1, dest + j, len - j);
+        return len - (j - i - 1);
+    }
+
+}  // namespace Rt2
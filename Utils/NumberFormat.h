@@ -0,0 +1,91 @@
+/*
+-------------------------------------------------------------------------------
+    Copyright (c) Charles Carley.
+
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+-------------------------------------------------------------------------------
+*/
+#pragma once
+
+#include "Utils/Definitions.h"
+
+namespace Rt2
+{
+    /**
+     * \brief Formats numbers straight into a caller supplied buffer.
+     *
+     * Integers are written two digits at a time from a digit pair table.
+     * Reals are written with the shortest digit string that reads back
+     * to the same value (Grisu2), laid out like printf's %g: fixed
+     * notation when the decimal exponent is in [-4, 17), otherwise
+     * scientific notation with at least two exponent digits.
+     *
+     * None of the functions write a null terminator; they return the
+     * number of characters written.
+     */
+    class NumberFormat
+    {
+    public:
+        /**
+         * \brief The largest number of characters any integer overload writes.
+         */
+        static constexpr U32 IntegerLength = 20;
+
+        /**
+         * \brief The largest number of characters any real overload writes.
+         */
+        static constexpr U32 RealLength = 32;
+
+        static U32 integer(char* dest, U64 v);
+
+        static U32 integer(char* dest, I64 v);
+
+        static U32 integer(char* dest, U32 v);
+
+        static U32 integer(char* dest, I32 v);
+
+        static U32 real(char* dest, double v);
+
+        static U32 real(char* dest, float v);
+
+        /**
+         * \return The number of decimal digits in v.
+         */
+        static U32 digits(U64 v);
+
+        /**
+         * \brief Replaces the decimal point that printf wrote for the
+         * LC_NUMERIC locale with '.', the point of the classic locale.
+         *
+         * Only the point of %f, %e and %g output depends on the locale,
+         * so the result reads the same as a default stream would write it.
+         * \return The length of the text after the replacement.
+         */
+        static U32 classicPoint(char* dest, U32 len);
+    };
+
+    inline U32 NumberFormat::integer(char* dest, const U32 v)
+    {
+        return integer(dest, (U64)v);
+    }
+
+    inline U32 NumberFormat::integer(char* dest, const I32 v)
+    {
+        return integer(dest, (I64)v);
+    }
+
+}  // namespace Rt2
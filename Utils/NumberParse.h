@@ -0,0 +1,75 @@
+/*
+-------------------------------------------------------------------------------
+    Copyright (c) Charles Carley.
+
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+-------------------------------------------------------------------------------
+*/
+#pragma once
+
+#include "Utils/Definitions.h"
+
+namespace Rt2
+{
+    enum ParseError
+    {
+        PE_NONE,
+        // No number was found at the start of the input.
+        PE_INVALID,
+        // The number does not fit in the destination type.
+        // The value is set to the closest limit of the type.
+        PE_RANGE,
+    };
+
+    struct ParseResult
+    {
+        // One past the last character that was consumed.
+        const char* end;
+        ParseError  error;
+
+        bool ok() const
+        {
+            return error == PE_NONE;
+        }
+    };
+
+    /**
+     * \brief Parses numbers out of [first, last) without allocating and
+     * without needing a null terminator.
+     *
+     * The accepted syntax matches std::from_chars: an optional '-' for
+     * signed and real types, no leading white space and no '+'. Reals
+     * accept a fraction, an exponent, inf, infinity and nan. On PE_INVALID
+     * the value is left unchanged and end is first.
+     *
+     * Base ten integers are read eight digits at a time. Reals use the
+     * Clinger fast path, then the Eisel-Lemire algorithm; the rare inputs
+     * that it cannot round correctly fall back to strtod.
+     */
+    class NumberParse
+    {
+    public:
+        static ParseResult integer(const char* first, const char* last, U64& value, int base = 10);
+
+        static ParseResult integer(const char* first, const char* last, I64& value, int base = 10);
+
+        static ParseResult real(const char* first, const char* last, double& value);
+
+        static ParseResult real(const char* first, const char* last, float& value);
+    };
+
+}  // namespace Rt2
@@ -20,26 +20,204 @@
 -------------------------------------------------------------------------------
 */
 #pragma once
+#include <mutex>
+#include <new>
+#include <utility>
 #include "Utils/Array.h"
 
 namespace Rt2
 {
+    namespace Detail
+    {
+        /**
+         * \brief Storage shared by the object pools.
+         *
+         * Objects are carved from slabs of Expansion slots. A free slot
+         * stores the link to the next free slot, so the free list
+         * costs no memory beyond the slots themselves.
+         */
+        template <typename T, int Expansion>
+        class PoolSlabs
+        {
+        public:
+            union Slot
+            {
+                Slot* next;
+                alignas(T) unsigned char storage[sizeof(T)];
+            };
+
+            using SizeType = U32;
+
+        private:
+            struct Slab
+            {
+                Slab* next{nullptr};
+                Slot  slots[Expansion];
+            };
+
+            Slab*    _slabs{nullptr};
+            Slot*    _free{nullptr};
+            SizeType _capacity{0};
+
+        public:
+            PoolSlabs()
+            {
+                static_assert(Expansion >= 0x01 && Expansion < 0x1000);
+            }
+
+            ~PoolSlabs()
+            {
+                release();
+            }
+
+            PoolSlabs(const PoolSlabs&) = delete;
+
+            /**
+             * \brief Releases every slab at once.
+             */
+            void release()
+            {
+                while (_slabs)
+                {
+                    Slab* next = _slabs->next;
+                    delete _slabs;
+                    _slabs = next;
+                }
+                _free     = nullptr;
+                _capacity = 0;
+            }
+
+            void grow()
+            {
+                Slab* slab = new Slab;
+                slab->next = _slabs;
+                _slabs     = slab;
+
+                // Link in reverse so that allocation
+                // walks the slab front to back.
+                for (int i = Expansion - 1; i >= 0; --i)
+                    push(&slab->slots[i]);
+
+                _capacity += Expansion;
+            }
+
+            Slot* pop()
+            {
+                if (!_free)
+                    grow();
+
+                Slot* slot = _free;
+                _free      = slot->next;
+                return slot;
+            }
+
+            void push(Slot* slot)
+            {
+                slot->next = _free;
+                _free      = slot;
+            }
+
+            SizeType capacity() const
+            {
+                return _capacity;
+            }
+        };
 
+        /**
+         * \brief Maps the ids of live shared pools to the pools.
+         *
+         * A thread that drops a magazine, or exits, hands its slots back
+         * through here. Slots of a pool that is gone are ignored.
+         */
+        class PoolRegistry
+        {
+        public:
+            using Reclaim = void (*)(void* pool, void* slots);
+
+        private:
+            struct Entry
+            {
+                U64     id;
+                void*   pool;
+                Reclaim reclaim;
+            };
+
+            static std::mutex& lock()
+            {
+                static std::mutex mutex;
+                return mutex;
+            }
+
+            static SimpleArray<Entry>& entries()
+            {
+                static SimpleArray<Entry> table;
+                return table;
+            }
+
+        public:
+            static U64 add(void* pool, const Reclaim reclaim)
+            {
+                static U64 ids = 0;
+
+                std::lock_guard guard(lock());
+                entries().push_back({++ids, pool, reclaim});
+                return ids;
+            }
+
+            static void remove(const U64 id)
+            {
+                std::lock_guard     guard(lock());
+                SimpleArray<Entry>& table = entries();
+                for (U32 i = 0; i < table.size(); ++i)
+                {
+                    if (table[i].id == id)
+                    {
+                        table[i] = table.back();
+                        table.pop_back();
+                        return;
+                    }
+                }
+            }
+
+            static void reclaim(const U64 id, void* slots)
+            {
+                std::lock_guard guard(lock());
+                for (const Entry& entry : entries())
+                {
+                    if (entry.id == id)
+                    {
+                        entry.reclaim(entry.pool, slots);
+                        return;
+                    }
+                }
+            }
+        };
+    }  // namespace Detail
+
+    /**
+     * \brief Pool of objects carved from contiguous slabs.
+     *
+     * Construction is deferred to allocate and free runs the destructor.
+     * clear releases whole slabs and does not destroy objects that are
+     * still allocated. Pointers must be freed by the pool that allocated them.
+     * Opt is kept for source compatibility, the slabs do not use it.
+     */
     template <typename T, int Expansion = 0x40, int Opt = AOP_SIMPLE_TYPE>
     class ObjectPool
     {
     public:
         using PointerType = T*;
-        using Pool        = Array<PointerType, Opt>;
-        using SizeType    = typename Pool::SizeType;
+        using Slabs       = Detail::PoolSlabs<T, Expansion>;
+        using Slot        = typename Slabs::Slot;
+        using SizeType    = typename Slabs::SizeType;
 
     private:
-        Pool _pool;
+        Slabs    _slabs;
+        SizeType _used{0};
 
     public:
         ObjectPool()
         {
-            static_assert(Expansion >= 0x01 && Expansion < 0x1000);
             reserve(Expansion);
         }
 
@@ -48,64 +226,235 @@ namespace Rt2
             clear();
         }
 
+        ObjectPool(const ObjectPool&) = delete;
+
         void clear()
         {
-            for (const auto el : _pool)
-                delete el;
-
-            if (Opt & AOP_SIMPLE_TYPE)
-                _pool.resizeFast(0);
-            else
-                _pool.clear();
+            _slabs.release();
+            _used = 0;
         }
 
         void reserve(const SizeType& space)
         {
-            if (_pool.size() < space)
-                _pool.reserve(space);
-
-            SizeType st = _pool.size();
-            for (SizeType i = st; i < capacity(); ++i)
-                _pool.push_back(new T());
+            while (_slabs.capacity() < space)
+                _slabs.grow();
         }
 
+        /**
+         * \return The number of objects the slabs can hold.
+         */
         SizeType capacity() const
         {
-            return _pool.capacity() - 1;
+            return _slabs.capacity();
         }
 
-        PointerType allocate()
+        /**
+         * \return The number of objects that are currently allocated.
+         */
+        SizeType used() const
         {
-            if (!_pool.empty())
-            {
-                const PointerType val = _pool.back();
-                _pool.pop_back();
-                return val;
-            }
-            reserve(Expansion);
-            return allocate();
+            return _used;
+        }
+
+        template <typename... Args>
+        PointerType allocate(Args&&... args)
+        {
+            Slot* slot = _slabs.pop();
+            ++_used;
+            return new (slot->storage) T(std::forward<Args>(args)...);
         }
 
         void free(PointerType ptr)
         {
             if (ptr)
             {
-                if (_pool.size() + 1 > _pool.capacity() - 1)
-                    _pool.reserve(_pool.size() + Expansion);
-                _pool.push_back(new (ptr) T());
+                ptr->~T();
+                _slabs.push((Slot*)ptr);
+                --_used;
             }
         }
 
         void freeFast(PointerType ptr)
         {
-            // Use when object reinitialization is unimportant / undesired
-            // because of caching. (see Array::resizeFast)
-            if (ptr)
+            // Objects are no longer reinitialized on free,
+            // so this is the same as free.
+            free(ptr);
+        }
+    };
+
+    /**
+     * \brief Thread safe ObjectPool.
+     *
+     * Each thread keeps a small magazine of free slots per pool, so most
+     * calls to allocate and free do not take the lock. An object may be
+     * freed by a different thread than the one that allocated it; the slot
+     * goes to the freeing thread's magazine.
+     *
+     * A magazine goes back to the slabs when its thread exits or needs
+     * the entry for another pool. clear must not run concurrently
+     * with other calls.
+     */
+    template <typename T, int Expansion = 0x40, U32 MagazineSize = 0x20>
+    class SharedObjectPool
+    {
+    public:
+        using PointerType = T*;
+        using Slabs       = Detail::PoolSlabs<T, Expansion>;
+        using Slot        = typename Slabs::Slot;
+        using SizeType    = typename Slabs::SizeType;
+
+    private:
+        struct Magazine
+        {
+            U64   pool{0};
+            Slot* head{nullptr};
+            U32   count{0};
+        };
+
+        struct Magazines
+        {
+            SimpleArray<Magazine> list;
+
+            ~Magazines()
+            {
+                for (const Magazine& mag : list)
+                    drop(mag);
+            }
+        };
+
+        static constexpr U32 MaxMagazines = 0x10;
+
+        Slabs      _slabs;
+        std::mutex _lock;
+        U64        _id;
+
+        static void drop(const Magazine& mag)
+        {
+            if (mag.head)
+                Detail::PoolRegistry::reclaim(mag.pool, mag.head);
+        }
+
+        static void reclaim(void* pool, void* slots)
+        {
+            SharedObjectPool* self = (SharedObjectPool*)pool;
+            std::lock_guard   lock(self->_lock);
+
+            Slot* slot = (Slot*)slots;
+            while (slot)
             {
-                if (_pool.size() + 1 > _pool.capacity() - 1)
-                    _pool.reserve(_pool.size() + Expansion);
-                _pool.push_back(ptr);
+                Slot* next = slot->next;
+                self->_slabs.push(slot);
+                slot = next;
             }
         }
+
+    public:
+        SharedObjectPool() :
+            _id(Detail::PoolRegistry::add(this, &reclaim))
+        {
+            static_assert(MagazineSize >= 2);
+        }
+
+        ~SharedObjectPool()
+        {
+            Detail::PoolRegistry::remove(_id);
+        }
+
+        SharedObjectPool(const SharedObjectPool&) = delete;
+
+        void clear()
+        {
+            // Magazines filled under the old id
+            // are ignored from here on.
+            Detail::PoolRegistry::remove(_id);
+            {
+                std::lock_guard lock(_lock);
+                _slabs.release();
+            }
+            _id = Detail::PoolRegistry::add(this, &reclaim);
+        }
+
+        SizeType capacity()
+        {
+            std::lock_guard lock(_lock);
+            return _slabs.capacity();
+        }
+
+        template <typename... Args>
+        PointerType allocate(Args&&... args)
+        {
+            Magazine& mag = magazine();
+            if (mag.count == 0)
+            {
+                std::lock_guard lock(_lock);
+                while (mag.count < MagazineSize / 2)
+                {
+                    Slot* slot = _slabs.pop();
+                    slot->next = mag.head;
+                    mag.head   = slot;
+                    ++mag.count;
+                }
+            }
+
+            Slot* slot = mag.head;
+            mag.head   = slot->next;
+            --mag.count;
+            return new (slot->storage) T(std::forward<Args>(args)...);
+        }
+
+        void free(PointerType ptr)
+        {
+            if (!ptr)
+                return;
+
+            ptr->~T();
+
+            Magazine& mag  = magazine();
+            Slot*     slot = (Slot*)ptr;
+            slot->next     = mag.head;
+            mag.head       = slot;
+            ++mag.count;
+
+            if (mag.count >= MagazineSize)
+            {
+                // Hand half back so other threads can use it.
+                std::lock_guard lock(_lock);
+                while (mag.count > MagazineSize / 2)
+                {
+                    slot     = mag.head;
+                    mag.head = slot->next;
+                    --mag.count;
+                    _slabs.push(slot);
+                }
+            }
+        }
+
+    private:
+        Magazine& magazine()
+        {
+            // Keyed by pool id, a thread rarely
+            // works with more than a few pools.
+            thread_local Magazines magazines;
+
+            const U64 id = _id;
+            for (Magazine& mag : magazines.list)
+            {
+                if (mag.pool == id)
+                    return mag;
+            }
+
+            // Past the limit entries are recycled in place,
+            // after their slots go back to their pool.
+            if (magazines.list.size() >= MaxMagazines)
+            {
+                Magazine& mag = magazines.list[(U32)(id % MaxMagazines)];
+                drop(mag);
+                mag = {id, nullptr, 0};
+                return mag;
+            }
+
+            magazines.list.push_back({id, nullptr, 0});
+            return magazines.list.back();
+        }
     };
 }  // namespace Rt2
@@ -57,13 +57,26 @@ namespace Rt2
             _buf.push_back(ch);
         }
 
-        void push(const String& str)
+        void push(const StringView& str)
         {
             _dirty = true;
             for (const auto& ch : str)
                 _buf.push_back(ch);
         }
 
+        /**
+         * \brief Returns a view of the live buffer.
+         * The view is invalidated by the next push or clear.
+         */
+        StringView view() const
+        {
+            return {_buf.data(), _buf.size()};
+        }
+
+        /**
+         * \brief Returns a copy of the buffer that is cached until
+         * the next modification. Prefer view, which does not allocate.
+         */
         const String& value() const
         {
             if (_dirty)
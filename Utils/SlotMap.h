@@ -0,0 +1,245 @@
+/*
+-------------------------------------------------------------------------------
+    Copyright (c) Charles Carley.
+
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+-------------------------------------------------------------------------------
+*/
+#pragma once
+
+#include <utility>
+#include "Utils/Array.h"
+#include "Utils/Definitions.h"
+#include "Utils/Exception.h"
+
+namespace Rt2
+{
+    /**
+     * \brief Stable reference to an element of a SlotMap.
+     *
+     * The generation is bumped every time a slot is released, so a handle
+     * to an erased element no longer matches and lookups fail instead of
+     * returning the element that reused the slot.
+     */
+    struct SlotHandle
+    {
+        U32 index{Npos32};
+        U32 generation{0};
+
+        bool valid() const { return generation != 0; }
+
+        bool operator==(const SlotHandle& rhs) const
+        {
+            return index == rhs.index && generation == rhs.generation;
+        }
+
+        bool operator!=(const SlotHandle& rhs) const
+        {
+            return !(*this == rhs);
+        }
+    };
+
+    /**
+     * \brief Container with O(1) insert, erase and lookup by handle.
+     *
+     * Elements are kept densely packed for iteration. Erasing moves the last
+     * element into the hole, and a slot table maps each handle to the
+     * current position of its element.
+     */
+    template <typename T,
+              int Options        = AOP_DEFAULT_TYPE,
+              typename Allocator = Allocator<T, uint32_t>>
+    class SlotMap
+    {
+    public:
+        using Dense            = Array<T, Options, Allocator>;
+        using SizeType         = typename Dense::SizeType;
+        using PointerType      = typename Dense::PointerType;
+        using ConstPointerType = typename Dense::ConstPointerType;
+
+    private:
+        struct Slot
+        {
+            // The dense index while in use,
+            // the next free slot while released.
+            U32 index{Npos32};
+            U32 generation{1};
+        };
+
+        using Slots  = SimpleArray<Slot>;
+        using Owners = SimpleArray<U32>;
+
+        Dense  _dense;
+        Owners _owners;
+        Slots  _slots;
+        U32    _free{Npos32};
+
+    public:
+        SlotMap() = default;
+
+        ~SlotMap() = default;
+
+        SlotMap(const SlotMap&) = delete;
+
+        void clear()
+        {
+            // Handles stay unique across a clear, so
+            // released slots are kept and only bumped.
+            for (const U32 owner : _owners)
+                release(owner);
+
+            _dense.clear();
+            _owners.resizeFast(0);
+        }
+
+        void reserve(const SizeType& space)
+        {
+            _dense.reserve(space);
+            _owners.reserve(space);
+            _slots.reserve(space);
+        }
+
+        SlotHandle insert(const T& value)
+        {
+            const U32 idx = acquire();
+            _slots[idx].index = _dense.size();
+
+            _dense.push_back(value);
+            _owners.push_back(idx);
+            return {idx, _slots[idx].generation};
+        }
+
+        template <typename... Args>
+        SlotHandle emplace(Args&&... args)
+        {
+            return insert(T(std::forward<Args>(args)...));
+        }
+
+        bool erase(const SlotHandle& handle)
+        {
+            if (!contains(handle))
+                return false;
+
+            const U32 pos  = _slots[handle.index].index;
+            const U32 last = _dense.size() - 1;
+            if (pos != last)
+            {
+                _dense[pos]                = std::move(_dense[last]);
+                _owners[pos]               = _owners[last];
+                _slots[_owners[pos]].index = pos;
+            }
+
+            // The storage stays constructed, so reset the
+            // element rather than destroying it.
+            _dense[last] = T{};
+            _dense.resizeFast(last);
+            _owners.resizeFast(last);
+
+            release(handle.index);
+            return true;
+        }
+
+        bool contains(const SlotHandle& handle) const
+        {
+            return handle.index < _slots.size() &&
+                   _slots[handle.index].generation == handle.generation;
+        }
+
+        T* get(const SlotHandle& handle)
+        {
+            if (contains(handle))
+                return &_dense[_slots[handle.index].index];
+            return nullptr;
+        }
+
+        const T* get(const SlotHandle& handle) const
+        {
+            if (contains(handle))
+                return &_dense[_slots[handle.index].index];
+            return nullptr;
+        }
+
+        T& at(const SlotHandle& handle)
+        {
+            if (T* value = get(handle))
+                return *value;
+            throw Exception("invalid or stale slot handle");
+        }
+
+        const T& at(const SlotHandle& handle) const
+        {
+            if (const T* value = get(handle))
+                return *value;
+            throw Exception("invalid or stale slot handle");
+        }
+
+        /**
+         * \return The handle of the element at the dense position pos.
+         */
+        SlotHandle handleAt(const SizeType& pos) const
+        {
+            if (pos >= _dense.size())
+                throw Exception("array index out of bounds");
+
+            const U32 idx = _owners[pos];
+            return {idx, _slots[idx].generation};
+        }
+
+        PointerType begin() { return _dense.begin(); }
+
+        PointerType end() { return _dense.end(); }
+
+        ConstPointerType begin() const { return _dense.begin(); }
+
+        ConstPointerType end() const { return _dense.end(); }
+
+        SizeType size() const { return _dense.size(); }
+
+        bool empty() const { return _dense.empty(); }
+
+    private:
+        U32 acquire()
+        {
+            if (_free != Npos32)
+            {
+                const U32 idx = _free;
+                _free         = _slots[idx].index;
+                return idx;
+            }
+
+            if (_slots.size() >= Npos32 - 1)
+                throw Exception("slot map limit exceeded");
+
+            _slots.push_back({});
+            return _slots.size() - 1;
+        }
+
+        void release(const U32 idx)
+        {
+            Slot& slot = _slots[idx];
+
+            // Zero is never a live generation, so a
+            // default constructed handle is never valid.
+            if (++slot.generation == 0)
+                slot.generation = 1;
+
+            slot.index = _free;
+            _free      = idx;
+        }
+    };
+
+}  // namespace Rt2
@@ -0,0 +1,260 @@
+/*
+-------------------------------------------------------------------------------
+    Copyright (c) Charles Carley.
+
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+-------------------------------------------------------------------------------
+*/
+#pragma once
+
+#include <iterator>
+#include <string_view>
+#include <type_traits>
+#include "Utils/Definitions.h"
+#include "Utils/StringScan.h"
+
+namespace Rt2
+{
+    /**
+     * \brief Separator policies for SplitView.
+     *
+     * find returns the first separator in [first, last) as the pair of
+     * pointers that bound it, or last twice when there is none.
+     */
+    struct CharSeparator
+    {
+        char ch;
+
+        void find(const char* first, const char* last, const char*& from, const char*& to) const
+        {
+            from = StringScan::find(first, last, ch);
+            to   = from == last ? last : from + 1;
+        }
+    };
+
+    struct StringSeparator
+    {
+        std::string_view separator;
+
+        void find(const char* first, const char* last, const char*& from, const char*& to) const
+        {
+            // an empty separator never matches, so the input stays whole
+            if (separator.empty())
+                from = last;
+            else
+                from = StringScan::find(first, last, separator.data(), separator.size());
+            to = from == last ? last : from + separator.size();
+        }
+    };
+
+    template <typename Predicate>
+    struct PredicateSeparator
+    {
+        Predicate predicate;
+
+        void find(const char* first, const char* last, const char*& from, const char*& to) const
+        {
+            while (first < last && !predicate(*first))
+                ++first;
+            from = first;
+            to   = from == last ? last : from + 1;
+        }
+    };
+
+    /**
+     * \brief A forward range over the pieces of a string between separators.
+     *
+     * Pieces are found one at a time as the range is iterated and are
+     * views into the input, so nothing is allocated. The input and a
+     * string separator must outlive the range.
+     *
+     * Without skipEmpty the pieces are the same as the ones
+     * StringUtils::split returns: empty pieces are kept, apart from a
+     * trailing one. After maxSplits pieces, the rest of the input is
+     * returned as the final piece.
+     */
+    template <typename Separator>
+    class SplitView
+    {
+    private:
+        const char* _first{nullptr};
+        const char* _last{nullptr};
+        Separator   _separator;
+        size_t      _maxSplits{Npos};
+        bool        _skipEmpty{false};
+
+    public:
+        class Iterator
+        {
+        private:
+            const SplitView* _view{nullptr};
+            const char*      _next{nullptr};
+            std::string_view _piece;
+            size_t           _count{0};
+
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type        = std::string_view;
+            using difference_type   = std::ptrdiff_t;
+            using pointer           = const std::string_view*;
+            using reference         = const std::string_view&;
+
+            Iterator() = default;
+
+            explicit Iterator(const SplitView* view) :
+                _view(view),
+                _next(view->_first)
+            {
+                advance();
+            }
+
+            reference operator*() const
+            {
+                return _piece;
+            }
+
+            pointer operator->() const
+            {
+                return &_piece;
+            }
+
+            Iterator& operator++()
+            {
+                advance();
+                return *this;
+            }
+
+            Iterator operator++(int)
+            {
+                Iterator copy = *this;
+                advance();
+                return copy;
+            }
+
+            bool operator==(const Iterator& rhs) const
+            {
+                return _view == rhs._view && _next == rhs._next && _count == rhs._count;
+            }
+
+            bool operator!=(const Iterator& rhs) const
+            {
+                return !(*this == rhs);
+            }
+
+        private:
+            void advance();
+
+            void finish()
+            {
+                _view  = nullptr;
+                _next  = nullptr;
+                _piece = {};
+                _count = 0;
+            }
+        };
+
+        SplitView() = default;
+
+        SplitView(const std::string_view& input,
+                  const Separator&        separator,
+                  const bool              skipEmpty,
+                  const size_t            maxSplits) :
+            _first(input.data()),
+            _last(input.data() + input.size()),
+            _separator(separator),
+            _maxSplits(maxSplits),
+            _skipEmpty(skipEmpty)
+        {
+        }
+
+        Iterator begin() const
+        {
+            return Iterator(this);
+        }
+
+        Iterator end() const
+        {
+            return Iterator();
+        }
+
+        bool empty() const
+        {
+            return begin() == end();
+        }
+
+        /**
+         * \brief Appends every piece to a container of strings or views.
+         */
+        template <typename Container>
+        void copyTo(Container& dest) const
+        {
+            for (const std::string_view& piece : *this)
+                dest.emplace_back(piece);
+        }
+    };
+
+    template <typename Separator>
+    void SplitView<Separator>::Iterator::advance()
+    {
+        const char* last = _view ? _view->_last : nullptr;
+        while (_next)
+        {
+            const char* from;
+            const char* to;
+
+            if (_count == _view->_maxSplits)
+            {
+                // whatever is left is the final piece
+                if (_view->_skipEmpty)
+                {
+                    _view->_separator.find(_next, last, from, to);
+                    while (from == _next && from != last)
+                    {
+                        _next = to;
+                        _view->_separator.find(_next, last, from, to);
+                    }
+                }
+                from = to = last;
+            }
+            else
+                _view->_separator.find(_next, last, from, to);
+
+            if (from == last)
+            {
+                if (_next == last)
+                    break;
+
+                _piece = {_next, size_t(last - _next)};
+                _next  = last;
+                ++_count;
+                return;
+            }
+
+            const char* start = _next;
+
+            _next = to;
+            if (_view->_skipEmpty && from == start)
+                continue;
+
+            _piece = {start, size_t(from - start)};
+            ++_count;
+            return;
+        }
+        finish();
+    }
+
+}  // namespace Rt2
@@ -20,9 +20,15 @@
 -------------------------------------------------------------------------------
 */
 #include "Utils/String.h"
+#include <cstdio>
+#include <cstring>
 #include "Utils/Array.h"
 #include "Utils/Char.h"
 #include "Utils/Definitions.h"
+#include "Utils/MultiMatcher.h"
+#include "Utils/NumberFormat.h"
+#include "Utils/StringScan.h"
+#include "Utils/StringTable.h"
 #include "Utils/Time.h"
 
 namespace Rt2
@@ -32,42 +38,61 @@ namespace Rt2
                                  const String& a,
                                  const String& b)
     {
+        if (&dest != &input)
+            dest = input;
         if (a.empty())
+            return;
+
+        if (a.size() == b.size())
         {
-            dest = input;
+            replaceAll(dest, a, b);
             return;
         }
 
-        OutputStringStream oss;
-        for (size_t i = 0; i < input.size(); ++i)
+        String result;
+        result.reserve(dest.size());
+
+        const char* first = dest.data();
+        const char* last  = first + dest.size();
+        while (first < last)
         {
-            if (const char ch = input[i]; ch != a[0])
-                oss << ch;
-            else
-            {
-                bool match = true;
-                for (size_t j = 1; j < a.size() && match; ++j)
-                {
-                    if (i + j > input.size())
-                        match = false;
-                    else
-                    {
-                        const char aCh = input[i + j];
-                        const char bCh = a[j];
-
-                        match = aCh == bCh;
-                    }
-                }
-                if (match)
-                {
-                    oss << b;
-                    if (a.size() > 1) i += a.size() - 1;
-                }
-                else
-                    oss << ch;
-            }
+            const char* found = StringScan::find(first, last, a.data(), a.size());
+            result.append(first, found);
+            if (found == last)
+                break;
+
+            result.append(b);
+            first = found + a.size();
+        }
+        dest.swap(result);
+    }
+
+    void StringUtils::replaceAll(String&       inOut,
+                                 const String& a,
+                                 const String& b)
+    {
+        if (a.empty())
+            return;
+
+        if (a.size() != b.size())
+        {
+            replaceAll(inOut, inOut, a, b);
+            return;
+        }
+
+        // Nothing moves, so the matches are overwritten in a single pass.
+        char*       first = inOut.data();
+        const char* last  = first + inOut.size();
+        while (first < last)
+        {
+            const char* found = StringScan::find(first, last, a.data(), a.size());
+            if (found == last)
+                break;
+
+            char* at = first + (found - first);
+            memcpy(at, b.data(), b.size());
+            first = at + b.size();
         }
-        dest = oss.str();
     }
 
     void StringUtils::reverse(String& dest, const String& input)
@@ -88,18 +113,16 @@ namespace Rt2
 
     void StringUtils::toLower(String& dest, const String& in)
     {
-        OutputStringStream oss;
-        for (const char& value : in)
-            oss << (char)std::tolower(value);
-        dest = oss.str();
+        if (&dest != &in)
+            dest.resize(in.size());
+        StringScan::toLower(dest.data(), in.data(), in.data() + in.size());
     }
 
     void StringUtils::toUpper(String& dest, const String& in)
     {
-        OutputStringStream oss;
-        for (const char& value : in)
-            oss << (char)std::toupper(value);
-        dest = oss.str();
+        if (&dest != &in)
+            dest.resize(in.size());
+        StringScan::toUpper(dest.data(), in.data(), in.data() + in.size());
     }
 
     String StringUtils::toLowerFirst(const String& in)
@@ -255,30 +278,174 @@ namespace Rt2
 
     String StringUtils::csv(const StringArray& sa)
     {
-        OutputStringStream oss;
+        if (sa.empty())
+            return {};
+
+        size_t total = sa.size() - 1;
+        for (const String& str : sa)
+            total += str.size();
+
+        String dest;
+        dest.reserve(total);
         for (size_t i = 0; i < sa.size(); ++i)
         {
-            oss << sa[i];
-            if (i + 1 < sa.size())
-                oss << ',';
+            if (i > 0)
+                dest.push_back(',');
+            dest.append(sa[i]);
         }
-        return oss.str();
+        return dest;
+    }
+
+    void StringUtils::append(String&           dest,
+                             const ConcatArg*  args,
+                             const size_t      count,
+                             const StringView& prefix)
+    {
+        const char* first = dest.data();
+        const char* last  = first + dest.size();
+        const auto  alias = [first, last](const char* ptr)
+        {
+            return ptr >= first && ptr < last;
+        };
+
+        size_t total   = dest.size() + count * prefix.size();
+        bool   aliased = alias(prefix.data());
+        for (size_t i = 0; i < count; ++i)
+        {
+            total += args[i].size();
+            aliased = aliased || alias(args[i].data());
+        }
+
+        // Growing dest would free the characters that
+        // aliased arguments point to, so build a copy.
+        if (aliased)
+        {
+            String copy;
+            copy.reserve(total);
+            copy.append(dest);
+            for (size_t i = 0; i < count; ++i)
+            {
+                copy.append(prefix);
+                copy.append(args[i].data(), args[i].size());
+            }
+            dest = std::move(copy);
+            return;
+        }
+
+        if (total > dest.capacity())
+            dest.reserve(total);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            dest.append(prefix);
+            dest.append(args[i].data(), args[i].size());
+        }
+    }
+
+    ConcatArg::ConcatArg(const char v) :
+        _size(1)
+    {
+        _buffer[0] = v;
+    }
+
+    ConcatArg::ConcatArg(const signed char v) :
+        ConcatArg((char)v)
+    {
+    }
+
+    ConcatArg::ConcatArg(const unsigned char v) :
+        ConcatArg((char)v)
+    {
+    }
+
+    ConcatArg::ConcatArg(const short v) :
+        _size(Char::format(_buffer, sizeof _buffer, (int16_t)v))
+    {
+    }
+
+    ConcatArg::ConcatArg(const unsigned short v) :
+        _size(Char::format(_buffer, sizeof _buffer, (uint16_t)v))
+    {
+    }
+
+    ConcatArg::ConcatArg(const int v) :
+        _size(Char::format(_buffer, sizeof _buffer, (int32_t)v))
+    {
+    }
+
+    ConcatArg::ConcatArg(const unsigned int v) :
+        _size(Char::format(_buffer, sizeof _buffer, (uint32_t)v))
+    {
+    }
+
+    ConcatArg::ConcatArg(const long v) :
+        _size(Char::format(_buffer, sizeof _buffer, (int64_t)v))
+    {
+    }
+
+    ConcatArg::ConcatArg(const unsigned long v) :
+        _size(Char::format(_buffer, sizeof _buffer, (uint64_t)v))
+    {
+    }
+
+    ConcatArg::ConcatArg(const long long v) :
+        _size(Char::format(_buffer, sizeof _buffer, (int64_t)v))
+    {
+    }
+
+    ConcatArg::ConcatArg(const unsigned long long v) :
+        _size(Char::format(_buffer, sizeof _buffer, (uint64_t)v))
+    {
+    }
+
+    ConcatArg::ConcatArg(const float v) :
+        ConcatArg((double)v)
+    {
     }
 
+    ConcatArg::ConcatArg(const double v)
+    {
+        // Matches the default precision and notation of an OStream,
+        // which writes with the classic locale.
+        const int written = snprintf(_buffer, sizeof _buffer, "%g", v);
+        if (written > 0)
+            _size = NumberFormat::classicPoint(_buffer, Min<U32>(U32(written), sizeof _buffer - 1));
+    }
+
+    namespace
+    {
+        // \r, \n and swap are all treated as line endings, and each pair of
+        // them becomes one \r\n. It is the same as swapping \r and \n for
+        // swap, then replacing swap pairs and finally single swaps.
+        MultiMatcher lineEndings(const char swap)
+        {
+            const char endings[] = {'\r', '\n', swap};
+
+            MultiMatcher matcher;
+            for (const char a : endings)
+            {
+                for (const char b : endings)
+                    matcher.add(String{a, b}, "\r\n");
+            }
+            for (const char a : endings)
+                matcher.add(String{a}, "\r\n");
+
+            matcher.compile();
+            return matcher;
+        }
+    }  // namespace
+
     void StringUtils::splitLine(StringArray&  dest,
                                 const String& input,
                                 const char    swap)
     {
-        String swap1, swap2;
-        swap1.push_back(swap);
-        swap2.push_back(swap);
-        swap2.push_back(swap);
+        static const MultiMatcher dollar = lineEndings('$');
 
-        String temp = input;
-        replaceAll(temp, temp, "\r", swap1);
-        replaceAll(temp, temp, "\n", swap1);
-        replaceAll(temp, temp, swap2, "\r\n");
-        replaceAll(temp, temp, swap1, "\r\n");
+        String temp;
+        if (swap == '$')
+            dollar.replaceAll(temp, input);
+        else
+            lineEndings(swap).replaceAll(temp, input);
         split(dest, temp, "\r\n");
     }
 
@@ -361,17 +528,20 @@ namespace Rt2
                 const String& input,
                 const String& separator)
     {
-        String t0  = input;
-        size_t pos = t0.find(separator);
-        while (pos != String::npos)
+        const char* first = input.data();
+        const char* last  = first + input.size();
+        while (first < last && !separator.empty())
         {
-            destination.push_back(t0.substr(0, pos));
-            t0  = t0.substr(pos + separator.size(), t0.size());
-            pos = t0.find(separator);
+            const char* found = StringScan::find(first, last, separator.data(), separator.size());
+            if (found == last)
+                break;
+
+            destination.emplace_back(first, found);
+            first = found + separator.size();
         }
 
-        if (!t0.empty())
-            destination.push_back(t0);
+        if (first < last)
+            destination.emplace_back(first, last);
     }
 
     template <typename Container>
@@ -379,26 +549,26 @@ namespace Rt2
                       const String& input,
                       const String& separator)
     {
-        String t0 = input;
-
-        size_t pos = t0.find(separator);
-        while (pos != String::npos)
+        const auto push = [&destination](const char* first, const char* last)
         {
-            String t1 = t0.substr(0, pos);
-            Su::trimWs(t1, t1);
-            if (!t1.empty())
-                destination.push_back(t1);
-
-            t0  = t0.substr(pos + separator.size(), t0.size());
-            pos = t0.find(separator);
-        }
-
-        if (!t0.empty())
+            last  = StringScan::skipWsReverse(first, last);
+            first = StringScan::skipWs(first, last);
+            if (first < last)
+                destination.emplace_back(first, last);
+        };
+
+        const char* first = input.data();
+        const char* last  = first + input.size();
+        while (first < last && !separator.empty())
         {
-            Su::trimWs(t0, t0);
-            if (!t0.empty())
-                destination.push_back(t0);
+            const char* found = StringScan::find(first, last, separator.data(), separator.size());
+            if (found == last)
+                break;
+
+            push(first, found);
+            first = found + separator.size();
         }
+        push(first, last);
     }
 
     void StringUtils::splitRejectEmpty(
@@ -421,6 +591,37 @@ namespace Rt2
         splitRejectT<StringDeque>(destination, input, sep);
     }
 
+    void StringUtils::split(
+        StringTable&  destination,
+        const String& input,
+        const char    separator)
+    {
+        String sep;
+        sep.push_back(separator);
+        split(destination, input, sep);
+    }
+
+    void StringUtils::split(
+        StringTable&  destination,
+        const String& input,
+        const String& separator)
+    {
+        // The pieces never add up to more than the input.
+        destination.reserve(destination.size(), destination.bytes() + input.size());
+        splitT<StringTable>(destination, input, separator);
+    }
+
+    void StringUtils::splitRejectEmpty(
+        StringTable&  destination,
+        const String& input,
+        const char    separator)
+    {
+        String sep;
+        sep.push_back(separator);
+        destination.reserve(destination.size(), destination.bytes() + input.size());
+        splitRejectT<StringTable>(destination, input, sep);
+    }
+
     void StringUtils::split(
         StringArray&  destination,
         const String& input,
@@ -437,6 +638,24 @@ namespace Rt2
         splitT<StringDeque>(destination, input, separator);
     }
 
+    SplitView<CharSeparator> StringUtils::splitView(
+        const StringView& input,
+        const char        separator,
+        const bool        skipEmpty,
+        const size_t      maxSplits)
+    {
+        return {input, CharSeparator{separator}, skipEmpty, maxSplits};
+    }
+
+    SplitView<StringSeparator> StringUtils::splitView(
+        const StringView& input,
+        const StringView& separator,
+        const bool        skipEmpty,
+        const size_t      maxSplits)
+    {
+        return {input, StringSeparator{separator}, skipEmpty, maxSplits};
+    }
+
     void StringUtils::trim(
         String&       destination,
         const String& input,
@@ -450,22 +669,67 @@ namespace Rt2
         const String& input,
         const char    replacement)
     {
-        OutputStringStream dest;
-        StringArray        src;
-        scanSplitLine(src, input);
+        String dest;
+        dest.reserve(input.size());
 
-        for (const auto& line : src)
-        {
-            String d1, d2;
-            trim(d1, line, '\n');
-            trim(d2, d1, '\r');
-            trim(d2, d2, ' ');
+        // The lines are written straight into dest. Line marks where the
+        // current one starts, and open is set once it has any content.
+        size_t line = 0;
+        bool   open = false;
 
+        const auto endLine = [&dest, &line, &open, replacement]
+        {
+            while (dest.size() > line && dest.back() == ' ')
+                dest.pop_back();
             if (replacement != 0)
-                d2.push_back(replacement);
-            dest << d2;
+                dest.push_back(replacement);
+            line = dest.size();
+            open = false;
+        };
+
+        const char* first = input.data();
+        const char* last  = first + input.size();
+        while (first < last)
+        {
+            const char* ctl = StringScan::findControl(first, last);
+            if (first < ctl)
+            {
+                open = true;
+                if (dest.size() == line)
+                {
+                    while (first < ctl && *first == ' ')
+                        ++first;
+                }
+                dest.append(first, ctl);
+            }
+
+            if (ctl == last)
+                break;
+
+            switch (*ctl)
+            {
+            case '\r':
+                if (ctl + 1 < last && ctl[1] == '\n')
+                    ++ctl;
+                endLine();
+                break;
+            case '\n':
+                endLine();
+                break;
+            case '\t':
+                dest.push_back('\t');
+                open = true;
+                break;
+            default:
+                // any other control or non ascii byte is dropped
+                break;
+            }
+            first = ctl + 1;
         }
-        return dest.str();
+
+        if (open)
+            endLine();
+        return dest;
     }
 
     bool StringUtils::filter(
@@ -474,20 +738,36 @@ namespace Rt2
         const FilterFunction& pass,
         const size_t          max)
     {
-        if (!pass) return false;
-        if (input.empty()) return false;
-
-        if (!destination.empty())
-            destination.clear();
-        destination.reserve(input.size());
+        if (!pass)
+            return false;
+        return filter<const FilterFunction&>(destination, input, pass, max);
+    }
 
-        for (const char ch : input)
+    namespace
+    {
+        template <size_t Count>
+        bool filterRanges(String&         destination,
+                          const String&   input,
+                          const ByteRange (&ranges)[Count],
+                          const size_t    max)
         {
-            if (destination.size() >= max) break;
-            if (pass(ch)) destination.push_back(ch);
+            const size_t size = input.size();
+            if (size == 0)
+                return false;
+
+            if (&destination != &input)
+                destination.resize(size < max ? size : max);
+
+            const size_t written = StringScan::copyIf(destination.data(),
+                                                      input.data(),
+                                                      input.data() + size,
+                                                      ranges,
+                                                      Count,
+                                                      max);
+            destination.resize(written);
+            return written != size;
         }
-        return destination.size() != input.size();
-    }
+    }  // namespace
 
     bool StringUtils::filterRange(
         String&       destination,
@@ -496,10 +776,17 @@ namespace Rt2
         const int8_t  end,
         const size_t  max)
     {
-        return filter(
-            destination, input, [start, end](const char ch)
-            { return ch >= start && ch <= end; },
-            max);
+        // The bounds are signed, so a range that crosses zero
+        // is two ranges of unsigned byte values.
+        if (start > end)
+            return filter(destination, input, [](char) { return false; }, max);
+        if (start < 0 && end >= 0)
+        {
+            const ByteRange split[] = {{U8(start), 0xFF}, {0, U8(end)}};
+            return filterRanges(destination, input, split, max);
+        }
+        const ByteRange range[] = {{U8(start), U8(end)}};
+        return filterRanges(destination, input, range, max);
     }
 
     bool StringUtils::filterAZaz(
@@ -507,7 +794,8 @@ namespace Rt2
         const String& input,
         const size_t  max)
     {
-        return filter(destination, input, isLetter, max);
+        constexpr ByteRange ranges[] = {{'A', 'Z'}, {'a', 'z'}};
+        return filterRanges(destination, input, ranges, max);
     }
 
     bool StringUtils::filterAZaz09(
@@ -515,7 +803,8 @@ namespace Rt2
         const String& input,
         const size_t  max)
     {
-        return filter(destination, input, isAlphaNumeric, max);
+        constexpr ByteRange ranges[] = {{'A', 'Z'}, {'a', 'z'}, {'0', '9'}};
+        return filterRanges(destination, input, ranges, max);
     }
 
     bool StringUtils::filterAscii(
@@ -523,7 +812,8 @@ namespace Rt2
         const String& input,
         const size_t  max)
     {
-        return filter(destination, input, isPrintableAscii, max);
+        constexpr ByteRange ranges[] = {{32, 127}, {'\t', '\n'}, {'\r', '\r'}};
+        return filterRanges(destination, input, ranges, max);
     }
 
     bool StringUtils::filterInt(
@@ -531,7 +821,8 @@ namespace Rt2
         const String& input,
         const size_t  max)
     {
-        return filter(destination, input, isInteger, max);
+        constexpr ByteRange ranges[] = {{'0', '9'}, {'-', '-'}};
+        return filterRanges(destination, input, ranges, max);
     }
 
     bool StringUtils::filterReal(
@@ -539,38 +830,25 @@ namespace Rt2
         const String& input,
         const size_t  max)
     {
-        return filter(destination, input, isReal, max);
+        constexpr ByteRange ranges[] = {{'0', '9'}, {'+', '+'}, {'-', '.'}, {'E', 'F'}, {'e', 'f'}};
+        return filterRanges(destination, input, ranges, max);
     }
 
     void StringUtils::trimWs(String& di, const String& in)
     {
-        const size_t n2 = in.size();
-        const size_t n1 = (n2 >> 1) + n2 % 2;
+        const char* base  = in.data();
+        const char* last  = StringScan::skipWsReverse(base, base + in.size());
+        const char* first = StringScan::skipWs(base, last);
 
-        size_t i = 0;
-        size_t x = Npos;
-        size_t y = Npos;
-
-        while (i < n1 && (x == Npos || y == Npos))
+        const size_t offset = size_t(first - base);
+        const size_t length = size_t(last - first);
+        if (&di == &in)
         {
-            if (x == Npos)
-            {
-                if (const char f = in[i]; !isWs(f))
-                    x = i;
-            }
-            if (y == Npos)
-            {
-                if (const char l = in[n2 - 1 - i]; !isWs(l))
-                    y = n2 - i;
-            }
-            ++i;
+            di.resize(offset + length);
+            di.erase(0, offset);
         }
-
-        if (x == Npos)
-            x = 0;
-        if (y == Npos)
-            y = n2 > 1 ? n2 - 1 : 0;
-        di = in.substr(x, y - x);
+        else
+            di.assign(first, length);
     }
 
     bool StringUtils::startsWith(const String& test, const char& chk)
@@ -26,12 +26,16 @@
 #include <functional>
 #include <sstream>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <unordered_map>
 #include <vector>
+#include "Utils/SplitView.h"
 
 namespace Rt2
 {
     using String      = std::string;
+    using StringView  = std::string_view;
     using StringDeque = std::deque<std::string>;
     using StringArray = std::vector<std::string>;
     using StringMap   = std::unordered_map<std::string, std::string>;
@@ -46,6 +50,88 @@ namespace Rt2
     using OutputFileStream   = std::ofstream;
     using FilterFunction     = std::function<bool(const char& ch)>;
 
+    /**
+     * \brief A single argument of Su::concat.
+     *
+     * Strings are viewed in place and numbers are formatted into a small
+     * inline buffer the same way an OStream would write them, so the total
+     * length is known before anything is copied.
+     */
+    class ConcatArg
+    {
+    private:
+        const char* _data{nullptr};
+        size_t      _size{0};
+        char        _buffer[32];
+
+    public:
+        ConcatArg(const String& v) :
+            _data(v.data()),
+            _size(v.size())
+        {
+        }
+
+        ConcatArg(const StringView& v) :
+            _data(v.data()),
+            _size(v.size())
+        {
+        }
+
+        ConcatArg(const char* v) :
+            _data(v ? v : ""),
+            _size(v ? std::char_traits<char>::length(v) : 0)
+        {
+        }
+
+        ConcatArg(char v);
+
+        ConcatArg(signed char v);
+
+        ConcatArg(unsigned char v);
+
+        ConcatArg(short v);
+
+        ConcatArg(unsigned short v);
+
+        ConcatArg(int v);
+
+        ConcatArg(unsigned int v);
+
+        ConcatArg(long v);
+
+        ConcatArg(unsigned long v);
+
+        ConcatArg(long long v);
+
+        ConcatArg(unsigned long long v);
+
+        ConcatArg(float v);
+
+        ConcatArg(double v);
+
+        // A template, so that pointers do not convert to bool.
+        template <typename T, std::enable_if_t<std::is_same_v<T, bool>, int> = 0>
+        ConcatArg(const T v) :
+            ConcatArg(v ? '1' : '0')
+        {
+        }
+
+        const char* data() const
+        {
+            return _data ? _data : _buffer;
+        }
+
+        size_t size() const
+        {
+            return _size;
+        }
+    };
+
+    class StringTable;
+
+    template <typename T>
+    constexpr bool IsConcatenable = std::is_convertible_v<const T&, ConcatArg>;
+
     class StringUtils
     {
     public:
@@ -64,6 +150,21 @@ namespace Rt2
             const String& input,
             char          separator);
 
+        static void split(
+            StringTable&  destination,
+            const String& input,
+            char          separator);
+
+        static void split(
+            StringTable&  destination,
+            const String& input,
+            const String& separator);
+
+        static void splitRejectEmpty(
+            StringTable&  destination,
+            const String& input,
+            char          separator);
+
         static void split(
             StringArray&  destination,
             const String& input,
@@ -74,6 +175,39 @@ namespace Rt2
             const String& input,
             const String& separator);
 
+        /**
+         * \brief Splits the input lazily into views, see SplitView.
+         * \param skipEmpty Drops the empty pieces between
+         * adjacent separators.
+         * \param maxSplits The number of pieces to produce before the
+         * rest of the input is returned whole.
+         */
+        static SplitView<CharSeparator> splitView(
+            const StringView& input,
+            char              separator,
+            bool              skipEmpty = false,
+            size_t            maxSplits = Npos);
+
+        static SplitView<StringSeparator> splitView(
+            const StringView& input,
+            const StringView& separator,
+            bool              skipEmpty = false,
+            size_t            maxSplits = Npos);
+
+        /**
+         * \brief Splits at every character for which predicate returns true.
+         */
+        template <typename Predicate,
+                  typename = std::enable_if_t<std::is_invocable_r_v<bool, Predicate, char>>>
+        static SplitView<PredicateSeparator<Predicate>> splitView(
+            const StringView& input,
+            Predicate         predicate,
+            const bool        skipEmpty = false,
+            const size_t      maxSplits = Npos)
+        {
+            return {input, PredicateSeparator<Predicate>{predicate}, skipEmpty, maxSplits};
+        }
+
         static void splitLine(
             StringArray&  dest,
             const String& input,
@@ -148,6 +282,15 @@ namespace Rt2
             const FilterFunction& pass,
             size_t                max = 0x100);
 
+        /// The same as filter, but calls pass directly instead of
+        /// through a std::function. destination may be input.
+        template <typename Predicate>
+        static bool filter(
+            String&       destination,
+            const String& input,
+            Predicate     pass,
+            size_t        max = 0x100);
+
         static bool filterRange(
             String&       destination,
             const String& input,
@@ -186,6 +329,13 @@ namespace Rt2
             const String& a,
             const String& b);
 
+        /// Replaces every a in inOut with b. When both have the same
+        /// length the string is rewritten in place in a single pass.
+        static void replaceAll(
+            String&       inOut,
+            const String& a,
+            const String& b);
+
         static void reverse(
             String&       dest,
             const String& input);
@@ -229,14 +379,57 @@ namespace Rt2
             int&    counter,
             void*   seed);
 
+        /**
+         * \brief Appends each argument to dest, growing it at most once.
+         *
+         * The arguments may be strings, characters or numbers.
+         * Numbers are written as an OStream would write them.
+         */
+        template <typename... Args>
+        static String& appendTo(String& dest, const Args&... args)
+        {
+            if constexpr (sizeof...(Args) > 0)
+            {
+                const ConcatArg pieces[] = {args...};
+                append(dest, pieces, sizeof...(Args));
+            }
+            return dest;
+        }
+
+        /**
+         * \return The arguments joined into a string that is
+         * allocated once, at its final length.
+         */
+        template <typename... Args>
+        static String concat(const Args&... args)
+        {
+            String dest;
+            appendTo(dest, args...);
+            return dest;
+        }
+
+        /**
+         * \brief Writes the arguments as a string. It is the same as
+         * concat, but any argument type with an OStream operator is
+         * accepted, in which case the arguments are streamed.
+         */
         template <typename... Args>
         static String join(Args&&... args)
         {
-            OutputStringStream oss;
-            ((oss << std::forward<Args>(args)), ...);
-            return oss.str();
+            if constexpr ((IsConcatenable<std::decay_t<Args>> && ...))
+                return concat(args...);
+            else
+            {
+                OutputStringStream oss;
+                ((oss << std::forward<Args>(args)), ...);
+                return oss.str();
+            }
         }
 
+        /**
+         * \brief Writes through the stream's own formatting, since
+         * the caller may have set a precision, base or width on it.
+         */
         template <typename... Args>
         static OStream& merge(OStream& out, Args&&... args)
         {
@@ -244,19 +437,69 @@ namespace Rt2
             return out;
         }
 
+        /**
+         * \return The arguments with c written before each one.
+         */
         template <typename... Args>
         static String csv(const char c, Args&&... args)
         {
-            OutputStringStream out;
-            ((out << c << std::forward<Args>(args)), ...);
-            return out.str();
+            if constexpr ((IsConcatenable<std::decay_t<Args>> && ...))
+            {
+                String dest;
+                if constexpr (sizeof...(Args) > 0)
+                {
+                    const ConcatArg pieces[] = {args...};
+                    append(dest, pieces, sizeof...(Args), StringView(&c, 1));
+                }
+                return dest;
+            }
+            else
+            {
+                OutputStringStream out;
+                ((out << c << std::forward<Args>(args)), ...);
+                return out.str();
+            }
         }
 
         static void cmd(String& dest, char** argv, int argc, int from = 1);
 
         static String csv(const StringArray& sa);
+
+    private:
+        static void append(String&           dest,
+                           const ConcatArg*  args,
+                           size_t            count,
+                           const StringView& prefix = {});
     };
 
+    template <typename Predicate>
+    bool StringUtils::filter(
+        String&       destination,
+        const String& input,
+        Predicate     pass,
+        const size_t  max)
+    {
+        const size_t size = input.size();
+        if (size == 0)
+            return false;
+
+        // In place the write position never passes the read position.
+        if (&destination != &input)
+            destination.resize(size < max ? size : max);
+
+        const char* in  = input.data();
+        char*       out = destination.data();
+
+        size_t written = 0;
+        for (size_t i = 0; i < size && written < max; ++i)
+        {
+            if (pass(in[i]))
+                out[written++] = in[i];
+        }
+        destination.resize(written);
+        return written != size;
+    }
+
     using Su = StringUtils;
 
 }  // namespace Rt2
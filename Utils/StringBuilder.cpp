@@ -21,6 +21,15 @@
 */
 #include "Utils/StringBuilder.h"
 #include "Char.h"
+#include "Utils/NumberFormat.h"
+
+#if RT_PLATFORM == RT_PLATFORM_WINDOWS
+#include <io.h>
+#else
+#include <sys/uio.h>
+#include <cerrno>
+#include <climits>
+#endif
 
 namespace Rt2
 {
@@ -28,17 +37,105 @@ namespace Rt2
     {
         // discouraged,
         // because of copy on return.
-        return {(char*)_buffer, size()};
+        String copyOnReturn;
+        toString(copyOnReturn);
+        return copyOnReturn;
     }
 
     void StringBuilder::toString(String& dest) const
     {
         dest.clear();
-        dest.append({(char*)_buffer, size()});
+        dest.reserve(size());
+        for (const Chunk& chunk : _chunks)
+            dest.append((char*)chunk.data, chunk.size);
+        if (_size > 0)
+            dest.append((char*)_buffer, _size);
+    }
+
+    String StringBuilder::release()
+    {
+        String dest;
+        toString(dest);
+        clear();
+        return dest;
+    }
+
+    void StringBuilder::writeTo(OStream& dest) const
+    {
+        for (const Chunk& chunk : _chunks)
+            dest.write((char*)chunk.data, (std::streamsize)chunk.size);
+        if (_size > 0)
+            dest.write((char*)_buffer, (std::streamsize)_size);
+    }
+
+    bool StringBuilder::writeTo(const int fd) const
+    {
+#if RT_PLATFORM == RT_PLATFORM_WINDOWS
+        const auto writeAll = [fd](const I8* data, size_t len)
+        {
+            while (len > 0)
+            {
+                const int n = _write(fd, data, (unsigned)Min<size_t>(len, 0x40000000));
+                if (n < 0)
+                    return false;
+                data += n;
+                len -= (size_t)n;
+            }
+            return true;
+        };
+
+        for (const Chunk& chunk : _chunks)
+        {
+            if (!writeAll(chunk.data, chunk.size))
+                return false;
+        }
+        return writeAll(_buffer, _size);
+#else
+        SimpleArray<iovec> vec;
+        vec.reserve(_chunks.size() + 1);
+        for (const Chunk& chunk : _chunks)
+            vec.push_back({chunk.data, chunk.size});
+        if (_size > 0)
+            vec.push_back({_buffer, _size});
+
+        iovec* cur = vec.begin();
+        iovec* end = vec.end();
+        while (cur != end)
+        {
+            const int     count = (int)Min<ptrdiff_t>(end - cur, IOV_MAX);
+            const ssize_t n     = ::writev(fd, cur, count);
+            if (n < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                return false;
+            }
+
+            // skip what was written, a partial write
+            // may end inside of a chunk
+            size_t written = (size_t)n;
+            while (cur != end && written >= cur->iov_len)
+            {
+                written -= cur->iov_len;
+                ++cur;
+            }
+            if (cur != end)
+            {
+                cur->iov_base = (I8*)cur->iov_base + written;
+                cur->iov_len -= written;
+            }
+        }
+        return true;
+#endif
     }
 
     void StringBuilder::clear()
     {
+        for (const Chunk& chunk : _chunks)
+            delete[] chunk.data;
+        _chunks.clear();
+        _sealed = 0;
+
         delete[] _buffer;
         _buffer = nullptr;
 
@@ -48,6 +145,12 @@ namespace Rt2
 
     void StringBuilder::reserve(const size_t len)
     {
+        if (_strategy == ALLOC_CHUNKED)
+        {
+            nextChunk(len - _size);
+            return;
+        }
+
         const size_t newCap = getNextCapacity(len);
 
         RT_ASSERT(newCap > _size)
@@ -63,6 +166,23 @@ namespace Rt2
         }
     }
 
+    void StringBuilder::nextChunk(const size_t len)
+    {
+        if (_size > 0)
+        {
+            _chunks.push_back({_buffer, _size});
+            _sealed += _size;
+        }
+        else
+            delete[] _buffer;
+
+        const size_t shift = Min<size_t>(_chunks.size(), 16);
+
+        _capacity = Max(len + 1, Min(_nByteBlock << shift, MaxChunk));
+        _buffer   = new I8[_capacity + 1];
+        _size     = 0;
+    }
+
     size_t StringBuilder::getNextCapacity(const size_t len) const
     {
         size_t next;
@@ -76,11 +196,25 @@ namespace Rt2
 
     size_t StringBuilder::writeToBuffer(const void* source, const size_t len)
     {
+        if (_strategy == ALLOC_CHUNKED && _size + len > _capacity)
+        {
+            // top off the current chunk before starting the next
+            const size_t head = _capacity - _size;
+            if (head > 0)
+                memcpy(&_buffer[_size], source, head);
+            _size += head;
+
+            nextChunk(len - head);
+            memcpy(_buffer, (const I8*)source + head, len - head);
+            _size = len - head;
+            return len;
+        }
+
         const size_t nextPosition = _size + len;
         if (nextPosition > _capacity)
         {
             reserve(nextPosition);
-            RT_ASSERT(_capacity > nextPosition)
+            RT_ASSERT(_capacity - _size >= len)
         }
 
         if (_buffer != nullptr)
@@ -92,18 +226,42 @@ namespace Rt2
         return Npos;
     }
 
+    char* StringBuilder::prepare(const size_t len)
+    {
+        const size_t nextPosition = _size + len;
+        if (nextPosition > _capacity)
+        {
+            reserve(nextPosition);
+            RT_ASSERT(_capacity - _size >= len)
+        }
+        return (char*)&_buffer[_size];
+    }
+
+    void StringBuilder::commit(const size_t len)
+    {
+        RT_ASSERT(_size + len <= _capacity)
+        _size += len;
+    }
+
     void StringBuilder::setStrategy(const U8 strategy, const size_t nBytes)
     {
-        _strategy   = Clamp<U8>(strategy, 0, 1);
+        _strategy   = Clamp<U8>(strategy, ALLOC_N_BYTE_BLOCK, ALLOC_CHUNKED);
         _nByteBlock = Clamp<size_t>(nBytes, 8, Npos16);
-        reserve(_nByteBlock);
+
+        if (_strategy != ALLOC_CHUNKED)
+            reserve(_nByteBlock);
+        else if (_capacity - _size < _nByteBlock)
+            nextChunk(_nByteBlock);
     }
 
 
     void StringBuilder::write(const StringBuilder& oth)
     {
-        if (oth.size() > 0)
-            writeToBuffer(oth._buffer, oth.size());
+        RT_ASSERT(this != &oth)
+        for (const Chunk& chunk : oth._chunks)
+            writeToBuffer(chunk.data, chunk.size);
+        if (oth._size > 0)
+            writeToBuffer(oth._buffer, oth._size);
     }
 
     void StringBuilder::write(const String& str)
@@ -131,58 +289,42 @@ namespace Rt2
 
     void StringBuilder::write(const I16 val)
     {
-        _scratch.resize(0);
-        Char::toString(_scratch, val);
-        writeToBuffer(_scratch.c_str(), _scratch.size());
+        commit(NumberFormat::integer(prepare(NumberFormat::IntegerLength), (I32)val));
     }
 
     void StringBuilder::write(const I32 val)
     {
-        _scratch.resize(0);
-        Char::toString(_scratch, val);
-        writeToBuffer(_scratch.c_str(), _scratch.size());
+        commit(NumberFormat::integer(prepare(NumberFormat::IntegerLength), val));
     }
 
     void StringBuilder::write(const I64 val)
     {
-        _scratch.resize(0);
-        Char::toString(_scratch, val);
-        writeToBuffer(_scratch.c_str(), _scratch.size());
+        commit(NumberFormat::integer(prepare(NumberFormat::IntegerLength), val));
     }
 
     void StringBuilder::write(const U16 val)
     {
-        _scratch.resize(0);
-        Char::toString(_scratch, val);
-        writeToBuffer(_scratch.c_str(), _scratch.size());
+        commit(NumberFormat::integer(prepare(NumberFormat::IntegerLength), (U32)val));
     }
 
     void StringBuilder::write(const U32 val)
     {
-        _scratch.resize(0);
-        Char::toString(_scratch, val);
-        writeToBuffer(_scratch.c_str(), _scratch.size());
+        commit(NumberFormat::integer(prepare(NumberFormat::IntegerLength), val));
     }
 
     void StringBuilder::write(const U64 val)
     {
-        _scratch.resize(0);
-        Char::toString(_scratch, val);
-        writeToBuffer(_scratch.c_str(), _scratch.size());
+        commit(NumberFormat::integer(prepare(NumberFormat::IntegerLength), val));
     }
 
     void StringBuilder::write(const double val)
     {
-        _scratch.resize(0);
-        Char::toString(_scratch, val, true);
-        writeToBuffer(_scratch.c_str(), _scratch.size());
+        commit(NumberFormat::real(prepare(NumberFormat::RealLength), val));
     }
 
     void StringBuilder::write(const float val)
     {
-        _scratch.resize(0);
-        Char::toString(_scratch, val, true);
-        writeToBuffer(_scratch.c_str(), _scratch.size());
+        commit(NumberFormat::real(prepare(NumberFormat::RealLength), val));
     }
 
 }  // namespace Rt2
\ No newline at end of file
@@ -22,6 +22,7 @@
 #pragma once
 
 #include "Definitions.h"
+#include "Utils/Array.h"
 #include "Utils/String.h"
 
 namespace Rt2
@@ -31,24 +32,49 @@ namespace Rt2
     {
         ALLOC_N_BYTE_BLOCK,
         ALLOC_MUL2,
+        // Written bytes are never moved. The buffer is a list of chunks
+        // that start at nBytes and double in size up to MaxChunk.
+        ALLOC_CHUNKED,
     };
 
     class StringBuilder
     {
+    public:
+        static constexpr size_t MaxChunk = 0x100000;
+
     private:
+        struct Chunk
+        {
+            I8*    data;
+            size_t size;
+        };
+
+        using Chunks = SimpleArray<Chunk>;
+
+        // In the chunked strategy _buffer is the chunk being written
+        // and _chunks holds the full ones in order.
         I8*    _buffer{nullptr};
         size_t _size{0};
         size_t _capacity{0};
         size_t _nByteBlock{256};
         U8     _strategy{ALLOC_N_BYTE_BLOCK};
-        String _scratch{};
+        Chunks _chunks;
+        size_t _sealed{0};
 
         void reserve(size_t len);
 
+        void nextChunk(size_t len);
+
         size_t getNextCapacity(size_t len) const;
 
         size_t writeToBuffer(const void* source, size_t len);
 
+        // Returns room for at least len bytes at the end of the
+        // buffer; commit then advances the size by what was used.
+        char* prepare(size_t len);
+
+        void commit(size_t len);
+
     public:
         StringBuilder()
         {
@@ -70,6 +96,10 @@ namespace Rt2
             clear();
         }
 
+        StringBuilder(const StringBuilder&) = delete;
+
+        StringBuilder& operator=(const StringBuilder&) = delete;
+
         void setStrategy(U8 strategy, size_t nBytes);
 
         size_t size() const;
@@ -80,6 +110,24 @@ namespace Rt2
 
         void toString(String& dest) const;
 
+        /**
+         * \brief Moves the contents into a String with a single copy
+         * and releases the builder's memory.
+         */
+        String release();
+
+        /**
+         * \brief Writes the contents to a stream, one chunk at a time.
+         */
+        void writeTo(OStream& dest) const;
+
+        /**
+         * \brief Writes the contents to a file descriptor. On POSIX
+         * systems all chunks are handed to writev at once.
+         * \return False if the descriptor reported an error.
+         */
+        bool writeTo(int fd) const;
+
         void clear();
 
         void write(const StringBuilder& oth);
@@ -111,12 +159,12 @@ namespace Rt2
 
     inline size_t StringBuilder::size() const
     {
-        return _size;
+        return _sealed + _size;
     }
 
     inline size_t StringBuilder::capacity() const
     {
-        return _capacity;
+        return _sealed + _capacity;
     }
 
 }  // namespace Rt2
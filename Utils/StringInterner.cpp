@@ -0,0 +1,293 @@
+/*
+-------------------------------------------------------------------------------
+    Copyright (c) Charles Carley.
+
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+-------------------------------------------------------------------------------
+*/
+#include "Utils/StringInterner.h"
+#include <cstring>
+#include "Utils/Exception.h"
+#include "Utils/Hash.h"
+
+namespace Rt2
+{
+    namespace
+    {
+        constexpr U64 InitialSlots = 0x400;
+        constexpr U32 InitialPages = 0x10;
+        constexpr U32 LengthBytes  = sizeof(U32);
+    }  // namespace
+
+    StringInterner::StringInterner(const bool concurrent, const size_t chunkSize) :
+        _chunkSize(Max<size_t>(chunkSize, 0x100)),
+        _concurrent(concurrent)
+    {
+        clear();
+    }
+
+    StringInterner::~StringInterner()
+    {
+        release();
+    }
+
+    StringId StringInterner::insert(const std::string_view& str)
+    {
+        std::unique_lock lock(_lock, std::defer_lock);
+        if (_concurrent)
+            lock.lock();
+
+        const U32 hash = hashOf(str);
+
+        const StringId found = lookup(_table.load(std::memory_order_relaxed), str, hash);
+        if (found != InvalidString)
+            return found;
+
+        const U32 id = _size.load(std::memory_order_relaxed);
+        if (id >= InvalidString - 1)
+            throw Exception("string interner id limit exceeded");
+
+        // Keep the load factor at or below one half.
+        if ((U64(id) + 1) * 2 > _table.load(std::memory_order_relaxed)->mask + 1)
+            grow();
+
+        publish(id, store(str));
+
+        // The id becomes resolvable before it can be found, and it can
+        // be found before it is counted by size. That way an id seen by
+        // a reader through either find or size always resolves.
+        _resolvable.store(id + 1, std::memory_order_release);
+        place(_table.load(std::memory_order_relaxed), U64(hash) << 32 | (id + 1));
+        _size.store(id + 1, std::memory_order_release);
+        return id;
+    }
+
+    StringId StringInterner::find(const std::string_view& str) const
+    {
+        return lookup(_table.load(std::memory_order_acquire), str, hashOf(str));
+    }
+
+    StringId StringInterner::get(const std::string_view& str) const
+    {
+        const StringId id = find(str);
+        if (id == InvalidString)
+            throw Exception("string not found");
+        return id;
+    }
+
+    std::string_view StringInterner::at(const StringId id) const
+    {
+        if (!contains(id))
+            throw Exception("array index out of bounds");
+        return view(entry(id));
+    }
+
+    bool StringInterner::contains(const std::string_view& str) const
+    {
+        return find(str) != InvalidString;
+    }
+
+    bool StringInterner::contains(const StringId id) const
+    {
+        return id < _resolvable.load(std::memory_order_acquire);
+    }
+
+    void StringInterner::clear()
+    {
+        // Must not run while other threads are reading.
+        std::unique_lock lock(_lock, std::defer_lock);
+        if (_concurrent)
+            lock.lock();
+
+        release();
+
+        Table* table = new Table;
+        table->mask  = InitialSlots - 1;
+        table->slots = new std::atomic<U64>[InitialSlots]();
+        _tables.push_back(table);
+        _table.store(table, std::memory_order_release);
+
+        _directorySize = InitialPages;
+        _directory.store(new Page[InitialPages](), std::memory_order_release);
+    }
+
+    U32 StringInterner::hashOf(const std::string_view& str)
+    {
+        const hash_t hash = Hash(str.data(), str.size());
+        return U32(U64(hash) ^ U64(hash) >> 32);
+    }
+
+    std::string_view StringInterner::view(const char* entry)
+    {
+        U32 len;
+        memcpy(&len, entry, LengthBytes);
+        return {entry + LengthBytes, len};
+    }
+
+    const char* StringInterner::entry(const StringId id) const
+    {
+        const Directory directory = _directory.load(std::memory_order_acquire);
+        return directory[id >> PageBits][id & (PageSize - 1)];
+    }
+
+    StringId StringInterner::lookup(const Table*            table,
+                                    const std::string_view& str,
+                                    const U32               hash) const
+    {
+        U64 i = hash & table->mask;
+        for (;;)
+        {
+            const U64 slot = table->slots[i].load(std::memory_order_acquire);
+            if (slot == 0)
+                return InvalidString;
+
+            if (U32(slot >> 32) == hash)
+            {
+                const StringId id = U32(slot) - 1;
+                if (view(entry(id)) == str)
+                    return id;
+            }
+            i = (i + 1) & table->mask;
+        }
+    }
+
+    const char* StringInterner::store(const std::string_view& str)
+    {
+        if (str.size() >= Npos32)
+            throw Exception("string is too large to intern");
+
+        const U32    len  = U32(str.size());
+        const size_t need = LengthBytes + len + 1;
+
+        char* dest;
+        if (need > _chunkSize)
+        {
+            // Oversized strings get a chunk of their own
+            // so the current chunk keeps its free space.
+            dest = new char[need];
+            _chunks.push_back(dest);
+        }
+        else
+        {
+            if (!_chunk || _chunkUsed + need > _chunkSize)
+            {
+                _chunk     = new char[_chunkSize];
+                _chunkUsed = 0;
+                _chunks.push_back(_chunk);
+            }
+            dest = _chunk + _chunkUsed;
+            _chunkUsed += need;
+        }
+
+        memcpy(dest, &len, LengthBytes);
+        if (len > 0)
+            memcpy(dest + LengthBytes, str.data(), len);
+        dest[LengthBytes + len] = 0;
+
+        _bytes += len;
+        return dest;
+    }
+
+    void StringInterner::publish(const StringId id, const char* entry)
+    {
+        const U32 page = id >> PageBits;
+
+        Directory directory = _directory.load(std::memory_order_relaxed);
+        if (page >= _pages)
+        {
+            if (_pages >= _directorySize)
+            {
+                // Readers may still hold the old directory,
+                // so it is retired rather than deleted.
+                const Directory larger = new Page[_directorySize * 2]();
+                memcpy(larger, directory, sizeof(Page) * _directorySize);
+
+                _retired.push_back(directory);
+                _directorySize *= 2;
+                directory = larger;
+                _directory.store(directory, std::memory_order_release);
+            }
+            directory[_pages++] = new const char*[PageSize];
+        }
+        directory[page][id & (PageSize - 1)] = entry;
+    }
+
+    void StringInterner::place(Table* table, const U64 slot) const
+    {
+        U64 i = (slot >> 32) & table->mask;
+        while (table->slots[i].load(std::memory_order_relaxed) != 0)
+            i = (i + 1) & table->mask;
+        table->slots[i].store(slot, std::memory_order_release);
+    }
+
+    void StringInterner::grow()
+    {
+        const Table* table = _table.load(std::memory_order_relaxed);
+        const U64    size  = (table->mask + 1) * 2;
+
+        Table* larger = new Table;
+        larger->mask  = size - 1;
+        larger->slots = new std::atomic<U64>[size]();
+
+        for (U64 i = 0; i <= table->mask; ++i)
+        {
+            const U64 slot = table->slots[i].load(std::memory_order_relaxed);
+            if (slot != 0)
+                place(larger, slot);
+        }
+
+        // The old table stays alive for readers that are still probing it.
+        _tables.push_back(larger);
+        _table.store(larger, std::memory_order_release);
+    }
+
+    void StringInterner::release()
+    {
+        for (void* chunk : _chunks)
+            delete[] (char*)chunk;
+        _chunks.resizeFast(0);
+
+        if (const Directory directory = _directory.load(std::memory_order_relaxed))
+        {
+            for (U32 i = 0; i < _pages; ++i)
+                delete[] directory[i];
+            delete[] directory;
+        }
+        for (void* directory : _retired)
+            delete[] (Directory)directory;
+        _retired.resizeFast(0);
+
+        for (Table* table : _tables)
+        {
+            delete[] table->slots;
+            delete table;
+        }
+        _tables.resizeFast(0);
+
+        _table.store(nullptr, std::memory_order_relaxed);
+        _directory.store(nullptr, std::memory_order_relaxed);
+        _size.store(0, std::memory_order_relaxed);
+        _resolvable.store(0, std::memory_order_relaxed);
+
+        _chunk         = nullptr;
+        _chunkUsed     = 0;
+        _bytes         = 0;
+        _pages         = 0;
+        _directorySize = 0;
+    }
+
+}  // namespace Rt2
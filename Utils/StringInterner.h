@@ -0,0 +1,166 @@
+/*
+-------------------------------------------------------------------------------
+    Copyright (c) Charles Carley.
+
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+-------------------------------------------------------------------------------
+*/
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <string_view>
+#include "Utils/Array.h"
+#include "Utils/Definitions.h"
+
+namespace Rt2
+{
+    using StringId = U32;
+
+    constexpr StringId InvalidString = Npos32;
+
+    /**
+     * \brief Maps strings to dense 32-bit ids and back.
+     *
+     * The bytes of each distinct string are stored once, in an append-only
+     * arena whose chunks never move, so views returned by at stay valid
+     * until clear. Lookups take a string_view and do not allocate.
+     *
+     * When constructed as concurrent, inserts are serialized by a lock and
+     * find, contains and at may run on other threads at the same time.
+     */
+    class StringInterner
+    {
+    public:
+        static constexpr U32 PageBits = 12;
+        static constexpr U32 PageSize = 1 << PageBits;
+
+    private:
+        struct Table
+        {
+            U64               mask{0};
+            std::atomic<U64>* slots{nullptr};
+        };
+
+        using Pointers = SimpleArray<void*>;
+        using Tables   = SimpleArray<Table*>;
+
+        // Each entry points at a U32 length followed by the bytes.
+        using Page      = const char**;
+        using Directory = Page*;
+
+        std::atomic<Table*>    _table{nullptr};
+        std::atomic<Directory> _directory{nullptr};
+        std::atomic<U32>       _size{0};
+        std::atomic<U32>       _resolvable{0};
+        U32                    _pages{0};
+        U32                    _directorySize{0};
+        char*                  _chunk{nullptr};
+        size_t                 _chunkUsed{0};
+        size_t                 _chunkSize;
+        size_t                 _bytes{0};
+        Pointers               _chunks;
+        Pointers               _retired;
+        Tables                 _tables;
+        const bool             _concurrent;
+        mutable std::mutex     _lock;
+
+    public:
+        /**
+         * \param concurrent Allows readers on other threads while inserting.
+         * \param chunkSize The size in bytes of each arena chunk.
+         */
+        explicit StringInterner(bool concurrent = false, size_t chunkSize = 0x10000);
+
+        ~StringInterner();
+
+        StringInterner(const StringInterner&) = delete;
+
+        /**
+         * \brief Adds the string if it is not already present.
+         * \return The id of the string.
+         */
+        StringId insert(const std::string_view& str);
+
+        /**
+         * \return The id of the string or InvalidString if it has not been inserted.
+         */
+        StringId find(const std::string_view& str) const;
+
+        /**
+         * \return The id of the string.
+         * \throws Exception if the string has not been inserted.
+         */
+        StringId get(const std::string_view& str) const;
+
+        /**
+         * \return A view of the string with the supplied id.
+         * \throws Exception if the id is out of range.
+         */
+        std::string_view at(StringId id) const;
+
+        bool contains(const std::string_view& str) const;
+
+        bool contains(StringId id) const;
+
+        U32 size() const;
+
+        bool empty() const;
+
+        /**
+         * \return The number of string bytes held by the arena.
+         */
+        size_t bytes() const;
+
+        void clear();
+
+    private:
+        static U32 hashOf(const std::string_view& str);
+
+        static std::string_view view(const char* entry);
+
+        const char* entry(StringId id) const;
+
+        StringId lookup(const Table* table, const std::string_view& str, U32 hash) const;
+
+        const char* store(const std::string_view& str);
+
+        void publish(StringId id, const char* entry);
+
+        void place(Table* table, U64 slot) const;
+
+        void grow();
+
+        void release();
+    };
+
+    inline U32 StringInterner::size() const
+    {
+        return _size.load(std::memory_order_acquire);
+    }
+
+    inline bool StringInterner::empty() const
+    {
+        return size() == 0;
+    }
+
+    inline size_t StringInterner::bytes() const
+    {
+        return _bytes;
+    }
+
+}  // namespace Rt2
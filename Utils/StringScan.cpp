@@ -0,0 +1,585 @@
+/*
+-------------------------------------------------------------------------------
+    Copyright (c) Charles Carley.
+
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+-------------------------------------------------------------------------------
+*/
+#include "Utils/StringScan.h"
+#include <cstring>
+#include "Utils/Bits.h"
+#include "Utils/Cpu.h"
+
+#if RT_ARCH_X64
+    #include <immintrin.h>
+#endif
+
+namespace Rt2
+{
+    namespace
+    {
+        bool isWsByte(const char ch)
+        {
+            return ch == ' ' || ch == '\t' || ch == '\r' || ch == '\n';
+        }
+
+        const char* findScalar(const char* first, const char* last, const char ch)
+        {
+            const void* found = memchr(first, ch, size_t(last - first));
+            return found ? (const char*)found : last;
+        }
+
+        const char* findScalar(const char*  first,
+                               const char*  last,
+                               const char*  pattern,
+                               const size_t len)
+        {
+            const char* end = last - len + 1;
+            while (first < end)
+            {
+                first = findScalar(first, end, pattern[0]);
+                if (first == end)
+                    break;
+                if (memcmp(first + 1, pattern + 1, len - 1) == 0)
+                    return first;
+                ++first;
+            }
+            return last;
+        }
+
+        const char* skipWsScalar(const char* first, const char* last)
+        {
+            while (first < last && isWsByte(*first))
+                ++first;
+            return first;
+        }
+
+        const char* skipWsReverseScalar(const char* first, const char* last)
+        {
+            while (last > first && isWsByte(last[-1]))
+                --last;
+            return last;
+        }
+
+        const char* findControlScalar(const char* first, const char* last)
+        {
+            while (first < last && U8(*first) >= 32 && U8(*first) <= 127)
+                ++first;
+            return first;
+        }
+
+        bool inRanges(const char ch, const ByteRange* ranges, const size_t count)
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                if (U8(U8(ch) - ranges[i].lo) <= U8(ranges[i].hi - ranges[i].lo))
+                    return true;
+            }
+            return false;
+        }
+
+        char* copyIfScalar(char*            out,
+                           const char*      end,
+                           const char*      first,
+                           const char*      last,
+                           const ByteRange* ranges,
+                           const size_t     count)
+        {
+            for (; first < last && out < end; ++first)
+            {
+                if (inRanges(*first, ranges, count))
+                    *out++ = *first;
+            }
+            return out;
+        }
+
+        // Flips the case bit of every byte in [base, base + 25].
+        void flipCaseScalar(char* dest, const char* first, const char* last, const char base)
+        {
+            for (; first < last; ++first, ++dest)
+            {
+                const char ch = *first;
+                *dest         = U8(ch - base) <= 25 ? char(ch ^ 0x20) : ch;
+            }
+        }
+
+#if RT_ARCH_X64
+        // SSE2 is part of x64, so these need no target attribute.
+
+        // Sets the lanes of v that are in [lo, lo + span] with an unsigned compare.
+        __m128i inRange(const __m128i v, const __m128i lo, const __m128i span)
+        {
+            const __m128i d = _mm_sub_epi8(v, lo);
+            return _mm_cmpeq_epi8(_mm_min_epu8(d, span), d);
+        }
+
+        char* copyIfSse2(char*            out,
+                         const char*      end,
+                         const char*      first,
+                         const char*      last,
+                         const ByteRange* ranges,
+                         const size_t     count)
+        {
+            __m128i lo[StringScan::MaxRanges], span[StringScan::MaxRanges];
+            for (size_t i = 0; i < count; ++i)
+            {
+                lo[i]   = _mm_set1_epi8(char(ranges[i].lo));
+                span[i] = _mm_set1_epi8(char(ranges[i].hi - ranges[i].lo));
+            }
+
+            for (; last - first >= 16 && end - out >= 16; first += 16)
+            {
+                const __m128i v = _mm_loadu_si128((const __m128i*)first);
+
+                __m128i pass = _mm_setzero_si128();
+                for (size_t i = 0; i < count; ++i)
+                    pass = _mm_or_si128(pass, inRange(v, lo[i], span[i]));
+
+                U32 m = U32(_mm_movemask_epi8(pass));
+                if (m == 0xFFFF)
+                {
+                    _mm_storeu_si128((__m128i*)out, v);
+                    out += 16;
+                }
+                else
+                {
+                    for (; m; m &= m - 1)
+                        *out++ = first[Bits::countTrailingZeros(m)];
+                }
+            }
+            return copyIfScalar(out, end, first, last, ranges, count);
+        }
+
+        void flipCaseSse2(char* dest, const char* first, const char* last, const char base)
+        {
+            const __m128i lo   = _mm_set1_epi8(base);
+            const __m128i span = _mm_set1_epi8(25);
+            const __m128i flip = _mm_set1_epi8(0x20);
+            for (; last - first >= 16; first += 16, dest += 16)
+            {
+                const __m128i v = _mm_loadu_si128((const __m128i*)first);
+                _mm_storeu_si128((__m128i*)dest,
+                                 _mm_xor_si128(v, _mm_and_si128(inRange(v, lo, span), flip)));
+            }
+            flipCaseScalar(dest, first, last, base);
+        }
+
+        U32 wsMask(const __m128i v)
+        {
+            const __m128i ws = _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')),
+                             _mm_cmpeq_epi8(v, _mm_set1_epi8('\t'))),
+                _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\r')),
+                             _mm_cmpeq_epi8(v, _mm_set1_epi8('\n'))));
+            return U32(_mm_movemask_epi8(ws));
+        }
+
+        const char* findSse2(const char* first, const char* last, const char ch)
+        {
+            const __m128i c = _mm_set1_epi8(ch);
+            for (; last - first >= 16; first += 16)
+            {
+                const __m128i v = _mm_loadu_si128((const __m128i*)first);
+                if (const U32 m = U32(_mm_movemask_epi8(_mm_cmpeq_epi8(v, c))))
+                    return first + Bits::countTrailingZeros(m);
+            }
+            for (; first < last; ++first)
+            {
+                if (*first == ch)
+                    return first;
+            }
+            return last;
+        }
+
+        // Compares the first and the last byte of the pattern at sixteen
+        // positions at once and only checks the rest where both matched;
+        // W. Mula, SIMD-friendly algorithms for substring searching.
+        const char* findSse2(const char*  first,
+                             const char*  last,
+                             const char*  pattern,
+                             const size_t len)
+        {
+            const __m128i head = _mm_set1_epi8(pattern[0]);
+            const __m128i tail = _mm_set1_epi8(pattern[len - 1]);
+
+            const char* p = first;
+            for (; size_t(last - p) >= 16 + len - 1; p += 16)
+            {
+                const __m128i a = _mm_loadu_si128((const __m128i*)p);
+                const __m128i b = _mm_loadu_si128((const __m128i*)(p + len - 1));
+
+                U32 m = U32(_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(a, head),
+                                                            _mm_cmpeq_epi8(b, tail))));
+                while (m)
+                {
+                    const int i = Bits::countTrailingZeros(m);
+                    if (memcmp(p + i + 1, pattern + 1, len - 2) == 0)
+                        return p + i;
+                    m &= m - 1;
+                }
+            }
+            return findScalar(p, last, pattern, len);
+        }
+
+        const char* skipWsSse2(const char* first, const char* last)
+        {
+            for (; last - first >= 16; first += 16)
+            {
+                if (const U32 m = ~wsMask(_mm_loadu_si128((const __m128i*)first)) & 0xFFFF)
+                    return first + Bits::countTrailingZeros(m);
+            }
+            return skipWsScalar(first, last);
+        }
+
+        const char* skipWsReverseSse2(const char* first, const char* last)
+        {
+            for (; last - first >= 16; last -= 16)
+            {
+                if (const U32 m = ~wsMask(_mm_loadu_si128((const __m128i*)(last - 16))) & 0xFFFF)
+                    return last - 16 + (64 - Bits::countLeadingZeros(m));
+            }
+            return skipWsReverseScalar(first, last);
+        }
+
+        const char* findControlSse2(const char* first, const char* last)
+        {
+            // a signed compare catches both the low controls and bytes above 127
+            const __m128i space = _mm_set1_epi8(' ');
+            for (; last - first >= 16; first += 16)
+            {
+                const __m128i v = _mm_loadu_si128((const __m128i*)first);
+                if (const U32 m = U32(_mm_movemask_epi8(_mm_cmplt_epi8(v, space))))
+                    return first + Bits::countTrailingZeros(m);
+            }
+            return findControlScalar(first, last);
+        }
+
+        RT_TARGET_AVX2 U32 wsMask(const __m256i v)
+        {
+            const __m256i ws = _mm256_or_si256(
+                _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')),
+                                _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\t'))),
+                _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\r')),
+                                _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n'))));
+            return U32(_mm256_movemask_epi8(ws));
+        }
+
+        RT_TARGET_AVX2 const char* findAvx2(const char* first, const char* last, const char ch)
+        {
+            const __m256i c = _mm256_set1_epi8(ch);
+            for (; last - first >= 32; first += 32)
+            {
+                const __m256i v = _mm256_loadu_si256((const __m256i*)first);
+                if (const U32 m = U32(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, c))))
+                    return first + Bits::countTrailingZeros(m);
+            }
+            return findSse2(first, last, ch);
+        }
+
+        RT_TARGET_AVX2 const char* findAvx2(const char*  first,
+                                            const char*  last,
+                                            const char*  pattern,
+                                            const size_t len)
+        {
+            const __m256i head = _mm256_set1_epi8(pattern[0]);
+            const __m256i tail = _mm256_set1_epi8(pattern[len - 1]);
+
+            const char* p = first;
+            for (; size_t(last - p) >= 32 + len - 1; p += 32)
+            {
+                const __m256i a = _mm256_loadu_si256((const __m256i*)p);
+                const __m256i b = _mm256_loadu_si256((const __m256i*)(p + len - 1));
+
+                U32 m = U32(_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(a, head),
+                                                                  _mm256_cmpeq_epi8(b, tail))));
+                while (m)
+                {
+                    const int i = Bits::countTrailingZeros(m);
+                    if (memcmp(p + i + 1, pattern + 1, len - 2) == 0)
+                        return p + i;
+                    m &= m - 1;
+                }
+            }
+            return findSse2(p, last, pattern, len);
+        }
+
+        RT_TARGET_AVX2 const char* skipWsAvx2(const char* first, const char* last)
+        {
+            for (; last - first >= 32; first += 32)
+            {
+                if (const U32 m = ~wsMask(_mm256_loadu_si256((const __m256i*)first)))
+                    return first + Bits::countTrailingZeros(m);
+            }
+            return skipWsSse2(first, last);
+        }
+
+        RT_TARGET_AVX2 const char* skipWsReverseAvx2(const char* first, const char* last)
+        {
+            for (; last - first >= 32; last -= 32)
+            {
+                if (const U32 m = ~wsMask(_mm256_loadu_si256((const __m256i*)(last - 32))))
+                    return last - 32 + (64 - Bits::countLeadingZeros(m));
+            }
+            return skipWsReverseSse2(first, last);
+        }
+
+        RT_TARGET_AVX2 __m256i inRange(const __m256i v, const __m256i lo, const __m256i span)
+        {
+            const __m256i d = _mm256_sub_epi8(v, lo);
+            return _mm256_cmpeq_epi8(_mm256_min_epu8(d, span), d);
+        }
+
+        RT_TARGET_AVX2 char* copyIfAvx2(char*            out,
+                                        const char*      end,
+                                        const char*      first,
+                                        const char*      last,
+                                        const ByteRange* ranges,
+                                        const size_t     count)
+        {
+            __m256i lo[StringScan::MaxRanges], span[StringScan::MaxRanges];
+            for (size_t i = 0; i < count; ++i)
+            {
+                lo[i]   = _mm256_set1_epi8(char(ranges[i].lo));
+                span[i] = _mm256_set1_epi8(char(ranges[i].hi - ranges[i].lo));
+            }
+
+            for (; last - first >= 32 && end - out >= 32; first += 32)
+            {
+                const __m256i v = _mm256_loadu_si256((const __m256i*)first);
+
+                __m256i pass = _mm256_setzero_si256();
+                for (size_t i = 0; i < count; ++i)
+                    pass = _mm256_or_si256(pass, inRange(v, lo[i], span[i]));
+
+                U32 m = U32(_mm256_movemask_epi8(pass));
+                if (m == 0xFFFFFFFF)
+                {
+                    _mm256_storeu_si256((__m256i*)out, v);
+                    out += 32;
+                }
+                else
+                {
+                    for (; m; m &= m - 1)
+                        *out++ = first[Bits::countTrailingZeros(m)];
+                }
+            }
+            return copyIfSse2(out, end, first, last, ranges, count);
+        }
+
+        RT_TARGET_AVX2 void flipCaseAvx2(char* dest, const char* first, const char* last, const char base)
+        {
+            const __m256i lo   = _mm256_set1_epi8(base);
+            const __m256i span = _mm256_set1_epi8(25);
+            const __m256i flip = _mm256_set1_epi8(0x20);
+            for (; last - first >= 32; first += 32, dest += 32)
+            {
+                const __m256i v = _mm256_loadu_si256((const __m256i*)first);
+                _mm256_storeu_si256((__m256i*)dest,
+                                    _mm256_xor_si256(v, _mm256_and_si256(inRange(v, lo, span), flip)));
+            }
+            flipCaseSse2(dest, first, last, base);
+        }
+
+        RT_TARGET_AVX2 const char* findControlAvx2(const char* first, const char* last)
+        {
+            const __m256i space = _mm256_set1_epi8(' ');
+            for (; last - first >= 32; first += 32)
+            {
+                const __m256i v = _mm256_loadu_si256((const __m256i*)first);
+                if (const U32 m = U32(_mm256_movemask_epi8(_mm256_cmpgt_epi8(space, v))))
+                    return first + Bits::countTrailingZeros(m);
+            }
+            return findControlSse2(first, last);
+        }
+#endif
+
+        void flipCase(char* dest, const char* first, const char* last, const char base)
+        {
+            if (!dest || !first || first >= last)
+                return;
+
+#if RT_ARCH_X64
+            switch (Cpu::level())
+            {
+            case SIMD_AVX2:
+                flipCaseAvx2(dest, first, last, base);
+                return;
+            case SIMD_SSE42:
+            case SIMD_SSE2:
+                flipCaseSse2(dest, first, last, base);
+                return;
+            default:
+                break;
+            }
+#endif
+            flipCaseScalar(dest, first, last, base);
+        }
+    }  // namespace
+
+    const char* StringScan::find(const char* first, const char* last, const char ch)
+    {
+        if (!first || first >= last)
+            return last;
+
+#if RT_ARCH_X64
+        switch (Cpu::level())
+        {
+        case SIMD_AVX2:
+            return findAvx2(first, last, ch);
+        case SIMD_SSE42:
+        case SIMD_SSE2:
+            return findSse2(first, last, ch);
+        default:
+            break;
+        }
+#endif
+        return findScalar(first, last, ch);
+    }
+
+    const char* StringScan::find(const char*  first,
+                                 const char*  last,
+                                 const char*  pattern,
+                                 const size_t len)
+    {
+        if (len == 0)
+            return first;
+        if (!first || first >= last || size_t(last - first) < len)
+            return last;
+        if (len == 1)
+            return find(first, last, pattern[0]);
+
+#if RT_ARCH_X64
+        switch (Cpu::level())
+        {
+        case SIMD_AVX2:
+            return findAvx2(first, last, pattern, len);
+        case SIMD_SSE42:
+        case SIMD_SSE2:
+            return findSse2(first, last, pattern, len);
+        default:
+            break;
+        }
+#endif
+        return findScalar(first, last, pattern, len);
+    }
+
+    const char* StringScan::skipWs(const char* first, const char* last)
+    {
+        if (!first || first >= last)
+            return last;
+
+#if RT_ARCH_X64
+        switch (Cpu::level())
+        {
+        case SIMD_AVX2:
+            return skipWsAvx2(first, last);
+        case SIMD_SSE42:
+        case SIMD_SSE2:
+            return skipWsSse2(first, last);
+        default:
+            break;
+        }
+#endif
+        return skipWsScalar(first, last);
+    }
+
+    const char* StringScan::skipWsReverse(const char* first, const char* last)
+    {
+        if (!first || first >= last)
+            return first;
+
+#if RT_ARCH_X64
+        switch (Cpu::level())
+        {
+        case SIMD_AVX2:
+            return skipWsReverseAvx2(first, last);
+        case SIMD_SSE42:
+        case SIMD_SSE2:
+            return skipWsReverseSse2(first, last);
+        default:
+            break;
+        }
+#endif
+        return skipWsReverseScalar(first, last);
+    }
+
+    const char* StringScan::findControl(const char* first, const char* last)
+    {
+        if (!first || first >= last)
+            return last;
+
+#if RT_ARCH_X64
+        switch (Cpu::level())
+        {
+        case SIMD_AVX2:
+            return findControlAvx2(first, last);
+        case SIMD_SSE42:
+        case SIMD_SSE2:
+            return findControlSse2(first, last);
+        default:
+            break;
+        }
+#endif
+        return findControlScalar(first, last);
+    }
+
+    size_t StringScan::copyIf(char*            dest,
+                              const char*      first,
+                              const char*      last,
+                              const ByteRange* ranges,
+                              const size_t     count,
+                              const size_t     max)
+    {
+        RT_ASSERT(count <= MaxRanges)
+        if (!dest || !first || first >= last || max == 0)
+            return 0;
+
+        // max may be Npos, or any other no-limit value.
+        const char* end = dest + Min<size_t>(max, size_t(last - first));
+
+        char* out;
+#if RT_ARCH_X64
+        switch (Cpu::level())
+        {
+        case SIMD_AVX2:
+            out = copyIfAvx2(dest, end, first, last, ranges, count);
+            break;
+        case SIMD_SSE42:
+        case SIMD_SSE2:
+            out = copyIfSse2(dest, end, first, last, ranges, count);
+            break;
+        default:
+            out = copyIfScalar(dest, end, first, last, ranges, count);
+            break;
+        }
+#else
+        out = copyIfScalar(dest, end, first, last, ranges, count);
+#endif
+        return size_t(out - dest);
+    }
+
+    void StringScan::toLower(char* dest, const char* first, const char* last)
+    {
+        flipCase(dest, first, last, 'A');
+    }
+
+    void StringScan::toUpper(char* dest, const char* first, const char* last)
+    {
+        flipCase(dest, first, last, 'a');
+    }
+
+}  // namespace Rt2
@@ -0,0 +1,112 @@
+/*
+-------------------------------------------------------------------------------
+    Copyright (c) Charles Carley.
+
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+-------------------------------------------------------------------------------
+*/
+#pragma once
+
+#include "Utils/Definitions.h"
+
+namespace Rt2
+{
+    /**
+     * \brief An inclusive range of byte values.
+     */
+    struct ByteRange
+    {
+        U8 lo;
+        U8 hi;
+    };
+
+    /**
+     * \brief Byte search and transform kernels over [first, last)
+     * for the string utilities.
+     *
+     * Each function picks an AVX2 or SSE2 version with Cpu::level and
+     * falls back to plain loops elsewhere. White space here means
+     * ' ', '\t', '\r' and '\n', which is the set isWs accepts.
+     */
+    class StringScan
+    {
+    public:
+        static constexpr size_t MaxRanges = 8;
+
+        /**
+         * \return The first ch in [first, last), or last if there is none.
+         */
+        static const char* find(const char* first, const char* last, char ch);
+
+        /**
+         * \return The start of the first occurrence of the pattern
+         * in [first, last), or last if there is none. An empty pattern
+         * matches at first.
+         */
+        static const char* find(const char* first,
+                                const char* last,
+                                const char* pattern,
+                                size_t      len);
+
+        /**
+         * \return The first character that is not white space, or last.
+         */
+        static const char* skipWs(const char* first, const char* last);
+
+        /**
+         * \return One past the last character that is not white space,
+         * or first if every character is white space.
+         */
+        static const char* skipWsReverse(const char* first, const char* last);
+
+        /**
+         * \return The first character outside of the printable range
+         * [32, 127], or last. Tabs and line endings count as control
+         * characters here.
+         */
+        static const char* findControl(const char* first, const char* last);
+
+        /**
+         * \brief Copies the bytes that fall in any of the ranges to dest,
+         * stopping once max bytes have been written.
+         *
+         * Blocks where every byte passes are copied whole. dest may be
+         * first, since it never gets ahead of the read position.
+         * \param count The number of ranges, at most MaxRanges.
+         * \return The number of bytes written.
+         */
+        static size_t copyIf(char*            dest,
+                             const char*      first,
+                             const char*      last,
+                             const ByteRange* ranges,
+                             size_t           count,
+                             size_t           max);
+
+        /**
+         * \brief Writes [first, last) to dest with A-Z mapped to a-z.
+         * dest may be first.
+         */
+        static void toLower(char* dest, const char* first, const char* last);
+
+        /**
+         * \brief Writes [first, last) to dest with a-z mapped to A-Z.
+         * dest may be first.
+         */
+        static void toUpper(char* dest, const char* first, const char* last);
+    };
+
+}  // namespace Rt2
@@ -0,0 +1,102 @@
+/*
+-------------------------------------------------------------------------------
+    Copyright (c) Charles Carley.
+
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+-------------------------------------------------------------------------------
+*/
+#include "Utils/StringTable.h"
+#include "Utils/Exception.h"
+
+namespace Rt2
+{
+    StringTable::StringTable(const std::initializer_list<StringView> strings)
+    {
+        size_t total = 0;
+        for (const StringView& str : strings)
+            total += str.size();
+
+        reserve((U32)strings.size(), total);
+        for (const StringView& str : strings)
+            append(str);
+    }
+
+    StringTable::StringTable(const StringArray& strings)
+    {
+        size_t total = 0;
+        for (const String& str : strings)
+            total += str.size();
+
+        reserve((U32)strings.size(), total);
+        for (const String& str : strings)
+            append(str);
+    }
+
+    U32 StringTable::append(const StringView& str)
+    {
+        const size_t offset = _bytes.size();
+        if (offset + str.size() > Npos32)
+            throw Exception("string table is limited to 4GB");
+
+        _bytes.append(str.data(), str.size());
+        _entries.push_back({(U32)offset, (U32)str.size()});
+        return _entries.size() - 1;
+    }
+
+    void StringTable::reserve(const U32 count, const size_t bytes)
+    {
+        _entries.reserve(count);
+        _bytes.reserve(bytes);
+    }
+
+    void StringTable::sort()
+    {
+        sort([](const StringView& a, const StringView& b)
+             { return a < b; });
+    }
+
+    void StringTable::moveTo(StringArray& dest)
+    {
+        dest.reserve(dest.size() + size());
+        for (const StringView str : *this)
+            dest.emplace_back(str);
+        clear();
+    }
+
+    StringArray StringTable::toArray() const
+    {
+        StringArray dest;
+        dest.reserve(size());
+        for (const StringView str : *this)
+            dest.emplace_back(str);
+        return dest;
+    }
+
+    StringView StringTable::at(const U32 idx) const
+    {
+        if (idx >= size())
+            throw Exception("array index out of bounds");
+        return (*this)[idx];
+    }
+
+    void StringTable::clear()
+    {
+        _bytes.clear();
+        _entries.clear();
+    }
+
+}  // namespace Rt2
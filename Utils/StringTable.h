@@ -0,0 +1,235 @@
+/*
+-------------------------------------------------------------------------------
+    Copyright (c) Charles Carley.
+
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+-------------------------------------------------------------------------------
+*/
+#pragma once
+
+#include <algorithm>
+#include <initializer_list>
+#include <iterator>
+#include "Utils/Array.h"
+#include "Utils/String.h"
+
+namespace Rt2
+{
+    /**
+     * \brief A list of strings packed into one contiguous buffer.
+     *
+     * Each string is an offset and a length into the buffer, so appending
+     * does not allocate per string and the whole table is two allocations.
+     * The views returned by operator[] are invalidated by append, since
+     * the buffer may move as it grows.
+     */
+    class StringTable
+    {
+    private:
+        struct Entry
+        {
+            U32 offset;
+            U32 size;
+        };
+
+        using Entries = SimpleArray<Entry>;
+
+        String  _bytes;
+        Entries _entries;
+
+    public:
+        class Iterator
+        {
+        private:
+            const StringTable* _table{nullptr};
+            U32                _index{0};
+
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type        = StringView;
+            using difference_type   = std::ptrdiff_t;
+            using pointer           = const StringView*;
+            using reference         = StringView;
+
+            Iterator() = default;
+
+            Iterator(const StringTable* table, const U32 index) :
+                _table(table),
+                _index(index)
+            {
+            }
+
+            StringView operator*() const
+            {
+                return (*_table)[_index];
+            }
+
+            Iterator& operator++()
+            {
+                ++_index;
+                return *this;
+            }
+
+            Iterator operator++(int)
+            {
+                Iterator copy = *this;
+                ++_index;
+                return copy;
+            }
+
+            bool operator==(const Iterator& rhs) const
+            {
+                return _table == rhs._table && _index == rhs._index;
+            }
+
+            bool operator!=(const Iterator& rhs) const
+            {
+                return !(*this == rhs);
+            }
+        };
+
+    public:
+        StringTable() = default;
+
+        StringTable(std::initializer_list<StringView> strings);
+
+        explicit StringTable(const StringArray& strings);
+
+        /**
+         * \brief Copies the string to the end of the buffer.
+         * \return The index of the string.
+         * \throws Exception if the buffer would pass 4GB.
+         */
+        U32 append(const StringView& str);
+
+        /**
+         * \brief Appends [first, last), so the table can
+         * be filled like the standard containers.
+         */
+        void emplace_back(const char* first, const char* last);
+
+        /**
+         * \brief Reserves room for count strings holding a total of bytes.
+         */
+        void reserve(U32 count, size_t bytes);
+
+        /**
+         * \brief Sorts the strings by value. Only the offsets
+         * move, the bytes stay where they are.
+         */
+        void sort();
+
+        /**
+         * \brief Sorts the strings with compare(StringView, StringView).
+         */
+        template <typename Compare>
+        void sort(Compare compare);
+
+        /**
+         * \brief Appends every string to dest and clears the table.
+         */
+        void moveTo(StringArray& dest);
+
+        StringArray toArray() const;
+
+        StringView operator[](U32 idx) const;
+
+        /**
+         * \throws Exception if the index is out of range.
+         */
+        StringView at(U32 idx) const;
+
+        StringView front() const;
+
+        StringView back() const;
+
+        U32 size() const;
+
+        bool empty() const;
+
+        /**
+         * \return The number of string bytes in the buffer.
+         */
+        size_t bytes() const;
+
+        void clear();
+
+        Iterator begin() const;
+
+        Iterator end() const;
+    };
+
+    inline StringView StringTable::operator[](const U32 idx) const
+    {
+        const Entry& entry = _entries[idx];
+        return {_bytes.data() + entry.offset, entry.size};
+    }
+
+    inline void StringTable::emplace_back(const char* first, const char* last)
+    {
+        append(StringView(first, size_t(last - first)));
+    }
+
+    inline StringView StringTable::front() const
+    {
+        return (*this)[0];
+    }
+
+    inline StringView StringTable::back() const
+    {
+        return (*this)[size() - 1];
+    }
+
+    inline U32 StringTable::size() const
+    {
+        return _entries.size();
+    }
+
+    inline bool StringTable::empty() const
+    {
+        return _entries.empty();
+    }
+
+    inline size_t StringTable::bytes() const
+    {
+        return _bytes.size();
+    }
+
+    inline StringTable::Iterator StringTable::begin() const
+    {
+        return {this, 0};
+    }
+
+    inline StringTable::Iterator StringTable::end() const
+    {
+        return {this, size()};
+    }
+
+    template <typename Compare>
+    void StringTable::sort(Compare compare)
+    {
+        const char* base = _bytes.data();
+        std::sort(_entries.begin(),
+                  _entries.end(),
+                  [base, &compare](const Entry& a, const Entry& b)
+                  {
+                      return compare(StringView(base + a.offset, a.size),
+                                     StringView(base + b.offset, b.size));
+                  });
+    }
+
+}  // namespace Rt2
@@ -21,11 +21,433 @@
 */
 #include "Utils/SymbolStream.h"
 #include <cmath>
-#include "TextStreamWriter.h"
+#include <cstring>
+#include "Utils/Bits.h"
+#include "Utils/Exception.h"
 #include "Utils/String.h"
 
 namespace Rt2
 {
+    namespace
+    {
+        using Limbs = SimpleArray<U32>;
+
+        constexpr size_t ReadBlock    = 0x1000;
+        constexpr U32    MaxGroupSize = 256;
+
+        // Numbers of up to this many limbs are converted by repeated
+        // division. Past it the divide and conquer split is faster.
+        constexpr U32 SplitLimbs = 40;
+
+        // Products with an operand shorter than this use the
+        // schoolbook method rather than Karatsuba's.
+        constexpr U32 KaratsubaLimbs = 32;
+
+        // Reciprocals of up to this many limbs are found by long
+        // division rather than by Newton's iteration.
+        constexpr U32 NewtonLimbs = 32;
+
+        // Powers shorter than this are divided by long division. Past
+        // it two Karatsuba products beat the quadratic division.
+        constexpr U32 BarrettLimbs = 256;
+
+        U32 trimmed(const U32* a, U32 n)
+        {
+            while (n > 0 && a[n - 1] == 0)
+                --n;
+            return n;
+        }
+
+        void trim(Limbs& a)
+        {
+            a.resizeFast(trimmed(a.data(), a.size()));
+        }
+
+        void zero(Limbs& a, const U32 n)
+        {
+            a.resizeFast(n);
+            memset(a.data(), 0, sizeof(U32) * n);
+        }
+
+        // Both numbers must be trimmed.
+        int compare(const U32* a, const U32 na, const U32* b, const U32 nb)
+        {
+            if (na != nb)
+                return na < nb ? -1 : 1;
+            for (U32 i = na; i-- > 0;)
+            {
+                if (a[i] != b[i])
+                    return a[i] < b[i] ? -1 : 1;
+            }
+            return 0;
+        }
+
+        // Adds the n limbs of b into the rn limbs of r.
+        void addTo(U32* r, const U32 rn, const U32* b, const U32 n)
+        {
+            U64 carry = 0;
+            U32 i     = 0;
+            for (; i < n; ++i)
+            {
+                carry += U64(r[i]) + b[i];
+                r[i] = U32(carry);
+                carry >>= 32;
+            }
+            for (; carry && i < rn; ++i)
+            {
+                carry += r[i];
+                r[i] = U32(carry);
+                carry >>= 32;
+            }
+        }
+
+        // Subtracts the n limbs of b from the rn limbs of r, which must not be less.
+        void subtractFrom(U32* r, const U32 rn, const U32* b, const U32 n)
+        {
+            U64 borrow = 0;
+            U32 i      = 0;
+            for (; i < n; ++i)
+            {
+                const U64 t = U64(r[i]) - b[i] - borrow;
+
+                r[i]   = U32(t);
+                borrow = t >> 63;
+            }
+            for (; borrow && i < rn; ++i)
+            {
+                const U64 t = U64(r[i]) - borrow;
+
+                r[i]   = U32(t);
+                borrow = t >> 63;
+            }
+        }
+
+        // Divides a by d in place and returns the remainder.
+        U32 divide(U32* a, const U32 n, const U32 d)
+        {
+            U64 r = 0;
+            for (U32 i = n; i-- > 0;)
+            {
+                const U64 cur = r << 32 | a[i];
+
+                a[i] = U32(cur / d);
+                r    = cur % d;
+            }
+            return U32(r);
+        }
+
+        // r must be na + nb limbs and zeroed.
+        void multiplyBasic(U32* r, const U32* a, const U32 na, const U32* b, const U32 nb)
+        {
+            for (U32 i = 0; i < na; ++i)
+            {
+                U64 carry = 0;
+                for (U32 j = 0; j < nb; ++j)
+                {
+                    const U64 t = U64(a[i]) * b[j] + r[i + j] + carry;
+
+                    r[i + j] = U32(t);
+                    carry    = t >> 32;
+                }
+                r[i + nb] = U32(carry);
+            }
+        }
+
+        // r receives the 2n limbs of a * b.
+        void karatsuba(U32* r, const U32* a, const U32* b, const U32 n)
+        {
+            if (n < KaratsubaLimbs)
+            {
+                memset(r, 0, sizeof(U32) * n * 2);
+                multiplyBasic(r, a, n, b, n);
+                return;
+            }
+
+            // a = a1 B^h + a0 and b = b1 B^h + b0, the middle term
+            // is (a0 + a1)(b0 + b1) - a0 b0 - a1 b1.
+            const U32 h = n >> 1, m = n - h;
+            karatsuba(r, a, b, h);
+            karatsuba(r + 2 * h, a + h, b + h, m);
+
+            Limbs t;
+            zero(t, 4 * (m + 1));
+
+            U32* sa  = t.data();
+            U32* sb  = sa + m + 1;
+            U32* mid = sb + m + 1;
+            memcpy(sa, a + h, sizeof(U32) * m);
+            memcpy(sb, b + h, sizeof(U32) * m);
+            addTo(sa, m + 1, a, h);
+            addTo(sb, m + 1, b, h);
+
+            karatsuba(mid, sa, sb, m + 1);
+            subtractFrom(mid, 2 * m + 2, r, 2 * h);
+            subtractFrom(mid, 2 * m + 2, r + 2 * h, 2 * m);
+            addTo(r + h, 2 * n - h, mid, trimmed(mid, 2 * m + 2));
+        }
+
+        // r receives the na + nb limbs of a * b.
+        void multiply(U32* r, const U32* a, U32 na, const U32* b, U32 nb)
+        {
+            if (na < nb)
+            {
+                std::swap(a, b);
+                std::swap(na, nb);
+            }
+            if (nb < KaratsubaLimbs)
+            {
+                memset(r, 0, sizeof(U32) * (na + nb));
+                multiplyBasic(r, a, na, b, nb);
+                return;
+            }
+            if (na == nb)
+            {
+                karatsuba(r, a, b, na);
+                return;
+            }
+
+            // Unbalanced, multiply b by slices of a that are as long as b.
+            memset(r, 0, sizeof(U32) * (na + nb));
+
+            Limbs t;
+            t.resizeFast(nb * 2);
+            for (U32 i = 0; i < na; i += nb)
+            {
+                const U32 len = Min(nb, na - i);
+                multiply(t.data(), a + i, len, b, nb);
+                addTo(r + i, na + nb - i, t.data(), len + nb);
+            }
+        }
+
+        void multiply(Limbs& r, const U32* a, const U32 na, const U32* b, const U32 nb)
+        {
+            if (na == 0 || nb == 0)
+            {
+                r.resizeFast(0);
+                return;
+            }
+            r.resizeFast(na + nb);
+            multiply(r.data(), a, na, b, nb);
+            trim(r);
+        }
+
+        // Long division of the m limbs of u by the n limbs of v, Knuth's
+        // algorithm D. Requires m >= n >= 2 and a non-zero top limb in v.
+        // q receives m - n + 1 limbs and r receives n limbs.
+        void divide(U32* q, U32* r, const U32* u, const U32 m, const U32* v, const U32 n)
+        {
+            Limbs un, vn;
+            un.resizeFast(m + 1);
+            vn.resizeFast(n);
+
+            // Normalize so that the top bit of the divisor is set.
+            const int s = Bits::countLeadingZeros(v[n - 1]) - 32;
+
+            for (U32 i = n - 1; i > 0; --i)
+                vn[i] = U32((U64(v[i]) << 32 | v[i - 1]) >> (32 - s));
+            vn[0] = v[0] << s;
+
+            un[m] = U32(U64(u[m - 1]) >> (32 - s));
+            for (U32 i = m - 1; i > 0; --i)
+                un[i] = U32((U64(u[i]) << 32 | u[i - 1]) >> (32 - s));
+            un[0] = u[0] << s;
+
+            const U64 top  = vn[n - 1];
+            const U64 next = vn[n - 2];
+
+            for (U32 j = m - n + 1; j-- > 0;)
+            {
+                const U64 num  = U64(un[j + n]) << 32 | un[j + n - 1];
+                U64       qhat = num / top;
+                U64       rhat = num % top;
+
+                while (qhat >> 32 || qhat * next > (rhat << 32 | un[j + n - 2]))
+                {
+                    --qhat;
+                    rhat += top;
+                    if (rhat >> 32)
+                        break;
+                }
+
+                // Multiply and subtract.
+                I64 borrow = 0, t;
+                for (U32 i = 0; i < n; ++i)
+                {
+                    const U64 p = qhat * vn[i];
+
+                    t         = I64(un[i + j]) - borrow - I64(p & 0xFFFFFFFF);
+                    un[i + j] = U32(t);
+                    borrow    = I64(p >> 32) - (t >> 32);
+                }
+                t         = I64(un[j + n]) - borrow;
+                un[j + n] = U32(t);
+
+                q[j] = U32(qhat);
+                if (t < 0)
+                {
+                    // Subtracted too much, add one divisor back.
+                    --q[j];
+                    U64 carry = 0;
+                    for (U32 i = 0; i < n; ++i)
+                    {
+                        carry += U64(un[i + j]) + vn[i];
+                        un[i + j] = U32(carry);
+                        carry >>= 32;
+                    }
+                    un[j + n] += U32(carry);
+                }
+            }
+
+            for (U32 i = 0; i < n; ++i)
+                r[i] = U32((U64(un[i + 1]) << 32 | un[i]) >> s);
+        }
+
+        // The trimmed quotient and remainder of a by the k limbs of p.
+        void divide(Limbs& q, Limbs& r, const U32* a, const U32 na, const U32* p, const U32 k)
+        {
+            if (na < k)
+            {
+                q.resizeFast(0);
+                r.resizeFast(na);
+                memcpy(r.data(), a, sizeof(U32) * na);
+                return;
+            }
+
+            q.resizeFast(na - k + 1);
+            if (k == 1)
+            {
+                memcpy(q.data(), a, sizeof(U32) * na);
+                r.resizeFast(1);
+                r[0] = divide(q.data(), na, p[0]);
+            }
+            else
+            {
+                r.resizeFast(k);
+                divide(q.data(), r.data(), a, na, p, k);
+            }
+            trim(q);
+            trim(r);
+        }
+
+        // Barrett's reduction of a by the k limbs of p, where x is floor(B^2k / p).
+        // Requires a < B^2k, so that the estimated quotient is at most two low.
+        void divide(Limbs& q, Limbs& r, const U32* a, const U32 n, const U32* p, const U32 k, const U32* x, const U32 xn)
+        {
+            Limbs t;
+            multiply(t, a + (k - 1), n - k + 1, x, xn);
+            if (t.size() > k + 1)
+            {
+                zero(q, t.size() - k);
+                memcpy(q.data(), t.data() + k + 1, sizeof(U32) * (t.size() - k - 1));
+            }
+            else
+                zero(q, 1);
+
+            multiply(t, q.data(), trimmed(q.data(), q.size()), p, k);
+            r.resizeFast(n);
+            memcpy(r.data(), a, sizeof(U32) * n);
+            subtractFrom(r.data(), n, t.data(), t.size());
+            trim(r);
+
+            const U32 one = 1;
+            while (compare(r.data(), r.size(), p, k) >= 0)
+            {
+                subtractFrom(r.data(), r.size(), p, k);
+                trim(r);
+                addTo(q.data(), q.size(), &one, 1);
+            }
+            trim(q);
+        }
+
+        // x receives floor(B^2k / p), where B is 2^32 and p
+        // has k limbs with a non-zero top limb.
+        void reciprocal(Limbs& x, const U32* p, const U32 k)
+        {
+            Limbs t, u;
+            if (k <= NewtonLimbs)
+            {
+                zero(t, 2 * k + 1);
+                t[2 * k] = 1;
+                divide(x, u, t.data(), t.size(), p, k);
+                return;
+            }
+
+            // Start from the reciprocal of the top h limbs. Its error is
+            // about B^(1-h) relative, which one Newton step squares.
+            const U32 h = (k >> 1) + 1;
+
+            Limbs y;
+            reciprocal(y, p + (k - h), h);
+
+            // x0 = y B^(k-h) and e = B^2k - p x0 = (B^(k+h) - p y) B^(k-h),
+            // so that x1 = x0 + x0 e / B^2k = y B^(k-h) + y (B^(k+h) - p y) / B^2h.
+            multiply(t, p, k, y.data(), y.size());
+
+            const U32 top  = k + h;
+            const bool over = t.size() > top;
+            if (over)
+            {
+                const U32 one = 1;
+                subtractFrom(t.data() + top, t.size() - top, &one, 1);
+                trim(t);
+            }
+            else
+            {
+                zero(u, top + 1);
+                u[top] = 1;
+                subtractFrom(u.data(), u.size(), t.data(), t.size());
+                trim(u);
+            }
+
+            const Limbs& e = over ? t : u;
+
+            Limbs ye;
+            multiply(ye, y.data(), y.size(), e.data(), e.size());
+
+            zero(x, k - h + y.size() + 1);
+            memcpy(x.data() + (k - h), y.data(), sizeof(U32) * y.size());
+            if (ye.size() > 2 * h)
+            {
+                if (over)
+                    subtractFrom(x.data(), x.size(), ye.data() + 2 * h, ye.size() - 2 * h);
+                else
+                    addTo(x.data(), x.size(), ye.data() + 2 * h, ye.size() - 2 * h);
+            }
+            trim(x);
+
+            // The estimate is within a few units, settle it
+            // with a division that has a short quotient.
+            Limbs q, r;
+            multiply(t, p, k, x.data(), x.size());
+            if (t.size() <= 2 * k)
+            {
+                zero(u, 2 * k + 1);
+                u[2 * k] = 1;
+                subtractFrom(u.data(), u.size(), t.data(), t.size());
+                trim(u);
+
+                divide(q, r, u.data(), u.size(), p, k);
+                x.push_back(0);
+                addTo(x.data(), x.size(), q.data(), q.size());
+            }
+            else
+            {
+                const U32 one = 1;
+                subtractFrom(t.data() + 2 * k, t.size() - 2 * k, &one, 1);
+                trim(t);
+
+                divide(q, r, t.data(), t.size(), p, k);
+                if (!r.empty())
+                {
+                    q.push_back(0);
+                    addTo(q.data(), q.size(), &one, 1);
+                }
+                subtractFrom(x.data(), x.size(), q.data(), trimmed(q.data(), q.size()));
+            }
+            trim(x);
+        }
+    }  // namespace
+
     SymbolStream::SymbolStream(const SymbolArray& symbols) :
         _symbols(symbols)
     {
@@ -51,103 +473,151 @@ namespace Rt2
             _symbols.push_back(ch);
     }
 
-    void SymbolStream::base(OStream& dest, uint64_t v)
+    void SymbolStream::base(OStream& dest, const uint64_t v)
     {
-        _scratch.resizeFast(0);
-        uint64_t q, r;
-        uint32_t idx;
+        char         buf[FormatMax];
+        const size_t len = format(buf, v);
+        dest.write(buf, (std::streamsize)len);
+    }
 
-        if (_base < 2)
-            return;
+    void SymbolStream::base(String& dest, const uint64_t v)
+    {
+        char buf[FormatMax];
+        dest.assign(buf, format(buf, v));
+    }
 
-        if (v == 0)
+    void SymbolStream::base(OStream& dest, IStream& in)
+    {
+        char   buf[ReadBlock];
+        String block;
+        while (in.read(buf, ReadBlock), in.gcount() > 0)
         {
-            r = 0;
-            if (_shift > 0)
-            {
-                r += _shift;
-                r %= _base;
-            }
-            idx = r % _symbols.size();
-            _scratch.push_back(_symbols.at(idx));
+            block.clear();
+            append(block, buf, (size_t)in.gcount());
+            dest.write(block.data(), (std::streamsize)block.size());
         }
+    }
+
+    void SymbolStream::base(String& dest, IStream& in)
+    {
+        char buf[ReadBlock];
+        dest.clear();
+        while (in.read(buf, ReadBlock), in.gcount() > 0)
+            append(dest, buf, (size_t)in.gcount());
+    }
+
+    void SymbolStream::base(String& dest, const String& in)
+    {
+        dest.clear();
+        append(dest, in.data(), in.size());
+    }
+
+    size_t SymbolStream::format(char* dest, uint64_t v)
+    {
+        if (_base < 2 || _symbols.empty())
+            return 0;
+        prepare();
+
+        char  buf[FormatMax];
+        char* end = buf + FormatMax;
+        char* p;
+
+        if (_fast)
+            p = emit(end, U64(v));
         else
         {
-            while (v > 0)
+            // Digits without a symbol are dropped.
+            p = end;
+            do
             {
-                q = v / _base;
-                r = v % _base;
-
-                if (r < (uint64_t)_symbols.size())
-                {
-                    if (_shift > 0)
-                    {
-                        r += _shift;
-                        r %= _base;
-                    }
-                    idx = r % _symbols.size();
-                    _scratch.push_back(_symbols.at(idx));
-                }
-                v = q;
-            }
+                if (const uint64_t r = v % _base; r < _digits.size())
+                    *--p = _digits[(U32)r];
+                v /= _base;
+            } while (v > 0);
         }
 
         if (_pad)
         {
-            while (_scratch.size() < charsPerBase())
-            {
-                r = 0;
-                if (_shift > 0)
-                {
-                    r += _shift;
-                    r %= _base;
-                }
-                idx = r % _symbols.size();
-                _scratch.push_back(_symbols.at(idx));
-            }
+            const size_t cpb = charsPerBase();
+            while (size_t(end - p) < cpb)
+                *--p = _digits[0];
         }
+
+        char* out = dest;
         if (_ws)
         {
-            r = Max<int>(0, (int)charsPerBase() - (int)_scratch.size());
-            for (q = 0; q < r; ++q)
-                Ts::print(dest, ' ');
-            Ts::print(dest, ' ');
+            const int r = Max<int>(0, (int)charsPerBase() - int(end - p)) + 1;
+            memset(out, ' ', r);
+            out += r;
         }
-
-        for (int i = _scratch.sizeI() - 1; i >= 0; --i)
-            Ts::print(dest, _scratch[i]);
+        memcpy(out, p, end - p);
+        return size_t(out - dest) + size_t(end - p);
     }
 
-    void SymbolStream::base(String& dest, uint64_t v)
+    void SymbolStream::number(OStream& dest, const void* data, const size_t len)
     {
-        OutputStringStream oss;
-        base(oss, v);
-        dest = oss.str();
+        String str;
+        number(str, data, len);
+        dest.write(str.data(), (std::streamsize)str.size());
     }
 
-    void SymbolStream::base(OStream& dest, IStream& in)
+    void SymbolStream::number(String& dest, const void* data, const size_t len)
     {
-        char ch;
-        while (!in.read(&ch, 1).eof())
+        dest.clear();
+        if (_base < 2 || _symbols.empty())
+            return;
+
+        prepare();
+        if (!_fast)
+            throw Exception("the base has more digits than there are symbols");
+
+        const U8* src = (const U8*)data;
+
+        size_t i = 0;
+        while (i < len && src[i] == 0)
+            ++i;
+        if (i == len)
         {
-            if (ch > 0)
-                base(dest, (uint64_t)ch);
+            dest.push_back(_digits[0]);
+            return;
         }
+
+        const size_t bytes = len - i;
+        if (bytes > size_t(0xFFFFFFFF) * 4)
+            throw Exception("number conversion is limited to 16GB");
+
+        Limbs limbs;
+        zero(limbs, U32((bytes + 3) >> 2));
+
+        U32* a = limbs.data();
+        for (size_t j = 0; j < bytes; ++j)
+            a[j >> 2] |= U32(src[len - 1 - j]) << ((j & 3) << 3);
+
+        if (_log2 > 0)
+            convertBits(dest, a, limbs.size());
+        else
+            convert(dest, a, limbs.size(), 0);
     }
 
-    void SymbolStream::base(String& dest, IStream& in)
+    void SymbolStream::number(String& dest, const String& in)
     {
-        OutputStringStream oss;
-        base(oss, in);
-        dest = oss.str();
+        number(dest, in.data(), in.size());
     }
 
-    void SymbolStream::base(String& dest, const String& in)
+    void SymbolStream::number(OStream& dest, IStream& in)
     {
-        InputStringStream  is(in);
-        OutputStringStream oss;
-        base(oss, is);
-        dest = oss.str();
+        String str;
+        number(str, in);
+        dest.write(str.data(), (std::streamsize)str.size());
+    }
+
+    void SymbolStream::number(String& dest, IStream& in)
+    {
+        char   buf[ReadBlock];
+        String data;
+        while (in.read(buf, ReadBlock), in.gcount() > 0)
+            data.append(buf, (size_t)in.gcount());
+        number(dest, data.data(), data.size());
     }
 
     String SymbolStream::toString(const I8 v, const Initializer& sym, const int offs)
@@ -199,18 +669,61 @@ namespace Rt2
         return copy;
     }
 
-    void SymbolStream::toString(String& dest, const U64 v, const Initializer& sym, const int offs)
+    void SymbolStream::toString(String& dest, U64 v, const Initializer& sym, const int offs)
+    {
+        if (sym.size() == 0)
+        {
+            SymbolStream ss(sym);
+            ss.setShift(offs);
+            ss.base(dest, v);
+            return;
+        }
+        if (sym.size() < 2)
+        {
+            dest.clear();
+            return;
+        }
+
+        // One value does not pay for the tables
+        // that a SymbolStream would build.
+        const U64   base    = sym.size();
+        const U64   shift   = (U64)(I64)offs;
+        const char* symbols = sym.begin();
+
+        char  buf[64];
+        char* end = buf + sizeof buf;
+        char* p   = end;
+        do
+        {
+            U64 r = v % base;
+            if (shift > 0)
+                r = (r + shift) % base;
+            *--p = symbols[r];
+            v /= base;
+        } while (v > 0);
+
+        dest.assign(p, end);
+    }
+
+    void SymbolStream::toString(String& dest, const String& v, const Initializer& sym, const int offs)
     {
         SymbolStream ss(sym);
         ss.setShift(offs);
         ss.base(dest, v);
     }
 
-    void SymbolStream::toString(String& dest, const String& v, const Initializer& sym, const int offs)
+    String SymbolStream::toNumber(const String& v, const Initializer& sym, const int offs)
+    {
+        String copy;
+        toNumber(copy, v, sym, offs);
+        return copy;
+    }
+
+    void SymbolStream::toNumber(String& dest, const String& v, const Initializer& sym, const int offs)
     {
         SymbolStream ss(sym);
         ss.setShift(offs);
-        ss.base(dest, v);
+        ss.number(dest, v);
     }
 
     size_t SymbolStream::charsPerBase()
@@ -220,6 +733,365 @@ namespace Rt2
         return _cpb;
     }
 
+    void SymbolStream::prepare()
+    {
+        if (_ready & ReadyDigits)
+            return;
+
+        // Symbols are assigned to digits the same way for every
+        // conversion, so they are resolved once per base and shift.
+        const uint64_t size  = _symbols.size();
+        const uint64_t count = Min(_base, size);
+
+        _digits.resizeFast((U32)count);
+        for (uint64_t r = 0; r < count; ++r)
+        {
+            uint64_t s = r;
+            if (_shift > 0)
+            {
+                s += _shift;
+                s %= _base;
+            }
+            _digits[(U32)r] = _symbols[U32(s % size)];
+        }
+
+        _fast = _base <= size;
+        _log2 = (_base & (_base - 1)) == 0 ? Bits::countTrailingZeros(_base) : 0;
+
+        // The largest powers of the base that fit in 32 and 64 bits. Each
+        // division of a big number by the first yields _wordDigits digits
+        // at once, and the powers that big numbers are split on start
+        // from the second.
+        _wordPower   = 0;
+        _wordDigits  = 0;
+        _blockPower  = 0;
+        _blockDigits = 0;
+        _group       = 1;
+        _groupSize   = 0;
+        _groups.resizeFast(0);
+        _powers.resizeFast(0);
+        _powerOffsets.resizeFast(0);
+        _inverses.resizeFast(0);
+        _inverseOffsets.resizeFast(0);
+
+        if (_fast)
+        {
+            const U32 base = (U32)_base;
+
+            _wordPower  = base;
+            _wordDigits = 1;
+            while (_wordPower <= 0xFFFFFFFF / base)
+            {
+                _wordPower *= base;
+                ++_wordDigits;
+            }
+
+            _blockPower  = base;
+            _blockDigits = 1;
+            while (_blockPower <= 0xFFFFFFFFFFFFFFFF / base)
+            {
+                _blockPower *= base;
+                ++_blockDigits;
+            }
+
+            _groupSize = base;
+            while (_groupSize <= MaxGroupSize / base)
+            {
+                _groupSize *= base;
+                ++_group;
+            }
+
+            if (_group > 1)
+            {
+                _groups.resizeFast(_groupSize * _group);
+                for (U32 v = 0; v < _groupSize; ++v)
+                {
+                    char* end = _groups.data() + (v + 1) * _group;
+                    for (U32 x = v, j = 0; j < _group; ++j, x /= base)
+                        *--end = _digits[x % base];
+                }
+            }
+        }
+        _ready = ReadyDigits;
+    }
+
+    void SymbolStream::prepareBytes()
+    {
+        if (_ready & ReadyBytes)
+            return;
+
+        // Streams convert each byte on its own, so every
+        // output can be looked up rather than computed.
+        char buf[FormatMax];
+
+        _bytes.resizeFast(0);
+        _byteOffsets.resizeFast(0);
+        for (U32 ch = 0; ch < 128; ++ch)
+        {
+            _byteOffsets.push_back(_bytes.size());
+            if (ch > 0)
+            {
+                const size_t len = format(buf, ch);
+                for (size_t i = 0; i < len; ++i)
+                    _bytes.push_back(buf[i]);
+            }
+        }
+        _byteOffsets.push_back(_bytes.size());
+        _ready |= ReadyBytes;
+    }
+
+    char* SymbolStream::emit(char* end, U32 v) const
+    {
+        const char* digits = _digits.data();
+        const char* groups = _groups.data();
+
+        if (_log2 > 0)
+        {
+            if (_group > 1)
+            {
+                const int shift = _log2 * (int)_group;
+                while (v >> shift)
+                {
+                    end -= _group;
+                    memcpy(end, groups + (v & (_groupSize - 1)) * _group, _group);
+                    v >>= shift;
+                }
+            }
+
+            const U32 mask = U32(_base) - 1;
+            do
+            {
+                *--end = digits[v & mask];
+                v >>= _log2;
+            } while (v);
+        }
+        else
+        {
+            if (_group > 1)
+            {
+                while (v >= _groupSize)
+                {
+                    const U32 q = v / _groupSize;
+                    end -= _group;
+                    memcpy(end, groups + (v - q * _groupSize) * _group, _group);
+                    v = q;
+                }
+            }
+
+            const U32 base = U32(_base);
+            do
+            {
+                const U32 q = v / base;
+                *--end      = digits[v - q * base];
+                v           = q;
+            } while (v);
+        }
+        return end;
+    }
+
+    char* SymbolStream::emit(char* end, const U32 v, const U32 width) const
+    {
+        char* p = emit(end, v);
+        while (U32(end - p) < width)
+            *--p = _digits[0];
+        return p;
+    }
+
+    char* SymbolStream::emit(char* end, U64 v) const
+    {
+        // One 64-bit division per word, the digits
+        // of each word are split in 32 bits.
+        while (v > 0xFFFFFFFF)
+        {
+            const U64 q = v / _wordPower;
+            end         = emit(end, U32(v - q * _wordPower), _wordDigits);
+            v           = q;
+        }
+        return emit(end, U32(v));
+    }
+
+    void SymbolStream::append(String& dest, const char* src, const size_t len)
+    {
+        prepareBytes();
+
+        const U32*  offsets = _byteOffsets.data();
+        const char* bytes   = _bytes.data();
+
+        // Characters outside of 1-127 produce no output.
+        size_t total = 0;
+        for (size_t i = 0; i < len; ++i)
+        {
+            if (const U8 ch = (U8)src[i]; ch < 128)
+                total += offsets[ch + 1] - offsets[ch];
+        }
+        if (total == 0)
+            return;
+
+        const size_t at = dest.size();
+        dest.resize(at + total);
+
+        char* out = dest.data() + at;
+        for (size_t i = 0; i < len; ++i)
+        {
+            if (const U8 ch = (U8)src[i]; ch < 128)
+            {
+                const U32 n = offsets[ch + 1] - offsets[ch];
+                memcpy(out, bytes + offsets[ch], n);
+                out += n;
+            }
+        }
+    }
+
+    const U32* SymbolStream::power(const U32 level, U32& size)
+    {
+        // _powers holds _blockPower^(2^i) for each level i, which
+        // is written with exactly _blockDigits << i digits.
+        if (_powerOffsets.empty())
+        {
+            _powerOffsets.push_back(0);
+            _powers.push_back(U32(_blockPower));
+            _powers.push_back(U32(_blockPower >> 32));
+            _powerOffsets.push_back(2);
+        }
+
+        while (_powerOffsets.size() <= level + 1)
+        {
+            const U32 last  = _powerOffsets.size() - 2;
+            const U32 first = _powerOffsets[last];
+            const U32 n     = _powerOffsets[last + 1] - first;
+
+            Limbs sq;
+            multiply(sq, _powers.data() + first, n, _powers.data() + first, n);
+            for (const U32 limb : sq)
+                _powers.push_back(limb);
+            _powerOffsets.push_back(_powers.size());
+        }
+
+        size = _powerOffsets[level + 1] - _powerOffsets[level];
+        return _powers.data() + _powerOffsets[level];
+    }
+
+    const U32* SymbolStream::inverse(const U32 level, U32& size)
+    {
+        // _inverses holds floor(B^2k / p) for the k limbs
+        // of each power, which Barrett's reduction uses.
+        if (_inverseOffsets.empty())
+            _inverseOffsets.push_back(0);
+
+        while (_inverseOffsets.size() <= level + 1)
+        {
+            U32        pn;
+            const U32* p = power(_inverseOffsets.size() - 1, pn);
+
+            Limbs x;
+            reciprocal(x, p, pn);
+            for (const U32 limb : x)
+                _inverses.push_back(limb);
+            _inverseOffsets.push_back(_inverses.size());
+        }
+
+        size = _inverseOffsets[level + 1] - _inverseOffsets[level];
+        return _inverses.data() + _inverseOffsets[level];
+    }
+
+    void SymbolStream::convert(String& dest, const U32* a, U32 n, const U64 width)
+    {
+        n = trimmed(a, n);
+        if (n <= SplitLimbs)
+        {
+            U32 copy[SplitLimbs];
+            if (n > 0)
+                memcpy(copy, a, sizeof(U32) * n);
+            convertWords(dest, copy, n, width);
+            return;
+        }
+
+        // Split on the largest power with fewer limbs than a, then
+        // convert the high and the low halves separately. The low
+        // half is always written with the full width of the power.
+        U32 level = 0, pn;
+        for (;;)
+        {
+            power(level + 1, pn);
+            if (pn >= n)
+                break;
+            ++level;
+        }
+
+        // Powers up to level + 1 exist, so p stays put while the
+        // inverses are found. a is below B^2pn, as Barrett requires.
+        const U32* p = power(level, pn);
+
+        Limbs q, r;
+        if (pn < BarrettLimbs)
+            divide(q, r, a, n, p, pn);
+        else
+        {
+            U32        xn;
+            const U32* x = inverse(level, xn);
+            divide(q, r, a, n, p, pn, x, xn);
+        }
+
+        const U64 low = U64(_blockDigits) << level;
+        convert(dest, q.data(), q.size(), width > 0 ? width - low : 0);
+        convert(dest, r.data(), r.size(), low);
+    }
+
+    void SymbolStream::convertWords(String& dest, U32* a, U32 n, const U64 width) const
+    {
+        // Schoolbook conversion, every pass over
+        // the limbs produces a word of digits.
+        U32 words[SplitLimbs * 2 + 1];
+        U32 count = 0;
+        while (n > 0)
+        {
+            words[count++] = divide(a, n, _wordPower);
+            while (n > 0 && a[n - 1] == 0)
+                --n;
+        }
+
+        char  buf[(SplitLimbs * 2 + 1) * 32];
+        char* end = buf + sizeof buf;
+        char* p   = end;
+        for (U32 i = 0; i + 1 < count; ++i)
+            p = emit(p, words[i], _wordDigits);
+
+        if (count > 0)
+            p = width > 0 ? emit(p, words[count - 1], _wordDigits) : emit(p, words[count - 1]);
+
+        U64 len = U64(end - p);
+        if (width > len)
+            dest.append(size_t(width - len), _digits[0]);
+        else if (width > 0)
+        {
+            p += len - width;
+            len = width;
+        }
+        dest.append(p, (size_t)len);
+    }
+
+    void SymbolStream::convertBits(String& dest, const U32* a, const U32 n) const
+    {
+        // Each digit is a fixed run of bits, so power of two
+        // bases are converted in a single linear pass.
+        const U64 bits  = U64(n) * 32 - U64(Bits::countLeadingZeros(a[n - 1]) - 32);
+        const U64 count = (bits + _log2 - 1) / _log2;
+        const U32 mask  = U32(_base) - 1;
+
+        const size_t at = dest.size();
+        dest.resize(at + (size_t)count);
+
+        char* out = dest.data() + at + count;
+        for (U64 i = 0, pos = 0; i < count; ++i, pos += _log2)
+        {
+            const U64 w   = pos >> 5;
+            U64       cur = a[w];
+            if (w + 1 < n)
+                cur |= U64(a[w + 1]) << 32;
+            *--out = _digits[U32(cur >> (pos & 31)) & mask];
+        }
+    }
+
     void SymbolStream::makeSymbolDefault()
     {
         _symbols.reserve(96);  // +1
@@ -38,12 +38,40 @@ namespace Rt2
         static constexpr Initializer HexA   = {'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h', 'i', 'j', 'k', 'l', 'm', 'n', 'o', 'p'};
         static constexpr Initializer HexB   = {'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h', 'H', 'G', 'F', 'E', 'D', 'C', 'B', 'A'};
         static constexpr Initializer Base10 = {'0', '1', '2', '3', '4', '5', '6', '7', '8', '9'};
+
+        // The largest output of base(dest, v) for one value.
+        static constexpr size_t FormatMax = 96;
+
     private:
+        enum Ready
+        {
+            ReadyDigits = 0x01,
+            ReadyBytes  = 0x02,
+        };
+
+        using Limbs = SimpleArray<U32>;
+
         uint64_t    _base{10};
         uint64_t    _shift{0};
         uint64_t    _cpb{Npos};
         SymbolArray _symbols;
-        SymbolArray _scratch;
+        SymbolArray _digits;
+        SymbolArray _groups;
+        SymbolArray _bytes;
+        Limbs       _byteOffsets;
+        Limbs       _powers;
+        Limbs       _powerOffsets;
+        Limbs       _inverses;
+        Limbs       _inverseOffsets;
+        U64         _blockPower{0};
+        U32         _blockDigits{0};
+        U32         _wordPower{0};
+        U32         _wordDigits{0};
+        U32         _groupSize{0};
+        U32         _group{0};
+        int         _log2{0};
+        U8          _ready{0};
+        bool        _fast{false};
         bool        _pad{false};
         bool        _ws{false};
 
@@ -62,6 +90,37 @@ namespace Rt2
 
         void base(String& dest, const String& in);
 
+        /**
+         * \brief Writes the symbols for v into dest, which must have
+         * room for FormatMax characters.
+         * \return The number of characters written.
+         */
+        size_t format(char* dest, uint64_t v);
+
+        /**
+         * \brief Converts data as one big-endian unsigned integer.
+         *
+         * Unlike base(dest, in), which converts each byte on its own, this
+         * writes a single number in the current base. Padding and white
+         * space are not applied. Throws if the base has more digits than
+         * there are symbols.
+         */
+        void number(OStream& dest, const void* data, size_t len);
+
+        void number(String& dest, const void* data, size_t len);
+
+        void number(String& dest, const String& in);
+
+        /**
+         * \brief Reads all of in and converts it as one number.
+         *
+         * base(dest, in) keeps its per-byte output; use this when the
+         * stream holds a single big-endian value.
+         */
+        void number(OStream& dest, IStream& in);
+
+        void number(String& dest, IStream& in);
+
         void setBase(int i);
 
         void setPad(bool v);
@@ -94,31 +153,61 @@ namespace Rt2
 
         static void toString(String& dest, const String& v, const Initializer& sym, int offs = 0);
 
+        static String toNumber(const String& v, const Initializer& sym, int offs = 0);
+
+        static void toNumber(String& dest, const String& v, const Initializer& sym, int offs = 0);
+
     private:
         uint64_t charsPerBase();
 
+        void prepare();
+
+        void prepareBytes();
+
+        char* emit(char* end, U32 v) const;
+
+        char* emit(char* end, U32 v, U32 width) const;
+
+        char* emit(char* end, U64 v) const;
+
+        void append(String& dest, const char* src, size_t len);
+
+        const U32* power(U32 level, U32& size);
+
+        const U32* inverse(U32 level, U32& size);
+
+        void convert(String& dest, const U32* a, U32 n, U64 width);
+
+        void convertWords(String& dest, U32* a, U32 n, U64 width) const;
+
+        void convertBits(String& dest, const U32* a, U32 n) const;
+
         void makeSymbolDefault();
     };
 
     inline void SymbolStream::setBase(const int i)
     {
-        _base = i;
-        _cpb  = Npos;
+        _base  = i;
+        _cpb   = Npos;
+        _ready = 0;
     }
 
     inline void SymbolStream::setPad(const bool v)
     {
         _pad = v;
+        _ready &= ~ReadyBytes;
     }
 
     inline void SymbolStream::setWs(const bool v)
     {
         _ws = v;
+        _ready &= ~ReadyBytes;
     }
 
     inline void SymbolStream::setShift(const int offs)
     {
         _shift = offs;
+        _ready = 0;
     }
 
 }  // namespace Rt2
@@ -123,6 +123,26 @@ namespace Rt2
 #endif
     }
 
+    uint64_t Timer::monotonic()
+    {
+#if RT_PLATFORM == RT_PLATFORM_WINDOWS
+        static LARGE_INTEGER freq = {};
+        if (freq.QuadPart == 0)
+            QueryPerformanceFrequency(&freq);
+
+        LARGE_INTEGER now;
+        QueryPerformanceCounter(&now);
+
+        const uint64_t sec = (uint64_t)now.QuadPart / (uint64_t)freq.QuadPart;
+        const uint64_t rem = (uint64_t)now.QuadPart % (uint64_t)freq.QuadPart;
+        return sec * 1000000 + rem * 1000000 / (uint64_t)freq.QuadPart;
+#else
+        timespec now{};
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        return (uint64_t)now.tv_sec * 1000000 + (uint64_t)now.tv_nsec / 1000;
+#endif
+    }
+
     void Timer::sleep(const uint32_t milliseconds)
     {
 #if RT_PLATFORM == RT_PLATFORM_WINDOWS
@@ -80,6 +80,10 @@ namespace Rt2
 
         static uint64_t tickCount();
 
+        // Returns microseconds from a clock that never steps backwards.
+        // The epoch is unspecified, so only differences are meaningful.
+        static uint64_t monotonic();
+
         static void sleep(uint32_t milliseconds);
     };
 
@@ -0,0 +1,305 @@
+/*
+-------------------------------------------------------------------------------
+    Copyright (c) Charles Carley.
+
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+-------------------------------------------------------------------------------
+*/
+#include "Utils/TimerWheel.h"
+#include "Utils/Timer.h"
+
+namespace Rt2
+{
+    namespace
+    {
+        TimerId makeId(const U32 idx, const U32 generation)
+        {
+            return U64(generation) << 32 | idx;
+        }
+
+        U32 levelOf(const U32 slot)
+        {
+            if (slot < TimerWheel::RootSize)
+                return 0;
+            return 1 + (slot - TimerWheel::RootSize) / TimerWheel::LevelSize;
+        }
+    }  // namespace
+
+    TimerWheel::TimerWheel(const U64 resolution) :
+        _resolution(Max<U64>(resolution, 1))
+    {
+        _slots.reserve(SlotCount);
+        _slots.resizeFast(SlotCount);
+        reset(Timer::monotonic());
+    }
+
+    void TimerWheel::reset(const U64 now)
+    {
+        for (U32 i = 0; i < SlotCount; ++i)
+            _slots[i] = Npos32;
+
+        // Keep the generations so that ids handed out
+        // before the reset can not match new timers.
+        _free = Npos32;
+        for (U32 i = _nodes.size(); i > 0; --i)
+        {
+            Node& node = _nodes[i - 1];
+            if (node.active)
+            {
+                node.active = false;
+                if (++node.generation == 0)
+                    node.generation = 1;
+            }
+            node.next = _free;
+            _free     = i - 1;
+        }
+
+        for (U32& level : _levelSize)
+            level = 0;
+
+        _size  = 0;
+        _tick  = 0;
+        _start = now;
+    }
+
+    TimerId TimerWheel::schedule(const U64 delay, const U64 data)
+    {
+        U64 ticks = delay / _resolution;
+        if (ticks * _resolution < delay)
+            ++ticks;
+        if (ticks == 0)
+            ticks = 1;
+
+        const U32 idx = allocate();
+
+        Node& node   = _nodes[idx];
+        node.expires = _tick + ticks;
+        node.data    = data;
+        link(idx);
+        ++_size;
+        return makeId(idx, node.generation);
+    }
+
+    bool TimerWheel::cancel(const TimerId id)
+    {
+        if (!pending(id))
+            return false;
+
+        const U32 idx = (U32)id;
+        unlink(idx);
+        release(idx);
+        return true;
+    }
+
+    bool TimerWheel::pending(const TimerId id) const
+    {
+        const U32 idx = (U32)id;
+        if (idx >= _nodes.size())
+            return false;
+
+        const Node& node = _nodes[idx];
+        return node.active && node.generation == (U32)(id >> 32);
+    }
+
+    size_t TimerWheel::advance(const ExpiryCallback& callback)
+    {
+        return advance(Timer::monotonic(), callback);
+    }
+
+    size_t TimerWheel::advance(const U64 now, const ExpiryCallback& callback)
+    {
+        const U64 target = now > _start ? (now - _start) / _resolution : 0;
+
+        _expired.resizeFast(0);
+        while (expire(_budget) && _tick < target)
+        {
+            skip(target);
+            ++_tick;
+
+            if ((_tick & (RootSize - 1)) == 0)
+            {
+                U32 shift = RootBits;
+                for (U32 level = 1; level < Levels; ++level, shift += LevelBits)
+                {
+                    const U32 index = (U32)(_tick >> shift & (LevelSize - 1));
+                    cascade(level, index);
+                    if (index != 0)
+                        break;
+                }
+            }
+        }
+
+        const size_t count = _expired.size();
+        if (count > 0 && callback)
+            callback(_expired);
+        return count;
+    }
+
+    U32 TimerWheel::allocate()
+    {
+        U32 idx;
+        if (_free != Npos32)
+        {
+            idx   = _free;
+            _free = _nodes[idx].next;
+        }
+        else
+        {
+            idx = _nodes.size();
+            _nodes.push_back(Node{});
+        }
+
+        _nodes[idx].active = true;
+        return idx;
+    }
+
+    void TimerWheel::release(const U32 idx)
+    {
+        Node& node  = _nodes[idx];
+        node.active = false;
+        if (++node.generation == 0)
+            node.generation = 1;
+
+        node.prev = Npos32;
+        node.next = _free;
+        _free     = idx;
+        --_size;
+    }
+
+    void TimerWheel::link(const U32 idx)
+    {
+        Node& node = _nodes[idx];
+
+        U32 slot;
+        if (node.expires <= _tick)
+            slot = (U32)(_tick & (RootSize - 1));
+        else
+        {
+            U64 expires = node.expires;
+            U64 delta   = expires - _tick;
+            if (delta >= MaxTicks)
+            {
+                delta   = MaxTicks - 1;
+                expires = _tick + delta;
+            }
+
+            if (delta < RootSize)
+                slot = (U32)(expires & (RootSize - 1));
+            else
+            {
+                U32 level = 1, shift = RootBits;
+                while (level < Levels - 1 && delta >= U64(1) << (shift + LevelBits))
+                {
+                    ++level;
+                    shift += LevelBits;
+                }
+                slot = RootSize + (level - 1) * LevelSize + (U32)(expires >> shift & (LevelSize - 1));
+            }
+        }
+
+        node.slot = (U16)slot;
+        node.prev = Npos32;
+        node.next = _slots[slot];
+        if (node.next != Npos32)
+            _nodes[node.next].prev = idx;
+        _slots[slot] = idx;
+        ++_levelSize[levelOf(slot)];
+    }
+
+    void TimerWheel::unlink(const U32 idx)
+    {
+        Node& node = _nodes[idx];
+        if (node.prev != Npos32)
+            _nodes[node.prev].next = node.next;
+        else
+            _slots[node.slot] = node.next;
+
+        if (node.next != Npos32)
+            _nodes[node.next].prev = node.prev;
+
+        node.next = node.prev = Npos32;
+        --_levelSize[levelOf(node.slot)];
+    }
+
+    void TimerWheel::cascade(const U32 level, const U32 index)
+    {
+        const U32 slot = RootSize + (level - 1) * LevelSize + index;
+
+        U32 cur      = _slots[slot];
+        _slots[slot] = Npos32;
+
+        while (cur != Npos32)
+        {
+            const U32 next = _nodes[cur].next;
+            --_levelSize[level];
+            link(cur);
+            cur = next;
+        }
+    }
+
+    bool TimerWheel::expire(const U32 budget)
+    {
+        const U32 slot = (U32)(_tick & (RootSize - 1));
+
+        while (_slots[slot] != Npos32)
+        {
+            if (_expired.size() >= budget)
+                return false;
+
+            const U32 idx = _slots[slot];
+            unlink(idx);
+
+            const Node& node = _nodes[idx];
+            if (node.expires > _tick)
+            {
+                // Parked past the top level, it needs to go around again.
+                link(idx);
+                continue;
+            }
+
+            _expired.push_back({makeId(idx, node.generation), node.data});
+            release(idx);
+        }
+        return true;
+    }
+
+    void TimerWheel::skip(const U64 target)
+    {
+        // Jumps over ticks that can not expire or cascade anything.
+        // The caller still performs the final step onto the returned tick.
+        if (_size == 0)
+        {
+            _tick = target - 1;
+            return;
+        }
+
+        if (_levelSize[0] > 0)
+            return;
+
+        U32 shift = RootBits;
+        for (U32 level = 1; level < Levels; ++level, shift += LevelBits)
+        {
+            if (_levelSize[level] > 0)
+            {
+                const U64 last = _tick | ((U64(1) << shift) - 1);
+                _tick          = Min(last, target - 1);
+                return;
+            }
+        }
+    }
+
+}  // namespace Rt2
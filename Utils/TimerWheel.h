@@ -0,0 +1,209 @@
+/*
+-------------------------------------------------------------------------------
+    Copyright (c) Charles Carley.
+
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+-------------------------------------------------------------------------------
+*/
+#pragma once
+
+#include <functional>
+#include "Utils/Array.h"
+#include "Utils/Definitions.h"
+
+namespace Rt2
+{
+    // The low 32 bits index the timer's node, the high 32 bits
+    // hold the generation of the node when it was scheduled.
+    using TimerId = U64;
+
+    constexpr TimerId InvalidTimer = 0;
+
+    struct TimerEvent
+    {
+        TimerId id;
+        U64     data;
+    };
+
+    using TimerEvents    = SimpleArray<TimerEvent>;
+    using ExpiryCallback = std::function<void(const TimerEvents& expired)>;
+
+    /**
+     * \brief Hashed hierarchical timer wheel.
+     *
+     * Schedule and cancel are O(1). Timers are kept in intrusive lists
+     * threaded through a single node array, so there is no allocation per
+     * timer once the array has grown to the working set.
+     *
+     * The root level has 256 slots of one tick each; the three upper
+     * levels have 64 slots each and are cascaded down as the root wraps.
+     * Delays past the range of the top level are parked in its furthest
+     * slot and re-cascaded until they come into range.
+     */
+    class TimerWheel
+    {
+    public:
+        static constexpr U32 Levels    = 4;
+        static constexpr U32 RootBits  = 8;
+        static constexpr U32 LevelBits = 6;
+        static constexpr U32 RootSize  = 1 << RootBits;
+        static constexpr U32 LevelSize = 1 << LevelBits;
+        static constexpr U32 SlotCount = RootSize + (Levels - 1) * LevelSize;
+        static constexpr U64 MaxTicks  = U64(1) << (RootBits + (Levels - 1) * LevelBits);
+
+    private:
+        struct Node
+        {
+            U64  expires{0};
+            U64  data{0};
+            U32  next{Npos32};
+            U32  prev{Npos32};
+            U32  generation{1};
+            U16  slot{0};
+            bool active{false};
+        };
+
+        using Nodes = Array<Node, AOP_SIMPLE_TYPE>;
+        using Slots = SimpleArray<U32>;
+
+        Nodes       _nodes;
+        Slots       _slots;
+        TimerEvents _expired;
+        U32         _free{Npos32};
+        U32         _size{0};
+        U32         _levelSize[Levels]{};
+        U32         _budget{Npos32};
+        U64         _tick{0};
+        U64         _start{0};
+        U64         _resolution{1000};
+
+    public:
+        /**
+         * \param resolution The length of one tick in microseconds.
+         */
+        explicit TimerWheel(U64 resolution = 1000);
+
+        ~TimerWheel() = default;
+
+        TimerWheel(const TimerWheel&) = delete;
+
+        /**
+         * \brief Drops every pending timer and rebases the wheel
+         * so that tick zero starts at now.
+         * \param now The current time in microseconds.
+         */
+        void reset(U64 now);
+
+        /**
+         * \brief Starts a timer that expires delay microseconds after the
+         * current tick. The delay is rounded up to a whole number of ticks.
+         * \param delay The delay in microseconds.
+         * \param data User data that is passed back when the timer expires.
+         * \return A handle that can be passed to cancel.
+         */
+        TimerId schedule(U64 delay, U64 data = 0);
+
+        /**
+         * \return True if the timer was pending, false if it had
+         * already expired, been canceled or the id is stale.
+         */
+        bool cancel(TimerId id);
+
+        bool pending(TimerId id) const;
+
+        /**
+         * \brief Advances the wheel to the current value of Timer::monotonic.
+         */
+        size_t advance(const ExpiryCallback& callback);
+
+        /**
+         * \brief Advances the wheel up to now and reports expired timers
+         * in a single batch.
+         *
+         * When a budget is set, at most that many timers are reported per
+         * call and the rest are reported by the following calls.
+         * The callback may schedule or cancel timers, but must not call advance.
+         *
+         * \param now The current time in microseconds.
+         * \param callback Receives the batch of expired timers.
+         * \return The number of timers that expired.
+         */
+        size_t advance(U64 now, const ExpiryCallback& callback);
+
+        /**
+         * \brief Limits the number of timers reported by one call to advance.
+         * Npos32 (the default) removes the limit.
+         */
+        void setBudget(U32 maxExpired);
+
+        void setResolution(U64 resolution);
+
+        U64 resolution() const;
+
+        U64 tick() const;
+
+        U32 size() const;
+
+        bool empty() const;
+
+    private:
+        U32 allocate();
+
+        void release(U32 idx);
+
+        void link(U32 idx);
+
+        void unlink(U32 idx);
+
+        void cascade(U32 level, U32 index);
+
+        bool expire(U32 budget);
+
+        void skip(U64 target);
+    };
+
+    inline void TimerWheel::setBudget(const U32 maxExpired)
+    {
+        _budget = Max<U32>(maxExpired, 1);
+    }
+
+    inline void TimerWheel::setResolution(const U64 resolution)
+    {
+        _resolution = Max<U64>(resolution, 1);
+    }
+
+    inline U64 TimerWheel::resolution() const
+    {
+        return _resolution;
+    }
+
+    inline U64 TimerWheel::tick() const
+    {
+        return _tick;
+    }
+
+    inline U32 TimerWheel::size() const
+    {
+        return _size;
+    }
+
+    inline bool TimerWheel::empty() const
+    {
+        return _size == 0;
+    }
+
+}  // namespace Rt2